@@ -0,0 +1,38 @@
+# =====================================================================
+# EMBED SHADER KE DALAM EXECUTABLE
+# =====================================================================
+# Dijalankan saat build (cmake -P) oleh CMakeLists.txt:
+#   -DSHADER_DIR=<folder shaders>  -DOUTPUT=<header hasil>
+# Setiap file .glsl di SHADER_DIR (termasuk subfolder) menjadi satu entri
+# std::string_view constexpr dengan path "shaders/<relatif>". Source
+# dipecah per potongan agar tidak melewati batas panjang literal MSVC.
+# =====================================================================
+
+file(GLOB_RECURSE SHADER_FILES RELATIVE "${SHADER_DIR}" "${SHADER_DIR}/*.glsl")
+list(SORT SHADER_FILES)
+
+set(CHUNK_SIZE 8000)
+set(CONTENT "// Dibuat otomatis oleh cmake/EmbedShaders.cmake - jangan diedit\n")
+string(APPEND CONTENT "#pragma once\n\n#include <string_view>\n\n")
+string(APPEND CONTENT "struct EmbeddedShader {\n    std::string_view path;\n    std::string_view source;\n};\n\n")
+string(APPEND CONTENT "inline constexpr EmbeddedShader EMBEDDED_SHADERS[] = {\n")
+
+foreach(SHADER ${SHADER_FILES})
+    file(READ "${SHADER_DIR}/${SHADER}" SOURCE)
+    string(LENGTH "${SOURCE}" LENGTH)
+    string(APPEND CONTENT "    {\"shaders/${SHADER}\",\n")
+    set(OFFSET 0)
+    while(OFFSET LESS LENGTH)
+        string(SUBSTRING "${SOURCE}" ${OFFSET} ${CHUNK_SIZE} CHUNK)
+        string(APPEND CONTENT "     R\"glsl_embed(${CHUNK})glsl_embed\"\n")
+        math(EXPR OFFSET "${OFFSET} + ${CHUNK_SIZE}")
+    endwhile()
+    if(LENGTH EQUAL 0)
+        string(APPEND CONTENT "     \"\"\n")
+    endif()
+    string(APPEND CONTENT "    },\n")
+endforeach()
+
+string(APPEND CONTENT "};\n")
+
+file(WRITE "${OUTPUT}" "${CONTENT}")
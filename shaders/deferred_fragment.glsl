@@ -0,0 +1,33 @@
+#version 330 core
+
+in vec2 TexCoord;
+
+out vec4 FragColor;
+
+// G-buffer dari pass geometri
+uniform sampler2D gAlbedo;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+uniform sampler2D gBaked;
+uniform mat4 invViewProjection;
+
+// Pencahayaan yang sama dengan fragment_shader.glsl
+#include "include/phong.glsl"
+
+void main()
+{
+    // Pixel latar (tidak ada geometri) dibiarkan warna clear
+    float depth = texture(gDepth, TexCoord).r;
+    if (depth >= 1.0) discard;
+    
+    // Atribut fragment direkonstruksi dari G-buffer
+    vec4 clip = vec4(TexCoord * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = invViewProjection * clip;
+    vec3 fragPos = world.xyz / world.w;
+    vec4 normalOcclusion = texture(gNormal, TexCoord);
+    vec3 objectColor = texture(gAlbedo, TexCoord).rgb;
+    vec4 bakedLight = texture(gBaked, TexCoord);
+    gl_FragDepth = depth;
+    
+    FragColor = vec4(shadeFragment(fragPos, normalOcclusion.xyz, objectColor, bakedLight, normalOcclusion.w), 1.0);
+}
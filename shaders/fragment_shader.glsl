@@ -3,42 +3,18 @@
 in vec3 FragPos;
 in vec3 Normal;
 in vec3 ObjectColor;
+in vec4 BakedLight;
+in float Occlusion;
+flat in int Material;
+in vec2 MaterialCoord;
 
 out vec4 FragColor;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-
-// Ambient light intensity
-uniform float ambientStrength;
-// Diffuse light intensity
-uniform float diffuseStrength;
-// Specular light intensity
-uniform float specularStrength;
-// Shininess factor
-uniform float shininess;
+#include "include/phong.glsl"
+#include "include/materials.glsl"
 
 void main()
 {
-    // === PHONG LIGHTING MODEL ===
-    
-    // 1. Ambient Lighting (pencahayaan dasar)
-    vec3 ambient = ambientStrength * lightColor;
-    
-    // 2. Diffuse Lighting (pencahayaan berdasarkan sudut permukaan)
-    vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = diffuseStrength * diff * lightColor;
-    
-    // 3. Specular Lighting (pantulan cahaya)
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
-    vec3 specular = specularStrength * spec * lightColor;
-    
-    // Gabungkan semua komponen pencahayaan
-    vec3 result = (ambient + diffuse + specular) * ObjectColor;
-    FragColor = vec4(result, 1.0);
+    vec3 albedo = materialAlbedo(ObjectColor, Material, MaterialCoord);
+    FragColor = vec4(shadeFragment(FragPos, Normal, albedo, BakedLight, Occlusion), 1.0);
 }
@@ -0,0 +1,24 @@
+#version 330 core
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec3 ObjectColor;
+in vec4 BakedLight;
+in float Occlusion;
+flat in int Material;
+in vec2 MaterialCoord;
+
+// G-buffer: albedo, normal world space (+ AO di w), dan cahaya baked
+// (depth dari depth attachment)
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec4 gNormal;
+layout (location = 2) out vec4 gBaked;
+
+#include "include/materials.glsl"
+
+void main()
+{
+    gAlbedo = vec4(materialAlbedo(ObjectColor, Material, MaterialCoord), 1.0);
+    gNormal = vec4(normalize(Normal), Occlusion);
+    gBaked = BakedLight;
+}
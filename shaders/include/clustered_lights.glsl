@@ -0,0 +1,47 @@
+// Clustered shading: lampu titik lokal
+#include "lighting_common.glsl"
+
+uniform samplerBuffer lightData;      // 2 texel per lampu: (posisi, radius), (warna)
+uniform usamplerBuffer clusterGrid;   // per cluster: (offset, jumlah)
+uniform usamplerBuffer lightIndices;  // daftar indeks lampu per cluster
+uniform vec2 screenSize;
+uniform float clusterNear;
+uniform float clusterLogScale;
+uniform mat4 view;
+
+// Ukuran grid dan batas lampu per cluster disisipkan dari C++ (LightClusters)
+const ivec3 clusterDims = CLUSTER_GRID;
+
+#ifdef CLUSTERED_LIGHTS
+// Jumlah diffuse + specular dari lampu di cluster fragment ini saja
+vec3 clusteredLights(vec3 fragPos, vec3 norm, vec3 viewDir)
+{
+    float depth = -(view * vec4(fragPos, 1.0)).z;
+    int slice = clamp(int(log(depth / clusterNear) * clusterLogScale), 0, clusterDims.z - 1);
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / screenSize * vec2(clusterDims.xy)),
+                       ivec2(0), clusterDims.xy - 1);
+    int cluster = tile.x + clusterDims.x * (tile.y + clusterDims.y * slice);
+    uvec2 range = texelFetch(clusterGrid, cluster).xy;
+    
+    vec3 total = vec3(0.0);
+    uint count = min(range.y, uint(MAX_LIGHTS_PER_CLUSTER));
+    for (uint i = 0u; i < count; i++) {
+        int light = int(texelFetch(lightIndices, int(range.x + i)).r);
+        vec4 positionRadius = texelFetch(lightData, light * 2);
+        vec3 color = texelFetch(lightData, light * 2 + 1).rgb;
+        
+        vec3 toLight = positionRadius.xyz - fragPos;
+        float dist = length(toLight);
+        // Redaman halus yang mencapai nol tepat di radius lampu
+        float falloff = clamp(1.0 - (dist * dist) / (positionRadius.w * positionRadius.w), 0.0, 1.0);
+        falloff *= falloff;
+        vec3 dir = toLight / max(dist, 0.0001);
+        float amount = max(dot(norm, dir), 0.0);
+#ifdef SPECULAR
+        amount += specularStrength * pow(max(dot(viewDir, reflect(-dir, norm)), 0.0), shininess);
+#endif
+        total += falloff * amount * color;
+    }
+    return total;
+}
+#endif
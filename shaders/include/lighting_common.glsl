@@ -0,0 +1,13 @@
+// Uniform lampu utama dan material Phong (bersama semua shader pencahayaan)
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+uniform vec3 lightColor;
+
+// Ambient light intensity
+uniform float ambientStrength;
+// Diffuse light intensity
+uniform float diffuseStrength;
+// Specular light intensity
+uniform float specularStrength;
+// Shininess factor
+uniform float shininess;
@@ -0,0 +1,12 @@
+// Detail albedo dari texture array material (satu layer per material,
+// dibind sekali per frame). Material 0 = warna vertex apa adanya.
+uniform sampler2DArray materialTextures;
+
+// Layer dinormalisasi ke rata-rata 128/255 sehingga kecerahan rata-rata
+// permukaan tetap sama dengan warna vertex
+vec3 materialAlbedo(vec3 color, int material, vec2 uv)
+{
+    if (material <= 0) return color;
+    vec3 detail = texture(materialTextures, vec3(uv, float(material - 1))).rgb;
+    return color * detail * (255.0 / 128.0);
+}
@@ -0,0 +1,68 @@
+// Model pencahayaan Phong bersama untuk jalur forward dan deferred.
+// Fitur varian (disisipkan loadShader sebagai #define): SPECULAR, SHADOWS,
+// CLUSTERED_LIGHTS, BAKED_LIGHTING, FOG
+#include "lighting_common.glsl"
+#include "shadows.glsl"
+#include "clustered_lights.glsl"
+
+#ifdef FOG
+uniform vec3 fogColor;
+uniform float fogDensity;
+#endif
+
+// Warna akhir satu fragment dari atribut permukaannya
+vec3 shadeFragment(vec3 fragPos, vec3 normal, vec3 objectColor, vec4 bakedLight, float occlusion)
+{
+    vec3 norm = normalize(normal);
+    vec3 viewDir = normalize(viewPos - fragPos);
+    vec3 result;
+    
+#ifdef BAKED_LIGHTING
+    if (bakedLight.w > 0.5) {
+        // Objek statis: ambient, direct, dan indirect sudah di-bake per vertex
+        result = bakedLight.rgb * objectColor;
+    } else
+#endif
+    {
+        // === PHONG LIGHTING MODEL ===
+        
+        // 1. Ambient Lighting (pencahayaan dasar, diredam AO baked)
+        vec3 ambient = ambientStrength * occlusion * lightColor;
+        
+        // 2. Diffuse Lighting (pencahayaan berdasarkan sudut permukaan)
+        vec3 lightDir = normalize(lightPos - fragPos);
+        float diff = max(dot(norm, lightDir), 0.0);
+        vec3 diffuse = diffuseStrength * diff * lightColor;
+        
+        // 3. Specular Lighting (pantulan cahaya)
+#ifdef SPECULAR
+        vec3 reflectDir = reflect(-lightDir, norm);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+        vec3 specular = specularStrength * spec * lightColor;
+#else
+        vec3 specular = vec3(0.0);
+#endif
+        
+        // 4. Shadow (hanya menghalangi diffuse dan specular)
+#ifdef SHADOWS
+        float shadow = shadowFactor(fragPos, norm);
+#else
+        float shadow = 1.0;
+#endif
+        
+        // Gabungkan semua komponen pencahayaan
+        result = (ambient + shadow * (diffuse + specular)) * objectColor;
+    }
+    
+    // 5. Lampu lokal (clustered)
+#ifdef CLUSTERED_LIGHTS
+    result += clusteredLights(fragPos, norm, viewDir) * objectColor;
+#endif
+    
+    // 6. Kabut berdasarkan jarak ke kamera
+#ifdef FOG
+    float fog = exp(-fogDensity * length(viewPos - fragPos));
+    result = mix(fogColor, result, fog);
+#endif
+    return result;
+}
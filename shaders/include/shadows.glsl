@@ -0,0 +1,20 @@
+// Bayangan lampu utama dari cube shadow map
+#include "lighting_common.glsl"
+
+#ifdef SHADOWS
+// Shadow map cube (statis di-cache + layer dinamis kecil)
+uniform samplerCubeShadow shadowStatic;
+uniform samplerCubeShadow shadowDynamic;
+uniform float farPlane;
+
+// Faktor terang (1 = tidak terhalang, 0 = dalam bayangan)
+float shadowFactor(vec3 fragPos, vec3 norm)
+{
+    // Normal offset + bias jarak untuk mencegah shadow acne
+    vec3 fragToLight = (fragPos + norm * 0.02) - lightPos;
+    float reference = (length(fragToLight) - 0.02) / farPlane;
+    float litStatic = texture(shadowStatic, vec4(fragToLight, reference));
+    float litDynamic = texture(shadowDynamic, vec4(fragToLight, reference));
+    return min(litStatic, litDynamic);
+}
+#endif
@@ -0,0 +1,49 @@
+// Bloom: ambil bagian terang (setengah resolusi), blur Gaussian terpisah
+// horizontal/vertikal, lalu tambahkan ke citra HDR
+
+const float BLOOM_THRESHOLD = 1.0;
+const float BLOOM_KNEE = 0.2;
+const float BLOOM_STRENGTH = 0.35;
+
+// Downsample 2x2 (satu tap bilinear per kuadran) + threshold lembut
+vec4 bloomBright(sampler2D source)
+{
+    vec2 texel = 1.0 / vec2(textureSize(source, 0));
+    vec3 color = 0.25 * (texture(source, TexCoord + texel * vec2(-0.5, -0.5)).rgb +
+                         texture(source, TexCoord + texel * vec2( 0.5, -0.5)).rgb +
+                         texture(source, TexCoord + texel * vec2(-0.5,  0.5)).rgb +
+                         texture(source, TexCoord + texel * vec2( 0.5,  0.5)).rgb);
+    float brightness = max(color.r, max(color.g, color.b));
+    float soft = clamp(brightness - BLOOM_THRESHOLD + BLOOM_KNEE, 0.0, 2.0 * BLOOM_KNEE);
+    soft = soft * soft / (4.0 * BLOOM_KNEE + 0.0001);
+    float contribution = max(soft, brightness - BLOOM_THRESHOLD) / max(brightness, 0.0001);
+    return vec4(color * contribution, 1.0);
+}
+
+// Gaussian 9 tap dengan 5 sampel bilinear
+vec4 bloomBlur(sampler2D source, vec2 direction)
+{
+    vec2 offset = direction / vec2(textureSize(source, 0));
+    vec3 sum = texture(source, TexCoord).rgb * 0.2270270270;
+    sum += texture(source, TexCoord + offset * 1.3846153846).rgb * 0.3162162162;
+    sum += texture(source, TexCoord - offset * 1.3846153846).rgb * 0.3162162162;
+    sum += texture(source, TexCoord + offset * 3.2307692308).rgb * 0.0702702703;
+    sum += texture(source, TexCoord - offset * 3.2307692308).rgb * 0.0702702703;
+    return vec4(sum, 1.0);
+}
+
+vec4 bloomBlurHorizontal(sampler2D source)
+{
+    return bloomBlur(source, vec2(1.0, 0.0));
+}
+
+vec4 bloomBlurVertical(sampler2D source)
+{
+    return bloomBlur(source, vec2(0.0, 1.0));
+}
+
+// Pointwise: hanya membaca pixel yang sama dari citra utama
+vec4 bloomComposite(vec4 color, sampler2D bloom)
+{
+    return vec4(color.rgb + BLOOM_STRENGTH * texture(bloom, TexCoord).rgb, color.a);
+}
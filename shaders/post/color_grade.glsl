@@ -0,0 +1,14 @@
+// Color grading ringan: saturasi, kontras, dan vignette
+
+const float SATURATION = 1.05;
+const float CONTRAST = 1.04;
+const float VIGNETTE = 0.25;
+
+vec4 colorGrade(vec4 color)
+{
+    vec3 graded = mix(vec3(dot(color.rgb, vec3(0.2126, 0.7152, 0.0722))), color.rgb, SATURATION);
+    graded = (graded - 0.5) * CONTRAST + 0.5;
+    vec2 centered = TexCoord - 0.5;
+    graded *= 1.0 - VIGNETTE * dot(centered, centered) * 2.0;
+    return vec4(clamp(graded, 0.0, 1.0), color.a);
+}
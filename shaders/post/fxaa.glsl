@@ -0,0 +1,37 @@
+// FXAA: blur sepanjang arah tepi yang terdeteksi dari gradien luma
+
+const float FXAA_REDUCE_MIN = 1.0 / 128.0;
+const float FXAA_REDUCE_MUL = 1.0 / 8.0;
+const float FXAA_SPAN_MAX = 8.0;
+
+float fxaaLuma(vec3 color)
+{
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+vec4 fxaa(sampler2D source)
+{
+    vec2 texel = 1.0 / vec2(textureSize(source, 0));
+    float lumaNW = fxaaLuma(texture(source, TexCoord + vec2(-1.0, -1.0) * texel).rgb);
+    float lumaNE = fxaaLuma(texture(source, TexCoord + vec2( 1.0, -1.0) * texel).rgb);
+    float lumaSW = fxaaLuma(texture(source, TexCoord + vec2(-1.0,  1.0) * texel).rgb);
+    float lumaSE = fxaaLuma(texture(source, TexCoord + vec2( 1.0,  1.0) * texel).rgb);
+    vec4 center = texture(source, TexCoord);
+    float lumaM = fxaaLuma(center.rgb);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+    
+    vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)),
+                     ((lumaNW + lumaSW) - (lumaNE + lumaSE)));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * texel;
+    
+    vec3 rgbA = 0.5 * (texture(source, TexCoord + dir * (1.0 / 3.0 - 0.5)).rgb +
+                       texture(source, TexCoord + dir * (2.0 / 3.0 - 0.5)).rgb);
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (texture(source, TexCoord - dir * 0.5).rgb +
+                                     texture(source, TexCoord + dir * 0.5).rgb);
+    float lumaB = fxaaLuma(rgbB);
+    if (lumaB < lumaMin || lumaB > lumaMax) return vec4(rgbA, center.a);
+    return vec4(rgbB, center.a);
+}
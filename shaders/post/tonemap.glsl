@@ -0,0 +1,10 @@
+// Tone mapping HDR -> LDR (kurva ACES, pendekatan Narkowicz)
+
+const float EXPOSURE = 1.1;
+
+vec4 tonemap(vec4 color)
+{
+    vec3 x = color.rgb * EXPOSURE;
+    vec3 mapped = clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+    return vec4(mapped, color.a);
+}
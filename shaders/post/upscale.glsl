@@ -0,0 +1,29 @@
+// Upscale ke resolusi layar: Catmull-Rom bikubik dengan 5 sampel bilinear
+// (sudut 4x4 diabaikan karena bobotnya sangat kecil)
+
+vec4 upscale(sampler2D source)
+{
+    vec2 size = vec2(textureSize(source, 0));
+    vec2 samplePos = TexCoord * size;
+    vec2 texPos1 = floor(samplePos - 0.5) + 0.5;
+    vec2 f = samplePos - texPos1;
+    
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+    
+    // Dua tap tengah digabung menjadi satu sampel bilinear
+    vec2 w12 = w1 + w2;
+    vec2 pos0 = (texPos1 - 1.0) / size;
+    vec2 pos3 = (texPos1 + 2.0) / size;
+    vec2 pos12 = (texPos1 + w2 / w12) / size;
+    
+    vec3 sum = texture(source, vec2(pos12.x, pos0.y)).rgb * (w12.x * w0.y);
+    sum += texture(source, vec2(pos0.x, pos12.y)).rgb * (w0.x * w12.y);
+    sum += texture(source, pos12).rgb * (w12.x * w12.y);
+    sum += texture(source, vec2(pos3.x, pos12.y)).rgb * (w3.x * w12.y);
+    sum += texture(source, vec2(pos12.x, pos3.y)).rgb * (w12.x * w3.y);
+    float weight = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+    return vec4(clamp(sum / weight, 0.0, 1.0), 1.0);
+}
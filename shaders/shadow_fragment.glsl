@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec4 FragPos;
+
+uniform vec3 lightPos;
+uniform float farPlane;
+
+void main()
+{
+    // Simpan jarak linear ke lampu (dinormalisasi ke 0..1) sebagai depth
+    float lightDistance = length(FragPos.xyz - lightPos);
+    gl_FragDepth = lightDistance / farPlane;
+}
@@ -0,0 +1,23 @@
+#version 330 core
+
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 18) out;
+
+// Matriks projection * view untuk 6 sisi cube map
+uniform mat4 shadowMatrices[6];
+
+out vec4 FragPos;
+
+void main()
+{
+    // Satu pass: setiap segitiga dikirim ke keenam sisi cube map
+    for (int face = 0; face < 6; ++face) {
+        gl_Layer = face;
+        for (int i = 0; i < 3; ++i) {
+            FragPos = gl_in[i].gl_Position;
+            gl_Position = shadowMatrices[face] * FragPos;
+            EmitVertex();
+        }
+        EndPrimitive();
+    }
+}
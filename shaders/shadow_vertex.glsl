@@ -0,0 +1,11 @@
+#version 330 core
+
+layout (location = 0) in vec3 aPos;
+
+uniform mat4 model;
+
+void main()
+{
+    // Hanya transformasi ke world space, proyeksi per sisi cube di geometry shader
+    gl_Position = model * vec4(aPos, 1.0);
+}
@@ -3,14 +3,22 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aColor;
+layout (location = 3) in vec4 aBaked;   // Cahaya baked (w = 0: tidak ada)
+layout (location = 4) in float aOcclusion;  // Ambient occlusion baked
+layout (location = 5) in int aMaterial;     // Layer texture array material (0 = tidak ada)
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec3 ObjectColor;
+out vec4 BakedLight;
+out float Occlusion;
+flat out int Material;
+out vec2 MaterialCoord;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
+uniform float materialTiling[MAX_MATERIALS];  // Ulangan tekstur per meter (MAX_MATERIALS dari C++)
 
 void main()
 {
@@ -22,6 +30,15 @@ void main()
     
     // Pass warna objek ke fragment shader
     ObjectColor = aColor;
+    BakedLight = aBaked;
+    Occlusion = aOcclusion;
+    
+    // Box mapping di ruang lokal: proyeksi ke bidang yang paling tegak
+    // lurus dengan normal (mesh tidak menyimpan UV)
+    vec3 n = abs(aNormal);
+    vec2 uv = (n.x > n.y && n.x > n.z) ? aPos.zy : (n.y > n.z ? aPos.xz : aPos.xy);
+    Material = aMaterial;
+    MaterialCoord = uv * materialTiling[clamp(aMaterial, 0, MAX_MATERIALS - 1)];
     
     // Hitung posisi akhir vertex
     gl_Position = projection * view * model * vec4(aPos, 1.0);
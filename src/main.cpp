@@ -9,9 +9,12 @@
  * - Model ruangan 3D lengkap (lantai, dinding, pintu, jendela)
  * - Perabot: meja, kursi, lemari, lampu, komputer
  * - Pencahayaan Phong (ambient, diffuse, specular)
+ * - Bayangan lampu titik (cube shadow map statis + dinamis)
+ * - Clustered forward shading untuk ratusan lampu titik lokal
  * - Transformasi geometris (translasi, rotasi, skala)
  * - Kontrol kamera bebas (WASD + Mouse)
  * - Multiple view angles
+ * - Kolisi kamera (capsule) terhadap dinding dan perabot
  * 
  * Kontrol:
  * - WASD      : Gerak kamera
@@ -19,6 +22,9 @@
  * - Scroll    : Zoom in/out
  * - 1-4       : Preset sudut pandang
  * - L         : Toggle lampu on/off
+ * - C         : Toggle kolisi kamera (walkthrough / terbang bebas)
+ * - F         : Toggle kabut
+ * - Klik kiri : Pilih objek (ray-cast picking)
  * - ESC       : Keluar program
  * 
  * =====================================================================
@@ -29,13 +35,61 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <charconv>
 #include <string>
 #include <vector>
 #include <cmath>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <filesystem>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <set>
+#include <cctype>
+#include <future>
+#include <chrono>
+#include <string_view>
+#include <utility>
+#include <cassert>
+#include <limits>
+
+// Memory-mapped file untuk folder override shader
+#ifdef _WIN32
+#undef APIENTRY
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Shader yang di-embed saat build (dibuat cmake/EmbedShaders.cmake)
+#ifdef ROOM_EMBEDDED_SHADERS
+#include "embedded_shaders.h"
+#endif
+
+// SSE untuk uji ray/box paket 4 ray (bake ambient occlusion)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROOM_SIMD_SSE 1
+#endif
 
 // =====================================================================
 // KONFIGURASI WINDOW
@@ -64,6 +118,14 @@ float lastY = SCR_HEIGHT / 2.0f;
 float deltaTime = 0.0f;
 float lastFrame = 0.0f;
 
+// Detik sejak pemanggilan pertama (steady clock). Dipakai untuk semua
+// pengukuran, termasuk benchmark command line yang berjalan sebelum
+// glfwInit (glfwGetTime selalu 0 sebelum GLFW diinisialisasi).
+double monotonicTime() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 // =====================================================================
 // VARIABEL PENCAHAYAAN
 // =====================================================================
@@ -75,42 +137,280 @@ bool lightOn = true;
 // FUNGSI DEKLARASI
 // =====================================================================
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+float framebufferAspect(GLFWwindow* window);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 void processInput(GLFWwindow* window);
-unsigned int loadShader(const char* vertexPath, const char* fragmentPath);
-std::string readShaderFile(const char* filePath);
+unsigned int loadShader(const char* vertexPath, const char* fragmentPath,
+                        const char* geometryPath = nullptr, const std::string& defines = "");
+unsigned int submitShader(const char* vertexPath, const char* fragmentPath,
+                          const char* geometryPath = nullptr, const std::string& defines = "");
+unsigned int createProgram(std::string_view vertexCode, std::string_view fragmentCode,
+                           std::string_view geometryCode = {});
+std::string_view readShaderFile(const char* filePath);
+std::string shaderConstants();
 
 // =====================================================================
 // STRUKTUR DATA VERTEX
 // =====================================================================
+// Material permukaan: layer detail di texture array (lihat MaterialLibrary)
+// yang dikalikan ke warna vertex. MATERIAL_NONE = warna vertex saja.
+enum MaterialId : int32_t {
+    MATERIAL_NONE = 0,
+    MATERIAL_WOOD,
+    MATERIAL_FABRIC,
+    MATERIAL_TILE,
+    MATERIAL_PLASTER,
+    MATERIAL_METAL,
+    MATERIAL_COUNT
+};
+
+// Ukuran array materialTiling di shader (disisipkan lewat shaderConstants)
+const int MAX_MATERIALS = 8;
+static_assert(MATERIAL_COUNT <= MAX_MATERIALS, "Material melebihi MAX_MATERIALS shader");
+
 struct Vertex {
     glm::vec3 position;
     glm::vec3 normal;
     glm::vec3 color;
+    float ao = 1.0f;    // Ambient occlusion baked (1 = terbuka)
+    int32_t material = MATERIAL_NONE;
+};
+
+// =====================================================================
+// STRUKTUR DATA BOUNDING BOX (AABB)
+// =====================================================================
+struct AABB {
+    glm::vec3 min;
+    glm::vec3 max;
+    
+    AABB() : min(1e30f), max(-1e30f) {}
+    AABB(glm::vec3 mn, glm::vec3 mx) : min(mn), max(mx) {}
+    
+    void expand(glm::vec3 p) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    
+    bool overlaps(const AABB& o) const {
+        return min.x <= o.max.x && max.x >= o.min.x &&
+               min.y <= o.max.y && max.y >= o.min.y &&
+               min.z <= o.max.z && max.z >= o.min.z;
+    }
+    
+    // Bounding box baru setelah ditransformasi matriks (8 sudut)
+    AABB transformed(const glm::mat4& m) const {
+        AABB result;
+        for (int i = 0; i < 8; i++) {
+            glm::vec3 corner((i & 1) ? max.x : min.x,
+                             (i & 2) ? max.y : min.y,
+                             (i & 4) ? max.z : min.z);
+            result.expand(glm::vec3(m * glm::vec4(corner, 1.0f)));
+        }
+        return result;
+    }
+};
+
+// =====================================================================
+// RENTANG GAMBAR (DRAW RANGE) DALAM SATU MESH
+// =====================================================================
+struct DrawRange {
+    int first;      // Indeks vertex pertama
+    int count;      // Jumlah vertex
+    bool twoSided;  // true: digambar tanpa back-face culling
+    int detailPart; // -1: geometri utama, >= 0: indeks Object3D::detailParts
+};
+
+// =====================================================================
+// LAYER DETAIL (FITUR KECIL YANG BOLEH DILEWATI)
+// =====================================================================
+// Sub-bagian kecil (tombol keyboard, handle, halaman buku) dicatat oleh
+// builder. Saat render, bagian ini dilewati jika ukuran proyeksinya di
+// layar lebih kecil dari ambang pixel.
+struct DetailPart {
+    int authorFirst;        // Rentang vertex bagian (dipetakan ulang saat validasi/subdivisi)
+    int authorCount;
+    glm::vec3 center;       // Bounding sphere seluruh bagian (ruang lokal)
+    float radius;
+    float featureRadius;    // Radius satu elemen terbesar (misal satu tombol)
+};
+
+// =====================================================================
+// RENTANG BYTE KOTOR PER BUFFER GPU (EDIT INKREMENTAL)
+// =====================================================================
+// Setiap edit mencatat rentang [begin, end) byte yang berubah. Sebelum
+// dikirim, rentang diurutkan dan digabung: yang bertumpuk atau hanya
+// dipisah celah kecil menjadi satu panggilan (mengirim beberapa byte yang
+// tidak berubah lebih murah daripada satu panggilan GL lagi).
+struct DirtyRanges {
+    static constexpr size_t MERGE_GAP = 256;   // Byte
+    
+    std::vector<std::pair<size_t, size_t>> ranges;
+    
+    void mark(size_t begin, size_t end) {
+        if (end > begin) ranges.push_back({begin, end});
+    }
+    
+    bool empty() const { return ranges.empty(); }
+    void clear() { ranges.clear(); }
+    
+    // Urutkan, gabungkan, dan potong ke ukuran buffer saat ini
+    void coalesce(size_t limit) {
+        std::sort(ranges.begin(), ranges.end());
+        size_t out = 0;
+        for (const auto& r : ranges) {
+            size_t begin = r.first, end = std::min(r.second, limit);
+            if (begin >= end) continue;
+            if (out > 0 && begin <= ranges[out - 1].second + MERGE_GAP) {
+                ranges[out - 1].second = std::max(ranges[out - 1].second, end);
+            } else {
+                ranges[out++] = {begin, end};
+            }
+        }
+        ranges.resize(out);
+    }
+    
+    size_t bytes() const {
+        size_t total = 0;
+        for (const auto& r : ranges) total += r.second - r.first;
+        return total;
+    }
+};
+
+// =====================================================================
+// VERTEX MESH BERSAMA (COPY-ON-WRITE)
+// =====================================================================
+// Instance dari prototype yang sama berbagi satu blok vertex; mesh dari
+// cache mesh bahkan hanya menunjuk halaman mmap (tidak ada salinan sama
+// sekali). Semua akses baca const dan tidak pernah menyalin. Tulis harus
+// eksplisit lewat edit() (atau push_back/resize/swap), yang lebih dulu
+// membuat blok milik sendiri jika blok dipakai bersama, sehingga instance
+// lain tidak ikut berubah.
+
+// Rentang vertex read-only di halaman mmap cache mesh. Dimiliki MeshCache,
+// yang menggeser pointer-nya saat file cache diganti dan di-map ulang,
+// sehingga semua MeshVertices yang menunjuknya ikut pindah.
+struct MappedVertices {
+    const Vertex* data = nullptr;
+    size_t count = 0;
+};
+
+class MeshVertices {
+public:
+    MeshVertices() = default;
+    MeshVertices(const MeshVertices& other) = default;
+    MeshVertices(MeshVertices&& other) noexcept { *this = std::move(other); }
+    MeshVertices& operator=(const MeshVertices& other) = default;
+    
+    MeshVertices& operator=(MeshVertices&& other) noexcept {
+        block = std::move(other.block);
+        mapped = std::move(other.mapped);
+        other.clear();
+        return *this;
+    }
+    
+    // Tunjuk vertex read-only di luar objek (halaman mmap cache mesh)
+    void reference(std::shared_ptr<const MappedVertices> span) {
+        clear();
+        mapped = std::move(span);
+    }
+    
+    // Vertex tidak dimiliki sendiri (instance prototype atau halaman mmap)
+    bool isShared() const { return !empty() && !(block && block.use_count() == 1); }
+    
+    size_t size() const { return block ? block->size() : mapped ? mapped->count : 0; }
+    bool empty() const { return size() == 0; }
+    const Vertex* data() const { return block ? block->data() : mapped ? mapped->data : nullptr; }
+    const Vertex* begin() const { return data(); }
+    const Vertex* end() const { return data() + size(); }
+    const Vertex& operator[](size_t i) const { return data()[i]; }
+    
+    // Blok milik sendiri untuk ditulis (disalin dulu jika dipakai bersama).
+    // Referensinya berlaku sampai MeshVertices ini disalin atau diganti.
+    std::vector<Vertex>& edit() {
+        if (!block) {
+            copiedBytes() += size() * sizeof(Vertex);
+            block = std::make_shared<std::vector<Vertex>>(begin(), end());
+            mapped.reset();
+        } else if (block.use_count() > 1) {
+            copiedBytes() += block->size() * sizeof(Vertex);
+            block = std::make_shared<std::vector<Vertex>>(*block);
+        }
+        return *block;
+    }
+    void push_back(const Vertex& v) { edit().push_back(v); }
+    void resize(size_t count) { edit().resize(count); }
+    void swap(std::vector<Vertex>& other) { edit().swap(other); }
+    
+    // Lepas vertex (objek dihapus): blok dibebaskan jika tidak dipakai lagi
+    void clear() {
+        block.reset();
+        mapped.reset();
+    }
+    
+    // Total byte vertex yang disalin karena tulis ke vertex bersama
+    static std::atomic<size_t>& copiedBytes() {
+        static std::atomic<size_t> bytes{0};
+        return bytes;
+    }
+    
+private:
+    std::shared_ptr<std::vector<Vertex>> block;   // Kosong jika menunjuk mmap
+    std::shared_ptr<const MappedVertices> mapped;
+};
+
+// =====================================================================
+// MODE KOLISI OBJEK
+// =====================================================================
+enum ColliderMode {
+    COLLIDE_NONE,
+    COLLIDE_BOX,        // Pakai bounding box objek (perabot)
+    COLLIDE_TRIANGLES   // Pakai segitiga mesh (dinding, lantai)
 };
 
 // =====================================================================
 // KELAS UNTUK MEMBUAT OBJEK 3D
 // =====================================================================
+class MeshBVH;  // Lihat bagian BVH SEGITIGA PER MESH
+
 class Object3D {
 public:
-    unsigned int VAO, VBO;
-    std::vector<Vertex> vertices;
+    unsigned int VAO = 0, VBO = 0;
+    MeshVertices vertices;                // Dipakai bersama instance lain (copy-on-write)
     glm::vec3 position;
     glm::vec3 rotation;
     glm::vec3 scale;
-    
-    Object3D() : position(0.0f), rotation(0.0f), scale(1.0f) {}
-    
-    void setup() {
+    std::string name;
+    ColliderMode collider;
+    bool isDynamic;                       // Bisa bergerak (masuk loose octree)
+    bool castsShadow;                     // Di-render ke shadow map
+    std::vector<DrawRange> drawRanges;    // Diisi oleh validateMesh()
+    std::vector<DetailPart> detailParts;  // Diisi oleh builder
+    std::shared_ptr<MeshBVH> bvh;   // BVH segitiga (prototype scene: saat load, lainnya saat picking)
+    std::vector<glm::vec3> bakedLight[2];  // Cahaya baked per vertex [lampu mati, nyala]
+    unsigned int bakedVBO = 0;
+    std::vector<float> bakedAO;           // AO baked per instance (kosong: Vertex::ao)
+    unsigned int aoVBO = 0;
+    bool gpuReady = false;                   // Semua vertex sudah ada di VBO (boleh digambar)
+    size_t gpuCapacity = 0;                  // Kapasitas VBO (vertex), bisa > vertices.size()
+    DirtyRanges dirtyRanges;                 // Byte VBO yang menunggu flushDirty()
+    
+    Object3D() : position(0.0f), rotation(0.0f), scale(1.0f), collider(COLLIDE_NONE), isDynamic(false),
+                 castsShadow(true) {}
+    
+    // uploadData = false: VBO hanya dialokasikan, isinya dikirim kemudian
+    // lewat uploadVertices (upload bertahap, lihat SceneLoader)
+    void setup(bool uploadData = true) {
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
         
         glBindVertexArray(VAO);
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), 
-                     vertices.data(), GL_STATIC_DRAW);
+                     uploadData ? uploadSource() : nullptr, GL_STATIC_DRAW);
+        gpuReady = uploadData;
+        gpuCapacity = vertices.size();
         
         // Position attribute
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), 
@@ -127,10 +427,73 @@ public:
                              (void*)offsetof(Vertex, color));
         glEnableVertexAttribArray(2);
         
+        // Ambient occlusion attribute
+        glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), 
+                             (void*)offsetof(Vertex, ao));
+        glEnableVertexAttribArray(4);
+        
+        // Material attribute (integer, indeks layer texture array)
+        glVertexAttribIPointer(5, 1, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, material));
+        glEnableVertexAttribArray(5);
+        
         glBindVertexArray(0);
     }
     
-    glm::mat4 getModelMatrix() {
+    // Kirim vertex [first, first + count) ke VBO yang sudah dialokasikan
+    void uploadVertices(size_t first, size_t count) {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Vertex), count * sizeof(Vertex),
+                        uploadSource() + first);
+    }
+    
+    // Vertex [first, first + count) diubah di CPU; dikirim di flushDirty()
+    void markDirty(size_t first, size_t count) {
+        dirtyRanges.mark(first * sizeof(Vertex), (first + count) * sizeof(Vertex));
+    }
+    
+    // Kirim rentang kotor ke VBO. Sedikit rentang: glBufferSubData per
+    // rentang; banyak rentang: satu glMapBufferRange dengan flush eksplisit
+    // per rentang. Mesh yang tumbuh melebihi kapasitas dialokasikan ulang
+    // (kapasitas naik 1.5x agar edit berikutnya muat). Return byte terkirim.
+    size_t flushDirty() {
+        if (dirtyRanges.empty() || !VBO) return 0;
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        if (vertices.size() > gpuCapacity) {
+            gpuCapacity = std::max(vertices.size(), gpuCapacity + gpuCapacity / 2);
+            glBufferData(GL_ARRAY_BUFFER, gpuCapacity * sizeof(Vertex), nullptr, GL_STATIC_DRAW);
+            dirtyRanges.clear();
+            dirtyRanges.mark(0, vertices.size() * sizeof(Vertex));
+        }
+        dirtyRanges.coalesce(vertices.size() * sizeof(Vertex));
+        const char* source = (const char*)uploadSource();
+        const auto& ranges = dirtyRanges.ranges;
+        size_t bytes = dirtyRanges.bytes();
+        
+        if (ranges.size() <= 4) {
+            for (const auto& r : ranges) {
+                glBufferSubData(GL_ARRAY_BUFFER, r.first, r.second - r.first, source + r.first);
+            }
+        } else if (!ranges.empty()) {
+            size_t lo = ranges.front().first, hi = ranges.back().second;
+            char* mapped = (char*)glMapBufferRange(GL_ARRAY_BUFFER, lo, hi - lo,
+                                                   GL_MAP_WRITE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+            if (mapped) {
+                for (const auto& r : ranges) {
+                    std::memcpy(mapped + (r.first - lo), source + r.first, r.second - r.first);
+                    glFlushMappedBufferRange(GL_ARRAY_BUFFER, r.first - lo, r.second - r.first);
+                }
+            }
+            // Isi buffer hilang (misal mode layar berganti): kirim ulang span
+            if (!mapped || !glUnmapBuffer(GL_ARRAY_BUFFER)) {
+                glBufferSubData(GL_ARRAY_BUFFER, lo, hi - lo, source + lo);
+                bytes = hi - lo;
+            }
+        }
+        dirtyRanges.clear();
+        return bytes;
+    }
+    
+    glm::mat4 getModelMatrix() const {
         glm::mat4 model = glm::mat4(1.0f);
         model = glm::translate(model, position);
         model = glm::rotate(model, glm::radians(rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
@@ -140,16 +503,125 @@ public:
         return model;
     }
     
+    // Bounding box dalam koordinat lokal (model space)
+    AABB getLocalBounds() const {
+        if (hasLocalBounds) return localBounds;
+        AABB bounds;
+        for (const auto& v : vertices) {
+            bounds.expand(v.position);
+        }
+        return bounds;
+    }
+    
+    // Simpan bounds (dari cache mesh atau setelah mesh final) agar tidak
+    // menghitung ulang dari vertex
+    void setLocalBounds(const AABB& bounds) {
+        localBounds = bounds;
+        hasLocalBounds = true;
+    }
+    
+    // Bounding box dalam koordinat dunia (world space)
+    AABB getWorldBounds() const {
+        return getLocalBounds().transformed(getModelMatrix());
+    }
+    
     void draw() {
         glBindVertexArray(VAO);
         glDrawArrays(GL_TRIANGLES, 0, vertices.size());
         glBindVertexArray(0);
     }
     
+    // Tandai vertex dari firstVertex sampai akhir sebagai layer detail.
+    // featureRadius <= 0 berarti seluruh bagian dianggap satu elemen.
+    void addDetailPart(int firstVertex, float featureRadius = 0.0f) {
+        DetailPart part;
+        part.authorFirst = firstVertex;
+        part.authorCount = (int)vertices.size() - firstVertex;
+        AABB bounds;
+        for (int i = firstVertex; i < (int)vertices.size(); i++) bounds.expand(vertices[i].position);
+        part.center = (bounds.min + bounds.max) * 0.5f;
+        part.radius = glm::length(bounds.max - bounds.min) * 0.5f;
+        part.featureRadius = featureRadius > 0.0f ? featureRadius : part.radius;
+        detailParts.push_back(part);
+    }
+    
+    // Upload cahaya baked kedua state lampu ke satu buffer (atribut 3,
+    // w = 1 menandai vertex yang memiliki data baked)
+    void setupBakedLight() {
+        if (bakedLight[0].size() != vertices.size() || bakedLight[1].size() != vertices.size()) return;
+        std::vector<glm::vec4> data;
+        data.reserve(vertices.size() * 2);
+        for (int state = 0; state < 2; state++) {
+            for (const glm::vec3& light : bakedLight[state]) data.push_back(glm::vec4(light, 1.0f));
+        }
+        glGenBuffers(1, &bakedVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, bakedVBO);
+        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(glm::vec4), data.data(), GL_STATIC_DRAW);
+        selectBakedState(1);
+    }
+    
+    // Arahkan atribut 3 ke separuh buffer milik state lampu (0 = mati, 1 = nyala)
+    void selectBakedState(int state) {
+        if (!bakedVBO) return;
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, bakedVBO);
+        glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4),
+                              (void*)(state * vertices.size() * sizeof(glm::vec4)));
+        glEnableVertexAttribArray(3);
+        glBindVertexArray(0);
+    }
+    
+    // Buang cahaya baked (mesh diganti atau objek baru hasil edit): buffer
+    // diisi w = 0 sehingga shader menghitung cahaya objek ini secara realtime
+    void resetBakedLight(int state) {
+        bakedLight[0].clear();
+        bakedLight[1].clear();
+        if (!bakedVBO) glGenBuffers(1, &bakedVBO);
+        std::vector<glm::vec4> zero(vertices.size() * 2, glm::vec4(0.0f));
+        glBindBuffer(GL_ARRAY_BUFFER, bakedVBO);
+        glBufferData(GL_ARRAY_BUFFER, zero.size() * sizeof(glm::vec4), zero.data(), GL_STATIC_DRAW);
+        selectBakedState(state);
+    }
+    
+    // Upload AO baked instance ini ke buffer sendiri dan arahkan atribut 4
+    // ke sana, sehingga VBO vertex tetap identik dengan vertex bersama
+    void setupBakedAO() {
+        if (bakedAO.empty() || bakedAO.size() != vertices.size()) return;
+        if (!aoVBO) glGenBuffers(1, &aoVBO);
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, aoVBO);
+        glBufferData(GL_ARRAY_BUFFER, bakedAO.size() * sizeof(float), bakedAO.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);
+        glBindVertexArray(0);
+    }
+    
+    // Mesh diganti: AO lama tidak berlaku, atribut 4 kembali ke Vertex::ao
+    void resetBakedAO() {
+        bakedAO.clear();
+        if (!aoVBO) return;
+        glDeleteBuffers(1, &aoVBO);
+        aoVBO = 0;
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, ao));
+        glBindVertexArray(0);
+    }
+    
     void cleanup() {
         glDeleteVertexArrays(1, &VAO);
         glDeleteBuffers(1, &VBO);
+        if (bakedVBO) glDeleteBuffers(1, &bakedVBO);
+        if (aoVBO) glDeleteBuffers(1, &aoVBO);
+        VAO = VBO = bakedVBO = aoVBO = 0;
+        gpuReady = false;
     }
+    
+private:
+    AABB localBounds;
+    bool hasLocalBounds = false;
+    
+    // Baca lewat const: vertex bersama (atau halaman mmap) tidak disalin
+    const Vertex* uploadSource() const { return vertices.data(); }
 };
 
 // =====================================================================
@@ -168,6 +640,13 @@ void addCubeFace(std::vector<Vertex>& vertices,
     vertices.push_back({p4, normal, color});
 }
 
+// Material untuk vertex [first, last) (default: seluruh mesh)
+void setMaterial(Object3D& obj, MaterialId material, size_t first = 0, size_t last = SIZE_MAX) {
+    last = std::min(last, obj.vertices.size());
+    std::vector<Vertex>& vertices = obj.vertices.edit();
+    for (size_t i = first; i < last; i++) vertices[i].material = material;
+}
+
 Object3D createCube(float width, float height, float depth, glm::vec3 color) {
     Object3D obj;
     float w = width / 2.0f;
@@ -175,37 +654,37 @@ Object3D createCube(float width, float height, float depth, glm::vec3 color) {
     float d = depth / 2.0f;
     
     // Front face
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-w, -h, d), glm::vec3(w, -h, d),
         glm::vec3(w, h, d), glm::vec3(-w, h, d),
         glm::vec3(0.0f, 0.0f, 1.0f), color);
     
     // Back face
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(w, -h, -d), glm::vec3(-w, -h, -d),
         glm::vec3(-w, h, -d), glm::vec3(w, h, -d),
         glm::vec3(0.0f, 0.0f, -1.0f), color);
     
     // Left face
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-w, -h, -d), glm::vec3(-w, -h, d),
         glm::vec3(-w, h, d), glm::vec3(-w, h, -d),
         glm::vec3(-1.0f, 0.0f, 0.0f), color);
     
     // Right face
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(w, -h, d), glm::vec3(w, -h, -d),
         glm::vec3(w, h, -d), glm::vec3(w, h, d),
         glm::vec3(1.0f, 0.0f, 0.0f), color);
     
     // Top face
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-w, h, d), glm::vec3(w, h, d),
         glm::vec3(w, h, -d), glm::vec3(-w, h, -d),
         glm::vec3(0.0f, 1.0f, 0.0f), color);
     
     // Bottom face
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-w, -h, -d), glm::vec3(w, -h, -d),
         glm::vec3(w, -h, d), glm::vec3(-w, -h, d),
         glm::vec3(0.0f, -1.0f, 0.0f), color);
@@ -236,12 +715,13 @@ Object3D createFloor(float width, float depth, glm::vec3 color) {
             // Warna kotak-kotak
             glm::vec3 tileColor = ((i + j) % 2 == 0) ? color : color * 0.7f;
             
-            addCubeFace(obj.vertices,
+            addCubeFace(obj.vertices.edit(),
                 glm::vec3(x1, 0.0f, z2), glm::vec3(x2, 0.0f, z2),
                 glm::vec3(x2, 0.0f, z1), glm::vec3(x1, 0.0f, z1),
                 glm::vec3(0.0f, 1.0f, 0.0f), tileColor);
         }
     }
+    setMaterial(obj, MATERIAL_TILE);
     
     return obj;
 }
@@ -256,60 +736,105 @@ Object3D createWalls(float width, float height, float depth, glm::vec3 color) {
     
     // Back wall (dengan lubang jendela)
     // Bagian kiri jendela
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-w, 0.0f, -d), glm::vec3(-1.5f, 0.0f, -d),
         glm::vec3(-1.5f, height, -d), glm::vec3(-w, height, -d),
         glm::vec3(0.0f, 0.0f, 1.0f), color);
     
     // Bagian kanan jendela
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(1.5f, 0.0f, -d), glm::vec3(w, 0.0f, -d),
         glm::vec3(w, height, -d), glm::vec3(1.5f, height, -d),
         glm::vec3(0.0f, 0.0f, 1.0f), color);
     
     // Bagian atas jendela
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-1.5f, 2.5f, -d), glm::vec3(1.5f, 2.5f, -d),
         glm::vec3(1.5f, height, -d), glm::vec3(-1.5f, height, -d),
         glm::vec3(0.0f, 0.0f, 1.0f), color);
     
     // Bagian bawah jendela
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-1.5f, 0.0f, -d), glm::vec3(1.5f, 0.0f, -d),
         glm::vec3(1.5f, 0.8f, -d), glm::vec3(-1.5f, 0.8f, -d),
         glm::vec3(0.0f, 0.0f, 1.0f), color);
     
     // Left wall
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-w, 0.0f, d), glm::vec3(-w, 0.0f, -d),
         glm::vec3(-w, height, -d), glm::vec3(-w, height, d),
         glm::vec3(1.0f, 0.0f, 0.0f), color * 0.95f);
     
     // Right wall (dengan lubang pintu)
     // Bagian atas pintu
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(w, 2.2f, d), glm::vec3(w, 2.2f, 1.0f),
         glm::vec3(w, height, 1.0f), glm::vec3(w, height, d),
         glm::vec3(-1.0f, 0.0f, 0.0f), color * 0.95f);
     
     // Bagian belakang pintu
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(w, 0.0f, 1.0f), glm::vec3(w, 0.0f, -d),
         glm::vec3(w, height, -d), glm::vec3(w, height, 1.0f),
         glm::vec3(-1.0f, 0.0f, 0.0f), color * 0.95f);
     
     // Bagian depan pintu
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(w, 0.0f, d), glm::vec3(w, 0.0f, 2.0f),
         glm::vec3(w, height, 2.0f), glm::vec3(w, height, d),
         glm::vec3(-1.0f, 0.0f, 0.0f), color * 0.95f);
     
     // Bagian atas pintu (di antara)
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(w, 2.2f, 2.0f), glm::vec3(w, 2.2f, 1.0f),
         glm::vec3(w, height, 1.0f), glm::vec3(w, height, 2.0f),
         glm::vec3(-1.0f, 0.0f, 0.0f), color * 0.95f);
+    setMaterial(obj, MATERIAL_PLASTER);
+    
+    return obj;
+}
+
+// =====================================================================
+// FUNGSI MEMBUAT SEGMEN DINDING (GEDUNG)
+// =====================================================================
+// Dinding tebal sepanjang sumbu X lokal dengan alas di y = 0. Berbeda dari
+// createWalls (satu sisi), segmen ini kotak tertutup sehingga benar dilihat
+// dari kedua ruangan yang dipisahkannya. Lubang jendela/pintu ada di tengah
+// dan seukuran createWindow / createDoor.
+enum WallOpening { OPENING_NONE, OPENING_WINDOW, OPENING_DOOR };
+const float WALL_THICKNESS = 0.1f;
+
+Object3D createWallSegment(float length, float height, WallOpening opening, glm::vec3 color) {
+    Object3D obj;
+    float l = length / 2.0f;
+    
+    auto addBlock = [&](float x0, float x1, float y0, float y1) {
+        if (x1 - x0 <= 0.0f || y1 - y0 <= 0.0f) return;
+        Object3D block = createCube(x1 - x0, y1 - y0, WALL_THICKNESS, color);
+        for (auto& v : block.vertices.edit()) {
+            v.position.x += (x0 + x1) / 2.0f;
+            v.position.y += (y0 + y1) / 2.0f;
+            v.material = MATERIAL_PLASTER;
+            obj.vertices.push_back(v);
+        }
+    };
+    
+    if (opening == OPENING_NONE) {
+        addBlock(-l, l, 0.0f, height);
+        return obj;
+    }
     
+    // Lubang [holeX0, holeX1] x [holeY0, holeY1]
+    bool window = opening == OPENING_WINDOW;
+    float holeX1 = std::min(window ? 1.5f : 0.5f, l);
+    float holeX0 = -holeX1;
+    float holeY0 = window ? 0.8f : 0.0f;
+    float holeY1 = std::min(window ? 2.5f : 2.2f, height);
+    
+    addBlock(-l, holeX0, 0.0f, height);         // Kiri lubang
+    addBlock(holeX1, l, 0.0f, height);          // Kanan lubang
+    addBlock(holeX0, holeX1, 0.0f, holeY0);     // Ambang bawah jendela
+    addBlock(holeX0, holeX1, holeY1, height);   // Di atas lubang
     return obj;
 }
 
@@ -321,10 +846,11 @@ Object3D createCeiling(float width, float depth, float height, glm::vec3 color)
     float w = width / 2.0f;
     float d = depth / 2.0f;
     
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-w, height, -d), glm::vec3(w, height, -d),
         glm::vec3(w, height, d), glm::vec3(-w, height, d),
         glm::vec3(0.0f, -1.0f, 0.0f), color);
+    setMaterial(obj, MATERIAL_PLASTER);
     
     return obj;
 }
@@ -340,44 +866,46 @@ Object3D createWindow(glm::vec3 color) {
     glm::vec3 frameColor(0.4f, 0.3f, 0.2f);  // Coklat kayu
     
     // Frame atas
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-1.5f, 2.4f, 0.0f), glm::vec3(1.5f, 2.4f, 0.0f),
         glm::vec3(1.5f, 2.5f, 0.0f), glm::vec3(-1.5f, 2.5f, 0.0f),
         glm::vec3(0.0f, 0.0f, 1.0f), frameColor);
     
     // Frame bawah
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-1.5f, 0.8f, 0.0f), glm::vec3(1.5f, 0.8f, 0.0f),
         glm::vec3(1.5f, 0.9f, 0.0f), glm::vec3(-1.5f, 0.9f, 0.0f),
         glm::vec3(0.0f, 0.0f, 1.0f), frameColor);
     
     // Frame kiri
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-1.5f, 0.8f, 0.0f), glm::vec3(-1.4f, 0.8f, 0.0f),
         glm::vec3(-1.4f, 2.5f, 0.0f), glm::vec3(-1.5f, 2.5f, 0.0f),
         glm::vec3(0.0f, 0.0f, 1.0f), frameColor);
     
     // Frame kanan
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(1.4f, 0.8f, 0.0f), glm::vec3(1.5f, 0.8f, 0.0f),
         glm::vec3(1.5f, 2.5f, 0.0f), glm::vec3(1.4f, 2.5f, 0.0f),
         glm::vec3(0.0f, 0.0f, 1.0f), frameColor);
     
     // Frame tengah vertikal
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-0.05f, 0.8f, 0.0f), glm::vec3(0.05f, 0.8f, 0.0f),
         glm::vec3(0.05f, 2.5f, 0.0f), glm::vec3(-0.05f, 2.5f, 0.0f),
         glm::vec3(0.0f, 0.0f, 1.0f), frameColor);
     
     // Frame tengah horizontal
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-1.5f, 1.6f, 0.0f), glm::vec3(1.5f, 1.6f, 0.0f),
         glm::vec3(1.5f, 1.7f, 0.0f), glm::vec3(-1.5f, 1.7f, 0.0f),
         glm::vec3(0.0f, 0.0f, 1.0f), frameColor);
     
+    setMaterial(obj, MATERIAL_WOOD);
+    
     // Kaca jendela (biru transparan effect)
     glm::vec3 glassColor(0.6f, 0.8f, 0.95f);
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-1.4f, 0.9f, -0.01f), glm::vec3(1.4f, 0.9f, -0.01f),
         glm::vec3(1.4f, 2.4f, -0.01f), glm::vec3(-1.4f, 2.4f, -0.01f),
         glm::vec3(0.0f, 0.0f, 1.0f), glassColor);
@@ -396,33 +924,37 @@ Object3D createDoor(glm::vec3 color) {
     
     // Badan pintu
     Object3D doorBody = createCube(doorWidth, doorHeight, doorDepth, color);
-    for (auto& v : doorBody.vertices) {
+    for (auto& v : doorBody.vertices.edit()) {
         v.position.y += doorHeight / 2.0f;
         obj.vertices.push_back(v);
     }
     
     // Handle pintu
     glm::vec3 handleColor(0.8f, 0.7f, 0.2f);  // Gold
+    int handleStart = obj.vertices.size();
     Object3D handle = createCube(0.05f, 0.15f, 0.08f, handleColor);
-    for (auto& v : handle.vertices) {
+    for (auto& v : handle.vertices.edit()) {
         v.position.x += 0.35f;
         v.position.y += 1.1f;
         v.position.z += 0.05f;
         obj.vertices.push_back(v);
     }
+    obj.addDetailPart(handleStart);
     
     // Panel dekoratif atas
     glm::vec3 panelColor = color * 0.8f;
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-0.35f, 1.4f, 0.03f), glm::vec3(0.25f, 1.4f, 0.03f),
         glm::vec3(0.25f, 2.0f, 0.03f), glm::vec3(-0.35f, 2.0f, 0.03f),
         glm::vec3(0.0f, 0.0f, 1.0f), panelColor);
     
     // Panel dekoratif bawah
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-0.35f, 0.2f, 0.03f), glm::vec3(0.25f, 0.2f, 0.03f),
         glm::vec3(0.25f, 1.2f, 0.03f), glm::vec3(-0.35f, 1.2f, 0.03f),
         glm::vec3(0.0f, 0.0f, 1.0f), panelColor);
+    setMaterial(obj, MATERIAL_WOOD);
+    setMaterial(obj, MATERIAL_METAL, handleStart, handleStart + handle.vertices.size());
     
     return obj;
 }
@@ -435,7 +967,7 @@ Object3D createDesk(glm::vec3 color) {
     
     // Permukaan meja
     Object3D top = createCube(1.6f, 0.05f, 0.8f, color);
-    for (auto& v : top.vertices) {
+    for (auto& v : top.vertices.edit()) {
         v.position.y += 0.75f;
         obj.vertices.push_back(v);
     }
@@ -446,7 +978,7 @@ Object3D createDesk(glm::vec3 color) {
     
     for (int i = 0; i < 4; i++) {
         Object3D leg = createCube(0.05f, 0.75f, 0.05f, legColor);
-        for (auto& v : leg.vertices) {
+        for (auto& v : leg.vertices.edit()) {
             v.position.x += legPositions[i][0];
             v.position.z += legPositions[i][1];
             v.position.y += 0.375f;
@@ -456,7 +988,7 @@ Object3D createDesk(glm::vec3 color) {
     
     // Laci meja
     Object3D drawer = createCube(0.5f, 0.2f, 0.6f, color * 0.9f);
-    for (auto& v : drawer.vertices) {
+    for (auto& v : drawer.vertices.edit()) {
         v.position.x += 0.45f;
         v.position.y += 0.55f;
         obj.vertices.push_back(v);
@@ -464,13 +996,17 @@ Object3D createDesk(glm::vec3 color) {
     
     // Handle laci
     glm::vec3 handleColor(0.6f, 0.6f, 0.6f);
+    int handleStart = obj.vertices.size();
     Object3D handle = createCube(0.15f, 0.03f, 0.03f, handleColor);
-    for (auto& v : handle.vertices) {
+    for (auto& v : handle.vertices.edit()) {
         v.position.x += 0.45f;
         v.position.y += 0.55f;
         v.position.z += 0.32f;
         obj.vertices.push_back(v);
     }
+    obj.addDetailPart(handleStart);
+    setMaterial(obj, MATERIAL_WOOD, 0, handleStart);
+    setMaterial(obj, MATERIAL_METAL, handleStart);
     
     return obj;
 }
@@ -483,29 +1019,32 @@ Object3D createChair(glm::vec3 color) {
     
     // Dudukan kursi
     Object3D seat = createCube(0.45f, 0.05f, 0.45f, color);
-    for (auto& v : seat.vertices) {
+    for (auto& v : seat.vertices.edit()) {
         v.position.y += 0.45f;
         obj.vertices.push_back(v);
     }
     
     // Sandaran kursi
     Object3D back = createCube(0.45f, 0.5f, 0.05f, color);
-    for (auto& v : back.vertices) {
+    for (auto& v : back.vertices.edit()) {
         v.position.y += 0.72f;
         v.position.z -= 0.2f;
         obj.vertices.push_back(v);
     }
     
+    setMaterial(obj, MATERIAL_FABRIC);
+    
     // Kaki kursi (4 kaki)
     glm::vec3 legColor(0.3f, 0.3f, 0.3f);
     float legPositions[4][2] = {{-0.18f, -0.18f}, {0.18f, -0.18f}, {-0.18f, 0.18f}, {0.18f, 0.18f}};
     
     for (int i = 0; i < 4; i++) {
         Object3D leg = createCube(0.04f, 0.45f, 0.04f, legColor);
-        for (auto& v : leg.vertices) {
+        for (auto& v : leg.vertices.edit()) {
             v.position.x += legPositions[i][0];
             v.position.z += legPositions[i][1];
             v.position.y += 0.225f;
+            v.material = MATERIAL_METAL;
             obj.vertices.push_back(v);
         }
     }
@@ -521,28 +1060,28 @@ Object3D createMonitor(glm::vec3 frameColor) {
     
     // Layar monitor
     Object3D screen = createCube(0.6f, 0.4f, 0.03f, glm::vec3(0.1f, 0.1f, 0.1f));
-    for (auto& v : screen.vertices) {
+    for (auto& v : screen.vertices.edit()) {
         v.position.y += 0.35f;
         obj.vertices.push_back(v);
     }
     
     // Bagian layar yang menyala
     glm::vec3 screenColor(0.2f, 0.4f, 0.6f);
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-0.27f, 0.18f, 0.02f), glm::vec3(0.27f, 0.18f, 0.02f),
         glm::vec3(0.27f, 0.5f, 0.02f), glm::vec3(-0.27f, 0.5f, 0.02f),
         glm::vec3(0.0f, 0.0f, 1.0f), screenColor);
     
     // Stand monitor
     Object3D stand = createCube(0.08f, 0.15f, 0.08f, frameColor);
-    for (auto& v : stand.vertices) {
+    for (auto& v : stand.vertices.edit()) {
         v.position.y += 0.075f;
         obj.vertices.push_back(v);
     }
     
     // Base monitor
     Object3D base = createCube(0.25f, 0.02f, 0.15f, frameColor);
-    for (auto& v : base.vertices) {
+    for (auto& v : base.vertices.edit()) {
         v.position.y += 0.01f;
         obj.vertices.push_back(v);
     }
@@ -557,15 +1096,16 @@ Object3D createKeyboard(glm::vec3 color) {
     Object3D obj;
     
     Object3D keyboard = createCube(0.4f, 0.02f, 0.15f, color);
-    for (auto& v : keyboard.vertices) {
+    for (auto& v : keyboard.vertices.edit()) {
         obj.vertices.push_back(v);
     }
     
     // Tombol-tombol keyboard (simplified)
     glm::vec3 keyColor(0.2f, 0.2f, 0.2f);
+    int keysStart = obj.vertices.size();
     for (int i = 0; i < 4; i++) {
         for (int j = 0; j < 10; j++) {
-            addCubeFace(obj.vertices,
+            addCubeFace(obj.vertices.edit(),
                 glm::vec3(-0.18f + j * 0.038f, 0.011f, -0.06f + i * 0.035f),
                 glm::vec3(-0.15f + j * 0.038f, 0.011f, -0.06f + i * 0.035f),
                 glm::vec3(-0.15f + j * 0.038f, 0.011f, -0.03f + i * 0.035f),
@@ -573,6 +1113,8 @@ Object3D createKeyboard(glm::vec3 color) {
                 glm::vec3(0.0f, 1.0f, 0.0f), keyColor);
         }
     }
+    // Satu layer untuk 40 tombol; ukuran fitur = satu tombol (3 x 3 cm)
+    obj.addDetailPart(keysStart, 0.021f);
     
     return obj;
 }
@@ -585,28 +1127,29 @@ Object3D createCabinet(glm::vec3 color) {
     
     // Badan lemari
     Object3D body = createCube(0.8f, 2.0f, 0.5f, color);
-    for (auto& v : body.vertices) {
+    for (auto& v : body.vertices.edit()) {
         v.position.y += 1.0f;
         obj.vertices.push_back(v);
     }
     
     // Pintu lemari kiri
     glm::vec3 doorColor = color * 0.9f;
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-0.38f, 0.05f, 0.26f), glm::vec3(-0.02f, 0.05f, 0.26f),
         glm::vec3(-0.02f, 1.95f, 0.26f), glm::vec3(-0.38f, 1.95f, 0.26f),
         glm::vec3(0.0f, 0.0f, 1.0f), doorColor);
     
     // Pintu lemari kanan
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(0.02f, 0.05f, 0.26f), glm::vec3(0.38f, 0.05f, 0.26f),
         glm::vec3(0.38f, 1.95f, 0.26f), glm::vec3(0.02f, 1.95f, 0.26f),
         glm::vec3(0.0f, 0.0f, 1.0f), doorColor);
     
     // Handle lemari
     glm::vec3 handleColor(0.7f, 0.7f, 0.7f);
+    int handleStart = obj.vertices.size();
     Object3D handleL = createCube(0.02f, 0.15f, 0.02f, handleColor);
-    for (auto& v : handleL.vertices) {
+    for (auto& v : handleL.vertices.edit()) {
         v.position.x -= 0.05f;
         v.position.y += 1.0f;
         v.position.z += 0.28f;
@@ -614,12 +1157,16 @@ Object3D createCabinet(glm::vec3 color) {
     }
     
     Object3D handleR = createCube(0.02f, 0.15f, 0.02f, handleColor);
-    for (auto& v : handleR.vertices) {
+    for (auto& v : handleR.vertices.edit()) {
         v.position.x += 0.05f;
         v.position.y += 1.0f;
         v.position.z += 0.28f;
         obj.vertices.push_back(v);
     }
+    // Dua handle dalam satu layer; ukuran fitur = satu handle
+    obj.addDetailPart(handleStart, 0.076f);
+    setMaterial(obj, MATERIAL_WOOD, 0, handleStart);
+    setMaterial(obj, MATERIAL_METAL, handleStart);
     
     return obj;
 }
@@ -632,7 +1179,7 @@ Object3D createCeilingLamp(glm::vec3 color) {
     
     // Tiang gantung
     Object3D rod = createCube(0.02f, 0.3f, 0.02f, glm::vec3(0.3f, 0.3f, 0.3f));
-    for (auto& v : rod.vertices) {
+    for (auto& v : rod.vertices.edit()) {
         v.position.y += 0.15f;
         obj.vertices.push_back(v);
     }
@@ -667,7 +1214,7 @@ Object3D createCeilingLamp(glm::vec3 color) {
     
     // Bola lampu
     Object3D bulb = createCube(0.08f, 0.1f, 0.08f, color);
-    for (auto& v : bulb.vertices) {
+    for (auto& v : bulb.vertices.edit()) {
         v.position.y -= 0.15f;
         obj.vertices.push_back(v);
     }
@@ -682,16 +1229,18 @@ Object3D createBook(glm::vec3 color) {
     Object3D obj;
     
     Object3D book = createCube(0.15f, 0.22f, 0.03f, color);
-    for (auto& v : book.vertices) {
+    for (auto& v : book.vertices.edit()) {
         obj.vertices.push_back(v);
     }
     
     // Halaman
     glm::vec3 pageColor(0.95f, 0.95f, 0.9f);
-    addCubeFace(obj.vertices,
+    int pageStart = obj.vertices.size();
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-0.07f, -0.1f, 0.016f), glm::vec3(0.07f, -0.1f, 0.016f),
         glm::vec3(0.07f, 0.1f, 0.016f), glm::vec3(-0.07f, 0.1f, 0.016f),
         glm::vec3(0.0f, 0.0f, 1.0f), pageColor);
+    obj.addDetailPart(pageStart);
     
     return obj;
 }
@@ -702,7 +1251,7 @@ Object3D createBook(glm::vec3 color) {
 Object3D createRug(float width, float depth, glm::vec3 color) {
     Object3D obj;
     
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-width/2, 0.01f, depth/2), glm::vec3(width/2, 0.01f, depth/2),
         glm::vec3(width/2, 0.01f, -depth/2), glm::vec3(-width/2, 0.01f, -depth/2),
         glm::vec3(0.0f, 1.0f, 0.0f), color);
@@ -712,16 +1261,17 @@ Object3D createRug(float width, float depth, glm::vec3 color) {
     float border = 0.1f;
     
     // Border depan
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-width/2, 0.012f, depth/2), glm::vec3(width/2, 0.012f, depth/2),
         glm::vec3(width/2, 0.012f, depth/2 - border), glm::vec3(-width/2, 0.012f, depth/2 - border),
         glm::vec3(0.0f, 1.0f, 0.0f), borderColor);
     
     // Border belakang
-    addCubeFace(obj.vertices,
+    addCubeFace(obj.vertices.edit(),
         glm::vec3(-width/2, 0.012f, -depth/2 + border), glm::vec3(width/2, 0.012f, -depth/2 + border),
         glm::vec3(width/2, 0.012f, -depth/2), glm::vec3(-width/2, 0.012f, -depth/2),
         glm::vec3(0.0f, 1.0f, 0.0f), borderColor);
+    setMaterial(obj, MATERIAL_FABRIC);
     
     return obj;
 }
@@ -736,314 +1286,7984 @@ Object3D createLightCube() {
 }
 
 // =====================================================================
-// MAIN FUNCTION
+// VALIDASI MESH: WINDING, NORMAL, DAN MESH TERTUTUP
 // =====================================================================
-int main() {
-    // Inisialisasi GLFW
-    if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW" << std::endl;
-        return -1;
+// Winding setiap segitiga dicocokkan dengan normal yang dideklarasikan
+// builder (counter-clockwise = sisi depan). Segitiga yang terbalik
+// diperbaiki otomatis. Segitiga lalu dikelompokkan per komponen yang
+// terhubung lewat edge manifold (tepat dua segitiga dengan arah
+// berlawanan): komponen tanpa edge terbuka aman untuk back-face culling,
+// sedangkan bidang tunggal (dinding, kaca, karpet, panel) digambar dua
+// sisi. Edge yang bukan manifold tidak menggabungkan komponen, sehingga
+// kotak tertutup yang menyentuh panel tetap di-cull.
+struct MeshValidationResult {
+    int triangles = 0;
+    int flipped = 0;            // Winding diperbaiki
+    int degenerate = 0;
+    int closedTriangles = 0;    // Boleh di-cull
+    int twoSidedTriangles = 0;
+};
+
+MeshValidationResult validateMesh(Object3D& obj) {
+    MeshValidationResult result;
+    std::vector<Vertex>& verts = obj.vertices.edit();
+    int triCount = (int)(verts.size() / 3);
+    result.triangles = triCount;
+    
+    // 1. Cocokkan winding dengan normal deklarasi
+    for (int t = 0; t < triCount; t++) {
+        Vertex* v = &verts[t * 3];
+        glm::vec3 geometric = glm::cross(v[1].position - v[0].position,
+                                         v[2].position - v[0].position);
+        if (glm::dot(geometric, geometric) < 1e-14f) {
+            result.degenerate++;
+            continue;
+        }
+        glm::vec3 declared = v[0].normal + v[1].normal + v[2].normal;
+        if (glm::dot(geometric, declared) < 0.0f) {
+            std::swap(v[1], v[2]);
+            result.flipped++;
+        }
     }
     
-    // Konfigurasi GLFW
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    
-    // Buat window
-    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, 
-        "Simulasi Ruang Kerja 3D - Grafika Komputer", NULL, NULL);
-    if (window == NULL) {
-        std::cerr << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return -1;
+    // 2. Beri ID pada posisi yang sama (dikuantisasi 0.1 mm)
+    struct PosKey { int x, y, z, vertex; };
+    std::vector<PosKey> keys(verts.size());
+    for (size_t i = 0; i < verts.size(); i++) {
+        glm::ivec3 q(glm::round(verts[i].position * 10000.0f));
+        keys[i] = {q.x, q.y, q.z, (int)i};
+    }
+    std::sort(keys.begin(), keys.end(), [](const PosKey& a, const PosKey& b) {
+        if (a.x != b.x) return a.x < b.x;
+        if (a.y != b.y) return a.y < b.y;
+        return a.z < b.z;
+    });
+    std::vector<int> posId(verts.size());
+    int nextId = -1;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (i == 0 || keys[i].x != keys[i - 1].x || keys[i].y != keys[i - 1].y ||
+            keys[i].z != keys[i - 1].z) nextId++;
+        posId[keys[i].vertex] = nextId;
     }
-    glfwMakeContextCurrent(window);
     
-    // Set callbacks
-    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetScrollCallback(window, scroll_callback);
+    // 3. Kumpulkan edge (tak berarah) beserta arahnya per segitiga
+    struct EdgeRef { uint64_t key; int triangle; int forward; };
+    std::vector<EdgeRef> edges;
+    edges.reserve(triCount * 3);
+    for (int t = 0; t < triCount; t++) {
+        for (int e = 0; e < 3; e++) {
+            uint32_t a = posId[t * 3 + e];
+            uint32_t b = posId[t * 3 + (e + 1) % 3];
+            if (a == b) continue;
+            uint64_t key = ((uint64_t)std::min(a, b) << 32) | std::max(a, b);
+            edges.push_back({key, t, a < b ? 1 : 0});
+        }
+    }
+    std::sort(edges.begin(), edges.end(), [](const EdgeRef& a, const EdgeRef& b) {
+        return a.key < b.key;
+    });
+    
+    // 4. Union-find segitiga yang berbagi edge manifold, lalu tandai edge
+    //    terbuka per komponen: dalam satu komponen setiap edge harus dipakai
+    //    tepat dua segitiga dengan arah berlawanan. Segitiga komponen lain
+    //    pada edge yang sama (panel yang menempel) tidak membuatnya terbuka.
+    std::vector<int> parent(triCount);
+    for (int t = 0; t < triCount; t++) parent[t] = t;
+    auto find = [&parent](int x) {
+        while (parent[x] != x) x = parent[x] = parent[parent[x]];
+        return x;
+    };
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i;
+        while (j < edges.size() && edges[j].key == edges[i].key) j++;
+        if (j - i == 2 && edges[i].forward != edges[i + 1].forward) {
+            parent[find(edges[i + 1].triangle)] = find(edges[i].triangle);
+        }
+        i = j;
+    }
+    std::vector<char> openTriangle(triCount, 0);
+    for (size_t i = 0; i < edges.size();) {
+        size_t j = i;
+        while (j < edges.size() && edges[j].key == edges[i].key) j++;
+        for (size_t k = i; k < j; k++) {
+            int component = find(edges[k].triangle);
+            int uses = 0, forward = 0;
+            for (size_t m = i; m < j; m++) {
+                if (find(edges[m].triangle) != component) continue;
+                uses++;
+                forward += edges[m].forward;
+            }
+            if (uses != 2 || forward != 1) openTriangle[edges[k].triangle] = 1;
+        }
+        i = j;
+    }
+    std::vector<char> openComponent(triCount, 0);
+    for (int t = 0; t < triCount; t++) {
+        if (openTriangle[t]) openComponent[find(t)] = 1;
+    }
     
-    // Capture mouse
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    // 5. Susun ulang per layer (utama, lalu setiap layer detail); dalam
+    //    satu layer komponen tertutup dulu, lalu yang dua sisi
+    std::vector<int> triPart(triCount, -1);
+    for (int p = 0; p < (int)obj.detailParts.size(); p++) {
+        const DetailPart& part = obj.detailParts[p];
+        for (int v = part.authorFirst; v < part.authorFirst + part.authorCount; v += 3)
+            triPart[v / 3] = p;
+    }
     
-    // Inisialisasi GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Failed to initialize GLAD" << std::endl;
-        return -1;
+    std::vector<Vertex> reordered;
+    reordered.reserve(verts.size());
+    obj.drawRanges.clear();
+    for (int p = -1; p < (int)obj.detailParts.size(); p++) {
+        // Rentang layer tetap bersambung setelah diurutkan ulang
+        int partFirst = (int)reordered.size();
+        for (int open = 0; open < 2; open++) {
+            int first = (int)reordered.size();
+            for (int t = 0; t < triCount; t++) {
+                if (triPart[t] != p || openComponent[find(t)] != open) continue;
+                reordered.insert(reordered.end(), verts.begin() + t * 3, verts.begin() + t * 3 + 3);
+            }
+            int count = (int)reordered.size() - first;
+            if (count == 0) continue;
+            obj.drawRanges.push_back({first, count, open == 1, p});
+            if (open) result.twoSidedTriangles += count / 3;
+            else result.closedTriangles += count / 3;
+        }
+        if (p >= 0) {
+            obj.detailParts[p].authorFirst = partFirst;
+            obj.detailParts[p].authorCount = (int)reordered.size() - partFirst;
+        }
     }
+    verts.swap(reordered);
+    return result;
+}
+
+// =====================================================================
+// SISTEM KOLISI KAMERA (CAPSULE + BROADPHASE UNIFORM GRID)
+// =====================================================================
+// Kamera direpresentasikan sebagai capsule vertikal. Broadphase memakai
+// uniform grid (hash cell -> daftar collider, disimpan terurut/CSR) dan
+// narrow phase menguji capsule terhadap kotak (AABB objek) dan segitiga
+// (dinding, lantai, langit-langit). Penetrasi didorong keluar sepanjang
+// normal kontak sehingga kamera "meluncur" di sepanjang permukaan.
+
+struct Collider {
+    AABB bounds;
+    glm::vec3 v0, v1, v2;   // Hanya dipakai untuk segitiga
+    bool isTriangle;
+    bool active = true;     // false: objeknya diedit/dihapus (lihat SceneEditor)
+};
+
+// Titik terdekat pada segitiga terhadap titik p (Ericson, RTCD 5.1.5)
+glm::vec3 closestPointOnTriangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c) {
+    glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
     
-    // Enable depth testing
-    glEnable(GL_DEPTH_TEST);
+    glm::vec3 bp = p - b;
+    float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
     
-    // Load shaders
-    unsigned int shaderProgram = loadShader("shaders/vertex_shader.glsl", 
-                                            "shaders/fragment_shader.glsl");
-    unsigned int lightShader = loadShader("shaders/light_vertex.glsl", 
-                                          "shaders/light_fragment.glsl");
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return a + ab * (d1 / (d1 - d3));
     
-    // =====================================================================
-    // BUAT SEMUA OBJEK RUANGAN
-    // =====================================================================
+    glm::vec3 cp = p - c;
+    float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
     
-    // Dimensi ruangan
-    float roomWidth = 10.0f;
-    float roomHeight = 4.0f;
-    float roomDepth = 8.0f;
-    
-    // Warna-warna
-    glm::vec3 floorColor(0.6f, 0.5f, 0.4f);      // Coklat lantai kayu
-    glm::vec3 wallColor(0.9f, 0.88f, 0.82f);     // Krem dinding
-    glm::vec3 ceilingColor(0.95f, 0.95f, 0.95f); // Putih langit-langit
-    glm::vec3 deskColor(0.55f, 0.4f, 0.25f);     // Coklat meja kayu
-    glm::vec3 chairColor(0.15f, 0.15f, 0.15f);   // Hitam kursi
-    glm::vec3 doorColor(0.5f, 0.35f, 0.2f);      // Coklat pintu
-    glm::vec3 cabinetColor(0.6f, 0.45f, 0.3f);   // Coklat lemari
-    glm::vec3 rugColor(0.6f, 0.2f, 0.2f);        // Merah karpet
-    
-    // Buat objek-objek
-    Object3D floor = createFloor(roomWidth, roomDepth, floorColor);
-    floor.setup();
-    
-    Object3D walls = createWalls(roomWidth, roomHeight, roomDepth, wallColor);
-    walls.setup();
-    
-    Object3D ceiling = createCeiling(roomWidth, roomDepth, roomHeight, ceilingColor);
-    ceiling.setup();
-    
-    Object3D windowObj = createWindow(glm::vec3(0.6f, 0.8f, 0.9f));
-    windowObj.position = glm::vec3(0.0f, 0.0f, -roomDepth/2 + 0.01f);
-    windowObj.setup();
-    
-    Object3D door = createDoor(doorColor);
-    door.position = glm::vec3(roomWidth/2 - 0.01f, 0.0f, 1.5f);
-    door.rotation = glm::vec3(0.0f, -90.0f, 0.0f);
-    door.setup();
-    
-    // Meja kerja (menempel dinding belakang)
-    Object3D desk = createDesk(deskColor);
-    desk.position = glm::vec3(-2.5f, 0.0f, -3.6f);  // Menempel dinding belakang
-    desk.setup();
-    
-    // Kursi (di depan meja)
-    Object3D chair = createChair(chairColor);
-    chair.position = glm::vec3(-2.5f, 0.0f, -2.3f);  // Di depan meja
-    chair.rotation = glm::vec3(0.0f, 180.0f, 0.0f);  // Menghadap ke meja
-    chair.setup();
-    
-    // Monitor (di atas meja)
-    Object3D monitor = createMonitor(glm::vec3(0.2f, 0.2f, 0.2f));
-    monitor.position = glm::vec3(-2.5f, 0.78f, -3.7f);  // Di atas meja dekat dinding
-    monitor.setup();
-    
-    // Keyboard (di atas meja)
-    Object3D keyboard = createKeyboard(glm::vec3(0.15f, 0.15f, 0.15f));
-    keyboard.position = glm::vec3(-2.5f, 0.78f, -3.4f);  // Di depan monitor, di atas meja
-    keyboard.setup();
-    
-    // Lemari (di sudut kiri belakang)
-    Object3D cabinet = createCabinet(cabinetColor);
-    cabinet.position = glm::vec3(-4.0f, 0.0f, -3.5f);  // Posisi semula
-    cabinet.setup();
-    
-    // Lampu gantung
-    Object3D lamp = createCeilingLamp(glm::vec3(1.0f, 0.95f, 0.8f));
-    lamp.position = glm::vec3(0.0f, roomHeight - 0.3f, 0.0f);
-    lamp.setup();
-    
-    // Buku-buku di meja (posisi flat di atas meja)
-    Object3D book1 = createBook(glm::vec3(0.8f, 0.2f, 0.2f));
-    book1.position = glm::vec3(-3.0f, 0.795f, -3.3f);  // Di atas meja
-    book1.rotation = glm::vec3(90.0f, 15.0f, 0.0f);    // Flat di meja
-    book1.setup();
-    
-    Object3D book2 = createBook(glm::vec3(0.2f, 0.4f, 0.8f));
-    book2.position = glm::vec3(-3.0f, 0.82f, -3.3f);   // Di atas buku pertama
-    book2.rotation = glm::vec3(90.0f, -5.0f, 0.0f);    // Flat di meja
-    book2.setup();
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return a + ac * (d2 / (d2 - d6));
     
-    // Light source visualization
-    Object3D lightCube = createLightCube();
-    lightCube.position = lightPos;
-    lightCube.setup();
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
     
-    // Print kontrol
-    std::cout << "========================================" << std::endl;
-    std::cout << "  SIMULASI RUANG KERJA 3D" << std::endl;
-    std::cout << "  Grafika Komputer" << std::endl;
-    std::cout << "========================================" << std::endl;
-    std::cout << "\nKONTROL:" << std::endl;
-    std::cout << "  WASD      - Gerak kamera" << std::endl;
-    std::cout << "  Mouse     - Rotasi pandangan" << std::endl;
-    std::cout << "  Scroll    - Zoom in/out" << std::endl;
-    std::cout << "  1         - View depan" << std::endl;
-    std::cout << "  2         - View atas" << std::endl;
-    std::cout << "  3         - View samping" << std::endl;
-    std::cout << "  4         - View sudut" << std::endl;
-    std::cout << "  L         - Toggle lampu" << std::endl;
-    std::cout << "  ESC       - Keluar" << std::endl;
-    std::cout << "========================================" << std::endl;
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+class CollisionWorld {
+public:
+    float cellSize = 1.0f;
+    float capsuleRadius = 0.2f;     // Radius capsule kamera
+    float capsuleHeight = 0.5f;     // Panjang segmen di bawah mata kamera
+    
+    // Statistik query terakhir
+    int lastCandidateCount = 0;
+    int lastContactCount = 0;
+    
+    void clear() {
+        colliders.clear();
+        cellKeys.clear();
+        cellStart.clear();
+        cellItems.clear();
+        objectColliders.clear();
+        looseObjects.clear();
+        builtColliders = 0;
+    }
     
-    // =====================================================================
-    // RENDER LOOP
-    // =====================================================================
-    while (!glfwWindowShouldClose(window)) {
-        // Hitung delta time
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+    void addObject(const Object3D& obj, ColliderMode mode) {
+        int first = (int)colliders.size();
+        if (mode == COLLIDE_BOX) {
+            Collider c;
+            c.bounds = obj.getWorldBounds();
+            c.isTriangle = false;
+            colliders.push_back(c);
+        } else if (mode == COLLIDE_TRIANGLES) {
+            glm::mat4 model = obj.getModelMatrix();
+            for (size_t i = 0; i + 2 < obj.vertices.size(); i += 3) {
+                Collider c;
+                c.v0 = glm::vec3(model * glm::vec4(obj.vertices[i].position, 1.0f));
+                c.v1 = glm::vec3(model * glm::vec4(obj.vertices[i + 1].position, 1.0f));
+                c.v2 = glm::vec3(model * glm::vec4(obj.vertices[i + 2].position, 1.0f));
+                c.bounds.expand(c.v0);
+                c.bounds.expand(c.v1);
+                c.bounds.expand(c.v2);
+                c.isTriangle = true;
+                colliders.push_back(c);
+            }
+        }
+        if ((int)colliders.size() > first) objectColliders[&obj] = {first, (int)colliders.size() - first};
+    }
+    
+    // Edit inkremental: collider lama objek dinonaktifkan dan collider baru
+    // masuk daftar lepas per objek (diuji lewat bounds objeknya dulu), tanpa
+    // membangun ulang grid. Grid dibangun ulang jika daftar terlalu panjang.
+    void updateObject(const Object3D& obj, ColliderMode mode) {
+        auto it = objectColliders.find(&obj);
+        std::pair<int, int> old = it != objectColliders.end() ? it->second : std::make_pair(-1, 0);
+        removeObject(obj);
+        int first = (int)colliders.size();
+        addObject(obj, mode);
+        int count = (int)colliders.size() - first;
+        // Objek yang sudah lepas dengan jumlah collider sama (dipindah lagi):
+        // slot lamanya ditimpa sehingga daftar lepas tidak bertambah
+        if (old.first >= builtColliders && old.second == count && count > 0) {
+            std::copy(colliders.begin() + first, colliders.end(), colliders.begin() + old.first);
+            colliders.resize(first);
+            objectColliders[&obj] = old;
+            for (LooseObject& loose : looseObjects) {
+                if (loose.first != old.first) continue;
+                loose.bounds = AABB();
+                for (int i = old.first; i < old.first + count; i++) {
+                    loose.bounds.expand(colliders[i].bounds.min);
+                    loose.bounds.expand(colliders[i].bounds.max);
+                }
+            }
+            return;
+        }
+        if (count > 0) {
+            LooseObject loose{AABB(), first, (int)colliders.size() - first};
+            for (int i = first; i < (int)colliders.size(); i++) {
+                loose.bounds.expand(colliders[i].bounds.min);
+                loose.bounds.expand(colliders[i].bounds.max);
+            }
+            looseObjects.push_back(loose);
+        }
+        visitStamp.resize(colliders.size(), 0);
+        if (looseObjects.size() > MAX_LOOSE_OBJECTS) build();
+    }
+    
+    void removeObject(const Object3D& obj) {
+        auto it = objectColliders.find(&obj);
+        if (it == objectColliders.end()) return;
+        for (int i = it->second.first; i < it->second.first + it->second.second; i++) colliders[i].active = false;
+        objectColliders.erase(it);
+    }
+    
+    // Bangun grid: setiap collider didaftarkan ke semua cell yang disentuh
+    // bounding box-nya, lalu pasangan (cell, collider) diurutkan sehingga
+    // isi satu cell bersebelahan di memori.
+    void build() {
+        compact();
+        std::vector<std::pair<uint64_t, int>> pairs;
+        for (int i = 0; i < (int)colliders.size(); i++) {
+            glm::ivec3 c0 = cellCoord(colliders[i].bounds.min);
+            glm::ivec3 c1 = cellCoord(colliders[i].bounds.max);
+            for (int x = c0.x; x <= c1.x; x++)
+                for (int y = c0.y; y <= c1.y; y++)
+                    for (int z = c0.z; z <= c1.z; z++)
+                        pairs.push_back({cellKey(glm::ivec3(x, y, z)), i});
+        }
+        std::sort(pairs.begin(), pairs.end());
         
-        // Input
-        processInput(window);
+        cellKeys.clear();
+        cellStart.clear();
+        cellItems.clear();
+        cellItems.reserve(pairs.size());
+        for (size_t i = 0; i < pairs.size(); i++) {
+            if (cellKeys.empty() || cellKeys.back() != pairs[i].first) {
+                cellKeys.push_back(pairs[i].first);
+                cellStart.push_back((int)cellItems.size());
+            }
+            cellItems.push_back(pairs[i].second);
+        }
+        cellStart.push_back((int)cellItems.size());
         
-        // Clear buffers
-        glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        visitStamp.assign(colliders.size(), 0);
+        currentStamp = 0;
+        looseObjects.clear();
+        builtColliders = (int)colliders.size();
+    }
+    
+    // Gerakkan capsule dari 'from' ke 'to'. Mengembalikan posisi akhir
+    // setelah penetrasi diselesaikan (gerak meluncur di sepanjang permukaan).
+    glm::vec3 moveCapsule(glm::vec3 from, glm::vec3 to) {
+        lastCandidateCount = 0;
+        lastContactCount = 0;
+        if (colliders.empty()) return to;
         
-        // Setup matrices
-        glm::mat4 projection = glm::perspective(glm::radians(fov), 
-            (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f);
-        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        // Sub-step agar gerakan cepat tidak menembus dinding tipis
+        glm::vec3 delta = to - from;
+        float maxStep = capsuleRadius * 0.5f;
+        int steps = std::max(1, (int)std::ceil(glm::length(delta) / maxStep));
+        steps = std::min(steps, 16);
         
-        // Use main shader
-        glUseProgram(shaderProgram);
+        glm::vec3 pos = from;
+        for (int s = 0; s < steps; s++) {
+            pos += delta / (float)steps;
+            for (int iter = 0; iter < 4; iter++) {
+                if (!resolvePenetration(pos)) break;
+            }
+        }
+        return pos;
+    }
+    
+    size_t colliderCount() const { return colliders.size(); }
+    size_t cellCount() const { return cellKeys.size(); }
+    
+private:
+    static constexpr size_t MAX_LOOSE_OBJECTS = 1024;
+    
+    struct LooseObject {
+        AABB bounds;
+        int first, count;
+    };
+    
+    std::vector<Collider> colliders;
+    std::unordered_map<const Object3D*, std::pair<int, int>> objectColliders;   // [awal, jumlah]
+    std::vector<LooseObject> looseObjects;   // Collider hasil edit, belum masuk grid
+    int builtColliders = 0;                  // Collider [0, n) terdaftar di grid
+    std::vector<uint64_t> cellKeys;     // Key cell terurut (unik)
+    std::vector<int> cellStart;         // Offset awal item per cell
+    std::vector<int> cellItems;         // Indeks collider
+    std::vector<unsigned int> visitStamp;
+    unsigned int currentStamp = 0;
+    
+    glm::ivec3 cellCoord(glm::vec3 p) const {
+        return glm::ivec3(glm::floor(p / cellSize));
+    }
+    
+    // Buang collider nonaktif; collider satu objek tetap berurutan
+    void compact() {
+        std::vector<int> remap(colliders.size(), -1);
+        size_t out = 0;
+        for (size_t i = 0; i < colliders.size(); i++) {
+            if (!colliders[i].active) continue;
+            remap[i] = (int)out;
+            colliders[out++] = colliders[i];
+        }
+        if (out == colliders.size()) return;
+        colliders.resize(out);
+        for (auto& entry : objectColliders) entry.second.first = remap[entry.second.first];
+    }
+    
+    static uint64_t cellKey(glm::ivec3 c) {
+        // 21 bit per sumbu (offset agar koordinat negatif tetap valid)
+        const int64_t bias = 1 << 20;
+        return ((uint64_t)(c.x + bias) << 42) |
+               ((uint64_t)(c.y + bias) << 21) |
+               (uint64_t)(c.z + bias);
+    }
+    
+    // Satu iterasi: dorong capsule keluar dari semua collider yang ditembus.
+    // Mengembalikan true jika ada kontak.
+    bool resolvePenetration(glm::vec3& eye) {
+        glm::vec3 segTop = eye;
+        glm::vec3 segBottom = eye - glm::vec3(0.0f, capsuleHeight, 0.0f);
+        AABB query(glm::min(segTop, segBottom) - glm::vec3(capsuleRadius),
+                   glm::max(segTop, segBottom) + glm::vec3(capsuleRadius));
         
-        // Set uniforms
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 
-                          1, GL_FALSE, glm::value_ptr(projection));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 
-                          1, GL_FALSE, glm::value_ptr(view));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "lightPos"), 
-                    1, glm::value_ptr(lightPos));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "viewPos"), 
-                    1, glm::value_ptr(cameraPos));
+        if (++currentStamp == 0) {
+            std::fill(visitStamp.begin(), visitStamp.end(), 0);
+            currentStamp = 1;
+        }
         
-        // Lighting parameters based on light state
-        if (lightOn) {
-            glUniform3fv(glGetUniformLocation(shaderProgram, "lightColor"), 
-                        1, glm::value_ptr(lightColor));
-            glUniform1f(glGetUniformLocation(shaderProgram, "ambientStrength"), 0.3f);
-            glUniform1f(glGetUniformLocation(shaderProgram, "diffuseStrength"), 0.8f);
-            glUniform1f(glGetUniformLocation(shaderProgram, "specularStrength"), 0.5f);
-        } else {
-            glm::vec3 dimLight(0.3f, 0.3f, 0.35f);
-            glUniform3fv(glGetUniformLocation(shaderProgram, "lightColor"), 
-                        1, glm::value_ptr(dimLight));
-            glUniform1f(glGetUniformLocation(shaderProgram, "ambientStrength"), 0.15f);
-            glUniform1f(glGetUniformLocation(shaderProgram, "diffuseStrength"), 0.2f);
-            glUniform1f(glGetUniformLocation(shaderProgram, "specularStrength"), 0.1f);
+        glm::vec3 push(0.0f);
+        bool contact = false;
+        auto testCollider = [&](int idx) {
+            if (visitStamp[idx] == currentStamp) return;
+            visitStamp[idx] = currentStamp;
+            
+            const Collider& c = colliders[idx];
+            if (!c.active || !c.bounds.overlaps(query)) return;
+            lastCandidateCount++;
+            
+            glm::vec3 n;
+            float depth;
+            bool hit = c.isTriangle
+                ? capsuleVsTriangle(segBottom, segTop, c, n, depth)
+                : capsuleVsBox(segBottom, segTop, c.bounds, n, depth);
+            if (hit) {
+                // Ambil dorongan terbesar per sumbu agar kontak
+                // ganda (sudut ruangan) tidak didorong dua kali
+                glm::vec3 p = n * depth;
+                for (int a = 0; a < 3; a++) {
+                    if (std::fabs(p[a]) > std::fabs(push[a])) push[a] = p[a];
+                }
+                contact = true;
+                lastContactCount++;
+            }
+        };
+        
+        glm::ivec3 c0 = cellCoord(query.min);
+        glm::ivec3 c1 = cellCoord(query.max);
+        for (int x = c0.x; x <= c1.x; x++) {
+            for (int y = c0.y; y <= c1.y; y++) {
+                for (int z = c0.z; z <= c1.z; z++) {
+                    uint64_t key = cellKey(glm::ivec3(x, y, z));
+                    auto it = std::lower_bound(cellKeys.begin(), cellKeys.end(), key);
+                    if (it == cellKeys.end() || *it != key) continue;
+                    size_t cell = it - cellKeys.begin();
+                    
+                    for (int k = cellStart[cell]; k < cellStart[cell + 1]; k++) testCollider(cellItems[k]);
+                }
+            }
         }
-        glUniform1f(glGetUniformLocation(shaderProgram, "shininess"), 32.0f);
+        for (const LooseObject& loose : looseObjects) {
+            // Collider satu objek selalu nonaktif bersamaan
+            if (!colliders[loose.first].active || !loose.bounds.overlaps(query)) continue;
+            for (int i = loose.first; i < loose.first + loose.count; i++) testCollider(i);
+        }
+        eye += push;
+        return contact;
+    }
+    
+    // Capsule vertikal vs AABB: titik terdekat dihitung eksak karena
+    // segmen sejajar sumbu Y.
+    bool capsuleVsBox(glm::vec3 segBottom, glm::vec3 segTop, const AABB& box,
+                      glm::vec3& normal, float& depth) const {
+        float segY = glm::clamp((box.min.y + box.max.y) * 0.5f, segBottom.y, segTop.y);
+        float boxY = glm::clamp(segY, box.min.y, box.max.y);
+        segY = glm::clamp(boxY, segBottom.y, segTop.y);
         
-        // =====================================================================
-        // RENDER SEMUA OBJEK DENGAN TRANSFORMASI
-        // =====================================================================
+        glm::vec3 q(segTop.x, segY, segTop.z);
+        glm::vec3 p = glm::clamp(q, box.min, box.max);
+        glm::vec3 d = q - p;
+        float dist2 = glm::dot(d, d);
+        if (dist2 >= capsuleRadius * capsuleRadius) return false;
         
-        // Lantai
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(floor.getModelMatrix()));
-        floor.draw();
-        
-        // Dinding
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(walls.getModelMatrix()));
-        walls.draw();
-        
-        // Langit-langit
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(ceiling.getModelMatrix()));
-        ceiling.draw();
-        
-        // Jendela
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(windowObj.getModelMatrix()));
-        windowObj.draw();
-        
-        // Pintu
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(door.getModelMatrix()));
-        door.draw();
-        
-        // Meja
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(desk.getModelMatrix()));
-        desk.draw();
-        
-        // Kursi
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(chair.getModelMatrix()));
-        chair.draw();
-        
-        // Monitor
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(monitor.getModelMatrix()));
-        monitor.draw();
-        
-        // Keyboard
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(keyboard.getModelMatrix()));
-        keyboard.draw();
-        
-        // Lemari
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(cabinet.getModelMatrix()));
-        cabinet.draw();
-        
-        // Lampu gantung
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(lamp.getModelMatrix()));
-        lamp.draw();
-        
-        // Buku
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(book1.getModelMatrix()));
-        book1.draw();
-        
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 
-                          1, GL_FALSE, glm::value_ptr(book2.getModelMatrix()));
-        book2.draw();
+        if (dist2 > 1e-8f) {
+            float dist = std::sqrt(dist2);
+            normal = d / dist;
+            depth = capsuleRadius - dist;
+            return true;
+        }
         
-        // Render light source cube
-        if (lightOn) {
-            glUseProgram(lightShader);
+        // Sumbu capsule berada di dalam kotak: keluar lewat sisi terdekat
+        float pen[4] = {
+            q.x - box.min.x, box.max.x - q.x,
+            q.z - box.min.z, box.max.z - q.z
+        };
+        int best = 0;
+        for (int i = 1; i < 4; i++) if (pen[i] < pen[best]) best = i;
+        static const glm::vec3 dirs[4] = {
+            glm::vec3(-1, 0, 0), glm::vec3(1, 0, 0),
+            glm::vec3(0, 0, -1), glm::vec3(0, 0, 1)
+        };
+        normal = dirs[best];
+        depth = pen[best] + capsuleRadius;
+        return true;
+    }
+    
+    // Capsule vs segitiga: pasangan titik terdekat segmen-segitiga dicari
+    // dengan proyeksi bergantian (konvergen cepat untuk himpunan konveks).
+    bool capsuleVsTriangle(glm::vec3 segBottom, glm::vec3 segTop, const Collider& tri,
+                           glm::vec3& normal, float& depth) const {
+        glm::vec3 seg = segTop - segBottom;
+        float segLen2 = glm::dot(seg, seg);
+        glm::vec3 q = (segBottom + segTop) * 0.5f;
+        glm::vec3 p(0.0f);
+        for (int i = 0; i < 3; i++) {
+            p = closestPointOnTriangle(q, tri.v0, tri.v1, tri.v2);
+            float t = segLen2 > 0.0f ? glm::clamp(glm::dot(p - segBottom, seg) / segLen2, 0.0f, 1.0f) : 0.0f;
+            q = segBottom + seg * t;
+        }
+        p = closestPointOnTriangle(q, tri.v0, tri.v1, tri.v2);
+        
+        glm::vec3 d = q - p;
+        float dist2 = glm::dot(d, d);
+        if (dist2 >= capsuleRadius * capsuleRadius) return false;
+        
+        float dist = std::sqrt(dist2);
+        if (dist > 1e-5f) {
+            normal = d / dist;
+        } else {
+            // Tepat di bidang segitiga: gunakan normal geometris
+            normal = glm::normalize(glm::cross(tri.v1 - tri.v0, tri.v2 - tri.v0));
+        }
+        depth = capsuleRadius - dist;
+        return true;
+    }
+};
+
+// Dunia kolisi aktif (dipakai processInput)
+CollisionWorld* collisionWorld = nullptr;
+bool collisionEnabled = true;
+
+// =====================================================================
+// BVH (BOUNDING VOLUME HIERARCHY) GENERIK
+// =====================================================================
+// Dibangun dari daftar AABB primitif dengan binned SAH. Dipakai untuk
+// segitiga dalam satu mesh (ruang lokal) maupun untuk instance objek
+// dalam scene (ruang dunia).
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+struct BVHNode {
+    AABB bounds;
+    int leftFirst;  // Leaf: indeks primitif pertama, node dalam: anak kiri
+    int count;      // > 0 berarti leaf
+};
+
+// Uji ray vs AABB (slab test). Mengembalikan jarak masuk atau 1e30 jika meleset.
+inline float intersectRayAABB(glm::vec3 origin, glm::vec3 invDir, const AABB& box, float tMax) {
+    glm::vec3 t0 = (box.min - origin) * invDir;
+    glm::vec3 t1 = (box.max - origin) * invDir;
+    glm::vec3 tNear = glm::min(t0, t1);
+    glm::vec3 tFar = glm::max(t0, t1);
+    float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, tMax));
+    return enter <= exit ? enter : 1e30f;
+}
+
+// Uji ray vs segitiga (Moller-Trumbore)
+inline bool intersectRayTriangle(const Ray& ray, glm::vec3 v0, glm::vec3 v1, glm::vec3 v2, float& t) {
+    glm::vec3 e1 = v1 - v0;
+    glm::vec3 e2 = v2 - v0;
+    glm::vec3 p = glm::cross(ray.direction, e2);
+    float det = glm::dot(e1, p);
+    if (std::fabs(det) < 1e-12f) return false;
+    float invDet = 1.0f / det;
+    glm::vec3 s = ray.origin - v0;
+    float u = glm::dot(s, p) * invDet;
+    if (u < 0.0f || u > 1.0f) return false;
+    glm::vec3 q = glm::cross(s, e1);
+    float v = glm::dot(ray.direction, q) * invDet;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    t = glm::dot(e2, q) * invDet;
+    return t > 0.0f;
+}
+
+class BVH {
+public:
+    std::vector<BVHNode> nodes;
+    std::vector<int> primIndices;   // Urutan primitif sesuai leaf
+    int depth = 0;                  // Level leaf terdalam (root = 0), ukuran stack traversal
+    
+    void build(const std::vector<AABB>& primBounds, int maxLeafSize = 4) {
+        nodes.clear();
+        depth = 0;
+        primIndices.resize(primBounds.size());
+        for (size_t i = 0; i < primBounds.size(); i++) primIndices[i] = (int)i;
+        if (primBounds.empty()) return;
+        
+        centroids.resize(primBounds.size());
+        for (size_t i = 0; i < primBounds.size(); i++)
+            centroids[i] = (primBounds[i].min + primBounds[i].max) * 0.5f;
+        
+        nodes.reserve(primBounds.size() * 2);
+        nodes.push_back({AABB(), 0, (int)primBounds.size()});
+        subdivide(0, primBounds, maxLeafSize, 0);
+        centroids.clear();
+        centroids.shrink_to_fit();
+    }
+    
+private:
+    std::vector<glm::vec3> centroids;
+    
+    static float surfaceArea(const AABB& b) {
+        glm::vec3 e = glm::max(b.max - b.min, glm::vec3(0.0f));
+        return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+    }
+    
+    void subdivide(int nodeIndex, const std::vector<AABB>& primBounds, int maxLeafSize, int level) {
+        depth = std::max(depth, level);
+        int first = nodes[nodeIndex].leftFirst;
+        int count = nodes[nodeIndex].count;
+        
+        AABB bounds, centroidBounds;
+        for (int i = first; i < first + count; i++) {
+            const AABB& b = primBounds[primIndices[i]];
+            bounds.expand(b.min);
+            bounds.expand(b.max);
+            centroidBounds.expand(centroids[primIndices[i]]);
+        }
+        nodes[nodeIndex].bounds = bounds;
+        if (count <= maxLeafSize) return;
+        
+        // Binned SAH pada sumbu terpanjang dari centroid
+        glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+        int axis = 0;
+        if (extent.y > extent[axis]) axis = 1;
+        if (extent.z > extent[axis]) axis = 2;
+        if (extent[axis] <= 1e-6f) return;
+        
+        const int BINS = 12;
+        AABB binBounds[BINS];
+        int binCount[BINS] = {0};
+        float scale = BINS / extent[axis];
+        for (int i = first; i < first + count; i++) {
+            int b = std::min(BINS - 1, (int)((centroids[primIndices[i]][axis] - centroidBounds.min[axis]) * scale));
+            binCount[b]++;
+            binBounds[b].expand(primBounds[primIndices[i]].min);
+            binBounds[b].expand(primBounds[primIndices[i]].max);
+        }
+        
+        float leftArea[BINS - 1], rightArea[BINS - 1];
+        int leftCount[BINS - 1], rightCount[BINS - 1];
+        AABB leftBox, rightBox;
+        int leftSum = 0, rightSum = 0;
+        for (int i = 0; i < BINS - 1; i++) {
+            leftSum += binCount[i];
+            leftCount[i] = leftSum;
+            if (binCount[i]) { leftBox.expand(binBounds[i].min); leftBox.expand(binBounds[i].max); }
+            leftArea[i] = surfaceArea(leftBox);
+            
+            rightSum += binCount[BINS - 1 - i];
+            rightCount[BINS - 2 - i] = rightSum;
+            if (binCount[BINS - 1 - i]) { rightBox.expand(binBounds[BINS - 1 - i].min); rightBox.expand(binBounds[BINS - 1 - i].max); }
+            rightArea[BINS - 2 - i] = surfaceArea(rightBox);
+        }
+        
+        float bestCost = 1e30f;
+        int bestSplit = -1;
+        for (int i = 0; i < BINS - 1; i++) {
+            if (leftCount[i] == 0 || rightCount[i] == 0) continue;
+            float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+            if (cost < bestCost) { bestCost = cost; bestSplit = i; }
+        }
+        if (bestSplit < 0 || bestCost >= count * surfaceArea(bounds)) {
+            if (count <= maxLeafSize * 4) return;   // Leaf lebih murah
+            if (bestSplit < 0) return;
+        }
+        
+        // Partisi primitif
+        float splitPos = centroidBounds.min[axis] + (bestSplit + 1) / scale;
+        int i = first, j = first + count - 1;
+        while (i <= j) {
+            if (centroids[primIndices[i]][axis] < splitPos) i++;
+            else std::swap(primIndices[i], primIndices[j--]);
+        }
+        int leftN = i - first;
+        if (leftN == 0 || leftN == count) return;
+        
+        int leftIndex = (int)nodes.size();
+        nodes.push_back({AABB(), first, leftN});
+        nodes.push_back({AABB(), i, count - leftN});
+        nodes[nodeIndex].leftFirst = leftIndex;
+        nodes[nodeIndex].count = 0;
+        subdivide(leftIndex, primBounds, maxLeafSize, level + 1);
+        subdivide(leftIndex + 1, primBounds, maxLeafSize, level + 1);
+    }
+};
+
+// Stack traversal depth-first. Paling banyak depth + 1 node menunggu
+// (satu saudara per level di atas node yang dibuka), jadi ukurannya
+// diambil dari kedalaman pohon: buffer lokal untuk pohon normal, heap
+// untuk pohon dalam (mesh degenerate membuat pohon hampir linear).
+class BVHStack {
+public:
+    explicit BVHStack(const BVH& bvh) : capacity(bvh.depth + 1) {
+        if (capacity > LOCAL_SIZE) {
+            heap.resize(capacity);
+            nodes = heap.data();
+        }
+    }
+    BVHStack(const BVHStack&) = delete;
+    BVHStack& operator=(const BVHStack&) = delete;
+    
+    bool empty() const { return size == 0; }
+    void push(int node) {
+        assert(size < capacity);
+        nodes[size++] = node;
+    }
+    int pop() { return nodes[--size]; }
+    
+private:
+    static const int LOCAL_SIZE = 64;
+    int local[LOCAL_SIZE];
+    int* nodes = local;
+    std::vector<int> heap;
+    int size = 0;
+    int capacity;
+};
+
+// =====================================================================
+// BVH SEGITIGA PER MESH (RUANG LOKAL)
+// =====================================================================
+// Dibangun sekali per mesh; objek yang berbagi mesh cukup mentransformasi
+// ray dengan invers matriks model, tanpa menghitung ulang bounds.
+class MeshBVH {
+public:
+    void build(const MeshVertices& vertices) {
+        size_t triCount = vertices.size() / 3;
+        std::vector<AABB> triBounds(triCount);
+        for (size_t i = 0; i < triCount; i++) {
+            triBounds[i].expand(vertices[i * 3].position);
+            triBounds[i].expand(vertices[i * 3 + 1].position);
+            triBounds[i].expand(vertices[i * 3 + 2].position);
+        }
+        bvh.build(triBounds);
+        
+        // Simpan posisi segitiga sesuai urutan leaf (akses memori berurutan)
+        positions.resize(triCount * 3);
+        triangleIds.resize(triCount);
+        for (size_t i = 0; i < triCount; i++) {
+            int tri = bvh.primIndices[i];
+            triangleIds[i] = tri;
+            positions[i * 3] = vertices[tri * 3].position;
+            positions[i * 3 + 1] = vertices[tri * 3 + 1].position;
+            positions[i * 3 + 2] = vertices[tri * 3 + 2].position;
+        }
+    }
+    
+    AABB bounds() const {
+        return bvh.nodes.empty() ? AABB() : bvh.nodes[0].bounds;
+    }
+    
+    // Ray dalam ruang lokal mesh. tHit berisi jarak terdekat saat ini dan
+    // hanya diperbarui jika ditemukan hit yang lebih dekat.
+    bool intersect(const Ray& ray, float& tHit, int& triangle) const {
+        if (bvh.nodes.empty()) return false;
+        glm::vec3 invDir = 1.0f / ray.direction;
+        bool hit = false;
+        
+        BVHStack stack(bvh);
+        stack.push(0);
+        while (!stack.empty()) {
+            const BVHNode& node = bvh.nodes[stack.pop()];
+            if (intersectRayAABB(ray.origin, invDir, node.bounds, tHit) >= tHit) continue;
+            
+            if (node.count > 0) {
+                for (int i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    float t;
+                    if (intersectRayTriangle(ray, positions[i * 3], positions[i * 3 + 1],
+                                             positions[i * 3 + 2], t) && t < tHit) {
+                        tHit = t;
+                        triangle = triangleIds[i];
+                        hit = true;
+                    }
+                }
+            } else {
+                // Kunjungi anak yang lebih dekat terlebih dahulu
+                int a = node.leftFirst, b = node.leftFirst + 1;
+                float ta = intersectRayAABB(ray.origin, invDir, bvh.nodes[a].bounds, tHit);
+                float tb = intersectRayAABB(ray.origin, invDir, bvh.nodes[b].bounds, tHit);
+                if (ta > tb) { std::swap(a, b); std::swap(ta, tb); }
+                if (tb < tHit) stack.push(b);
+                if (ta < tHit) stack.push(a);
+            }
+        }
+        return hit;
+    }
+    
+private:
+    BVH bvh;
+    std::vector<glm::vec3> positions;
+    std::vector<int> triangleIds;
+};
+
+// =====================================================================
+// PICKING OBJEK DENGAN RAY-CAST
+// =====================================================================
+struct PickHit {
+    Object3D* object = nullptr;
+    int instance = -1;      // Indeks instance dalam PickScene
+    int triangle = -1;      // Indeks segitiga dalam mesh objek
+    float distance = 0.0f;  // Jarak dari origin ray (world space)
+    glm::vec3 point = glm::vec3(0.0f);
+};
+
+struct PickInstance {
+    Object3D* object;
+    const MeshBVH* bvh;
+    glm::mat4 invModel;
+    AABB bounds;
+};
+
+class PickScene {
+public:
+    void clear() {
+        instances.clear();
+        topLevel = BVH();
+        objectInstances.clear();
+        looseInstances.clear();
+        builtInstances = 0;
+    }
+    
+    void addObject(Object3D& obj) {
+        objectInstances[&obj] = (int)instances.size();
+        addInstance(&obj, obj.getModelMatrix());
+    }
+    
+    // Edit inkremental: instance lama dinonaktifkan, instance baru diuji
+    // linear di luar BVH tingkat atas sampai daftarnya cukup panjang untuk
+    // membangun ulang BVH (tanpa instance nonaktif). Mesh yang diganti
+    // harus mengosongkan obj.bvh agar BVH segitiga dibangun ulang.
+    void updateObject(Object3D& obj) {
+        // Sudah di daftar lepas (diedit lagi): instance ditimpa di tempat
+        auto it = objectInstances.find(&obj);
+        if (it != objectInstances.end() && it->second >= (int)builtInstances) {
+            instances[it->second] = makeInstance(&obj, obj.getModelMatrix());
+            return;
+        }
+        removeObject(obj);
+        looseInstances.push_back((int)instances.size());
+        addObject(obj);
+        if (looseInstances.size() > MAX_LOOSE_INSTANCES) build();
+    }
+    
+    void removeObject(Object3D& obj) {
+        auto it = objectInstances.find(&obj);
+        if (it == objectInstances.end()) return;
+        instances[it->second].object = nullptr;
+        objectInstances.erase(it);
+    }
+    
+    // Tambah instance dengan matriks model sendiri (mesh boleh dipakai bersama)
+    void addInstance(Object3D* obj, const glm::mat4& model) {
+        instances.push_back(makeInstance(obj, model));
+    }
+    
+    // Bangun BVH tingkat atas dari bounding box dunia setiap instance
+    void build() {
+        compact();
+        std::vector<AABB> bounds(instances.size());
+        for (size_t i = 0; i < instances.size(); i++) bounds[i] = instances[i].bounds;
+        topLevel.build(bounds, 2);
+        builtInstances = instances.size();
+    }
+    
+    bool raycast(const Ray& ray, PickHit& hit, float maxDistance = 1000.0f) const {
+        if (topLevel.nodes.empty() && looseInstances.empty()) return false;
+        glm::vec3 invDir = 1.0f / ray.direction;
+        float tHit = maxDistance;
+        bool found = false;
+        
+        auto testInstance = [&](int instIndex) {
+            const PickInstance& inst = instances[instIndex];
+            if (!inst.object) return;
+            if (intersectRayAABB(ray.origin, invDir, inst.bounds, tHit) >= tHit) return;
+            
+            // Transformasi ray ke ruang lokal; arah tidak dinormalisasi
+            // agar parameter t tetap sama dengan jarak di world space
+            Ray local;
+            local.origin = glm::vec3(inst.invModel * glm::vec4(ray.origin, 1.0f));
+            local.direction = glm::vec3(inst.invModel * glm::vec4(ray.direction, 0.0f));
+            int triangle = -1;
+            if (inst.bvh->intersect(local, tHit, triangle)) {
+                hit.object = inst.object;
+                hit.instance = instIndex;
+                hit.triangle = triangle;
+                found = true;
+            }
+        };
+        for (int instIndex : looseInstances) testInstance(instIndex);
+        
+        BVHStack stack(topLevel);
+        if (!topLevel.nodes.empty()) stack.push(0);
+        while (!stack.empty()) {
+            const BVHNode& node = topLevel.nodes[stack.pop()];
+            if (intersectRayAABB(ray.origin, invDir, node.bounds, tHit) >= tHit) continue;
+            
+            if (node.count > 0) {
+                for (int i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    testInstance(topLevel.primIndices[i]);
+                }
+            } else {
+                int a = node.leftFirst, b = node.leftFirst + 1;
+                float ta = intersectRayAABB(ray.origin, invDir, topLevel.nodes[a].bounds, tHit);
+                float tb = intersectRayAABB(ray.origin, invDir, topLevel.nodes[b].bounds, tHit);
+                if (ta > tb) { std::swap(a, b); std::swap(ta, tb); }
+                if (tb < tHit) stack.push(b);
+                if (ta < tHit) stack.push(a);
+            }
+        }
+        
+        if (found) {
+            hit.distance = tHit;
+            hit.point = ray.origin + ray.direction * tHit;
+        }
+        return found;
+    }
+    
+    size_t instanceCount() const { return instances.size(); }
+    
+private:
+    static constexpr size_t MAX_LOOSE_INSTANCES = 256;
+    
+    std::vector<PickInstance> instances;
+    BVH topLevel;
+    std::unordered_map<const Object3D*, int> objectInstances;   // Instance dari addObject
+    std::vector<int> looseInstances;   // Instance hasil edit, belum masuk BVH
+    size_t builtInstances = 0;         // Instance [0, n) ada di BVH tingkat atas
+    
+    static PickInstance makeInstance(Object3D* obj, const glm::mat4& model) {
+        if (!obj->bvh) {
+            obj->bvh = std::make_shared<MeshBVH>();
+            obj->bvh->build(obj->vertices);
+        }
+        PickInstance inst;
+        inst.object = obj;
+        inst.bvh = obj->bvh.get();
+        inst.invModel = glm::inverse(model);
+        inst.bounds = obj->bvh->bounds().transformed(model);
+        return inst;
+    }
+    
+    // Buang instance nonaktif dan perbarui indeks milik objek
+    void compact() {
+        looseInstances.clear();
+        size_t out = 0;
+        std::vector<int> remap(instances.size(), -1);
+        for (size_t i = 0; i < instances.size(); i++) {
+            if (!instances[i].object) continue;
+            remap[i] = (int)out;
+            instances[out++] = instances[i];
+        }
+        if (out == instances.size()) return;
+        instances.resize(out);
+        for (auto& entry : objectInstances) entry.second = remap[entry.second];
+    }
+};
+
+// Ray dari posisi kursor (pixel, origin kiri atas) melalui projection/view
+Ray screenPointToRay(float x, float y, float width, float height,
+                     const glm::mat4& projection, const glm::mat4& view) {
+    float ndcX = 2.0f * x / width - 1.0f;
+    float ndcY = 1.0f - 2.0f * y / height;
+    glm::mat4 invViewProj = glm::inverse(projection * view);
+    glm::vec4 nearPoint = invViewProj * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+    glm::vec4 farPoint = invViewProj * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+    nearPoint /= nearPoint.w;
+    farPoint /= farPoint.w;
+    
+    Ray ray;
+    ray.origin = glm::vec3(nearPoint);
+    ray.direction = glm::normalize(glm::vec3(farPoint - nearPoint));
+    return ray;
+}
+
+// Scene picking aktif dan permintaan pick dari klik mouse
+PickScene* pickScene = nullptr;
+bool pickRequested = false;
+
+// Edit objek terpilih dari keyboard (diproses render loop, lihat SceneEditor)
+enum EditAction { EDIT_NONE, EDIT_MOVE, EDIT_ROTATE, EDIT_RECOLOR, EDIT_REPLACE, EDIT_DUPLICATE, EDIT_DELETE };
+EditAction editRequested = EDIT_NONE;
+glm::vec3 editOffset(0.0f);   // Geseran untuk EDIT_MOVE
+
+// =====================================================================
+// FRUSTUM KAMERA (UNTUK CULLING)
+// =====================================================================
+enum FrustumResult { FRUSTUM_OUTSIDE, FRUSTUM_INTERSECT, FRUSTUM_INSIDE };
+
+struct Frustum {
+    glm::vec4 planes[6];    // ax + by + cz + d >= 0 berarti di dalam
+    
+    // Ekstraksi bidang dari matriks projection * view (Gribb-Hartmann)
+    void extract(const glm::mat4& viewProj) {
+        glm::mat4 m = glm::transpose(viewProj);
+        planes[0] = m[3] + m[0];    // Kiri
+        planes[1] = m[3] - m[0];    // Kanan
+        planes[2] = m[3] + m[1];    // Bawah
+        planes[3] = m[3] - m[1];    // Atas
+        planes[4] = m[3] + m[2];    // Dekat
+        planes[5] = m[3] - m[2];    // Jauh
+        for (auto& p : planes) p /= glm::length(glm::vec3(p));
+    }
+    
+    FrustumResult testAABB(const AABB& box) const {
+        FrustumResult result = FRUSTUM_INSIDE;
+        for (const auto& p : planes) {
+            glm::vec3 n(p);
+            // Sudut kotak terjauh (positif) dan terdekat (negatif) terhadap normal
+            glm::vec3 pos(n.x >= 0 ? box.max.x : box.min.x,
+                          n.y >= 0 ? box.max.y : box.min.y,
+                          n.z >= 0 ? box.max.z : box.min.z);
+            glm::vec3 neg(n.x >= 0 ? box.min.x : box.max.x,
+                          n.y >= 0 ? box.min.y : box.max.y,
+                          n.z >= 0 ? box.min.z : box.max.z);
+            if (glm::dot(n, pos) + p.w < 0.0f) return FRUSTUM_OUTSIDE;
+            if (glm::dot(n, neg) + p.w < 0.0f) result = FRUSTUM_INTERSECT;
+        }
+        return result;
+    }
+};
+
+// Statistik culling per query (node dan objek)
+struct CullStats {
+    int nodesVisited = 0;
+    int nodesCulled = 0;
+    int nodesFullyInside = 0;   // Node diterima tanpa tes per objek
+    int objectsTested = 0;
+    int objectsVisible = 0;
+    
+    void reset() { *this = CullStats(); }
+};
+
+// =====================================================================
+// LOOSE OCTREE UNTUK OBJEK DINAMIS
+// =====================================================================
+// Setiap node punya bounds "longgar" dua kali ukuran cell-nya, sehingga
+// objek cukup disimpan di node yang memuat pusatnya pada kedalaman yang
+// sesuai ukurannya. Objek yang bergerak hanya dipindah (reinsert) jika
+// bounding box-nya keluar dari bounds longgar node tersebut; selain itu
+// update cukup mengganti bounds yang tersimpan (O(1)).
+class LooseOctree {
+public:
+    // Statistik update kumulatif
+    int movesInPlace = 0;
+    int reinsertions = 0;
+    
+    void init(glm::vec3 center, float halfSize, int maxDepth = 8, float looseness = 2.0f) {
+        nodes.clear();
+        items.clear();
+        freeItems.clear();
+        this->maxDepth = maxDepth;
+        this->looseness = looseness;
+        nodes.push_back(makeNode(center, halfSize, 0, -1));
+    }
+    
+    int insert(Object3D* obj) {
+        int handle;
+        if (!freeItems.empty()) {
+            handle = freeItems.back();
+            freeItems.pop_back();
+        } else {
+            handle = (int)items.size();
+            items.push_back(Item());
+        }
+        Item& item = items[handle];
+        item.object = obj;
+        item.localBounds = obj->getLocalBounds();
+        item.bounds = item.localBounds.transformed(obj->getModelMatrix());
+        storeTransform(item);
+        placeItem(handle);
+        return handle;
+    }
+    
+    void remove(int handle) {
+        unlinkItem(handle);
+        items[handle].object = nullptr;
+        freeItems.push_back(handle);
+    }
+    
+    // Panggil setiap frame; murah jika transformasi tidak berubah
+    void update(int handle) {
+        Item& item = items[handle];
+        const Object3D* obj = item.object;
+        if (obj->position == item.position && obj->rotation == item.rotation &&
+            obj->scale == item.scale) return;
+        
+        storeTransform(item);
+        item.bounds = item.localBounds.transformed(obj->getModelMatrix());
+        const Node& node = nodes[item.node];
+        if (item.node != 0 && fitsLoose(node, item.bounds) && fitsDepth(node, item.bounds)) {
+            movesInPlace++;
+            return;
+        }
+        unlinkItem(handle);
+        placeItem(handle);
+        reinsertions++;
+    }
+    
+    void queryFrustum(const Frustum& frustum, std::vector<Object3D*>& out, CullStats& stats) const {
+        queryNode(0, out, stats, [&](const AABB& b) { return frustum.testAABB(b); });
+    }
+    
+    void queryAABB(const AABB& box, std::vector<Object3D*>& out, CullStats& stats) const {
+        queryNode(0, out, stats, [&](const AABB& b) {
+            if (!b.overlaps(box)) return FRUSTUM_OUTSIDE;
+            bool inside = glm::all(glm::greaterThanEqual(b.min, box.min)) &&
+                          glm::all(glm::lessThanEqual(b.max, box.max));
+            return inside ? FRUSTUM_INSIDE : FRUSTUM_INTERSECT;
+        });
+    }
+    
+    void queryRadius(glm::vec3 center, float radius, std::vector<Object3D*>& out, CullStats& stats) const {
+        float r2 = radius * radius;
+        queryNode(0, out, stats, [&](const AABB& b) {
+            glm::vec3 d = glm::clamp(center, b.min, b.max) - center;
+            if (glm::dot(d, d) > r2) return FRUSTUM_OUTSIDE;
+            // Kotak di dalam bola jika sudut terjauhnya di dalam bola
+            glm::vec3 far = glm::max(glm::abs(b.min - center), glm::abs(b.max - center));
+            return glm::dot(far, far) <= r2 ? FRUSTUM_INSIDE : FRUSTUM_INTERSECT;
+        });
+    }
+    
+    size_t nodeCount() const { return nodes.size(); }
+    
+    // Bertambah setiap kali ada objek yang bergerak
+    int moveCount() const { return movesInPlace + reinsertions; }
+    
+private:
+    struct Node {
+        glm::vec3 center;
+        float halfSize;
+        AABB looseBounds;
+        int depth;
+        int parent;
+        int children[8];
+        int subtreeItems;           // Jumlah objek di node ini dan turunannya
+        std::vector<int> items;
+    };
+    
+    struct Item {
+        Object3D* object = nullptr;
+        AABB localBounds;           // Disimpan agar update tidak membaca vertex
+        AABB bounds;
+        glm::vec3 position, rotation, scale;
+        int node = -1;
+        int slot = -1;              // Posisi dalam Node::items
+    };
+    
+    std::vector<Node> nodes;
+    std::vector<Item> items;
+    std::vector<int> freeItems;
+    int maxDepth = 8;
+    float looseness = 2.0f;
+    
+    Node makeNode(glm::vec3 center, float halfSize, int depth, int parent) const {
+        Node n;
+        n.center = center;
+        n.halfSize = halfSize;
+        n.looseBounds = AABB(center - glm::vec3(halfSize * looseness),
+                             center + glm::vec3(halfSize * looseness));
+        n.depth = depth;
+        n.parent = parent;
+        n.subtreeItems = 0;
+        for (int& c : n.children) c = -1;
+        return n;
+    }
+    
+    static void storeTransform(Item& item) {
+        item.position = item.object->position;
+        item.rotation = item.object->rotation;
+        item.scale = item.object->scale;
+    }
+    
+    bool fitsLoose(const Node& node, const AABB& b) const {
+        return glm::all(glm::greaterThanEqual(b.min, node.looseBounds.min)) &&
+               glm::all(glm::lessThanEqual(b.max, node.looseBounds.max));
+    }
+    
+    // Objek tidak boleh jauh lebih kecil dari cell (agar turun ke anak)
+    bool fitsDepth(const Node& node, const AABB& b) const {
+        float radius = glm::length(b.max - b.min) * 0.5f;
+        return node.depth == maxDepth || radius > node.halfSize * 0.5f;
+    }
+    
+    void placeItem(int handle) {
+        Item& item = items[handle];
+        glm::vec3 center = (item.bounds.min + item.bounds.max) * 0.5f;
+        float radius = glm::length(item.bounds.max - item.bounds.min) * 0.5f;
+        
+        // Turun ke anak yang memuat pusat selama objek masih muat di
+        // bounds longgar anak tersebut
+        int nodeIndex = 0;
+        if (fitsLoose(nodes[0], item.bounds)) {
+            while (nodes[nodeIndex].depth < maxDepth) {
+                float childHalf = nodes[nodeIndex].halfSize * 0.5f;
+                if (radius > childHalf) break;
+                glm::vec3 c = nodes[nodeIndex].center;
+                int octant = (center.x >= c.x ? 1 : 0) | (center.y >= c.y ? 2 : 0) |
+                             (center.z >= c.z ? 4 : 0);
+                int child = nodes[nodeIndex].children[octant];
+                if (child < 0) {
+                    glm::vec3 offset((octant & 1) ? childHalf : -childHalf,
+                                     (octant & 2) ? childHalf : -childHalf,
+                                     (octant & 4) ? childHalf : -childHalf);
+                    child = (int)nodes.size();
+                    nodes.push_back(makeNode(c + offset, childHalf,
+                                             nodes[nodeIndex].depth + 1, nodeIndex));
+                    nodes[nodeIndex].children[octant] = child;
+                }
+                nodeIndex = child;
+            }
+        }
+        
+        Node& node = nodes[nodeIndex];
+        item.node = nodeIndex;
+        item.slot = (int)node.items.size();
+        node.items.push_back(handle);
+        for (int n = nodeIndex; n >= 0; n = nodes[n].parent) nodes[n].subtreeItems++;
+    }
+    
+    void unlinkItem(int handle) {
+        Item& item = items[handle];
+        Node& node = nodes[item.node];
+        int last = node.items.back();
+        node.items[item.slot] = last;
+        items[last].slot = item.slot;
+        node.items.pop_back();
+        for (int n = item.node; n >= 0; n = nodes[n].parent) nodes[n].subtreeItems--;
+        item.node = -1;
+        item.slot = -1;
+    }
+    
+    template <typename TestFn>
+    void queryNode(int nodeIndex, std::vector<Object3D*>& out, CullStats& stats,
+                   const TestFn& test, bool fullyInside = false) const {
+        const Node& node = nodes[nodeIndex];
+        if (node.subtreeItems == 0) return;
+        stats.nodesVisited++;
+        
+        if (!fullyInside) {
+            FrustumResult r = test(node.looseBounds);
+            if (r == FRUSTUM_OUTSIDE) {
+                stats.nodesCulled++;
+                return;
+            }
+            if (r == FRUSTUM_INSIDE) {
+                fullyInside = true;
+                stats.nodesFullyInside++;
+            }
+        }
+        
+        for (int handle : node.items) {
+            if (!fullyInside) {
+                stats.objectsTested++;
+                if (test(items[handle].bounds) == FRUSTUM_OUTSIDE) continue;
+            }
+            out.push_back(items[handle].object);
+            stats.objectsVisible++;
+        }
+        for (int child : node.children) {
+            if (child >= 0) queryNode(child, out, stats, test, fullyInside);
+        }
+    }
+};
+
+// =====================================================================
+// INDEKS SCENE: BVH STATIS + LOOSE OCTREE DINAMIS
+// =====================================================================
+// Dinding, lantai, dan perabot tetap disimpan dalam BVH statis (dibangun
+// sekali), sedangkan objek dengan isDynamic = true (pintu, kursi) berada
+// di loose octree yang diperbarui secara inkremental setiap frame.
+class SceneIndex {
+public:
+    LooseOctree dynamicTree;
+    CullStats lastStats;
+    
+    void build(std::vector<Object3D>& objects) {
+        AABB sceneBounds;
+        std::vector<AABB> staticBounds;
+        staticObjects.clear();
+        staticSlots.clear();
+        dynamicObjects.clear();
+        for (auto& obj : objects) {
+            if (obj.vertices.empty()) continue;   // Dihapus lewat SceneEditor
+            AABB b = obj.getWorldBounds();
+            sceneBounds.expand(b.min);
+            sceneBounds.expand(b.max);
+            if (obj.isDynamic) {
+                dynamicObjects.push_back(&obj);
+            } else {
+                staticSlots[&obj] = (int)staticObjects.size();
+                staticObjects.push_back(&obj);
+                staticBounds.push_back(b);
+            }
+        }
+        staticBVH.build(staticBounds, 2);
+        staticObjectBounds = staticBounds;
+        
+        initDynamicTree(sceneBounds);
+        for (auto* obj : dynamicObjects) {
+            int handle = dynamicTree.insert(obj);
+            dynamicHandles.push_back(handle);
+            treeHandles[obj] = handle;
+        }
+    }
+    
+    // Loading bertahap: BVH statis dikosongkan dan setiap objek yang selesai
+    // di-upload masuk loose octree (insert murah, tanpa build ulang). build()
+    // setelah loading selesai memindahkan objek statis ke BVH.
+    void beginStreaming(const AABB& sceneBounds) {
+        staticObjects.clear();
+        staticObjectBounds.clear();
+        staticSlots.clear();
+        dynamicObjects.clear();
+        staticBVH = BVH();
+        initDynamicTree(sceneBounds);
+    }
+    
+    void addStreamed(Object3D& obj) {
+        int handle = dynamicTree.insert(&obj);
+        if (obj.isDynamic) dynamicHandles.push_back(handle);
+        treeHandles[&obj] = handle;
+    }
+    
+    // Edit inkremental (SceneEditor). Objek statis yang diedit keluar dari
+    // BVH (slotnya dikosongkan) dan pindah ke loose octree, sehingga BVH
+    // tidak perlu dibangun ulang. Objek di octree dimasukkan ulang agar
+    // bounds lokal (mesh diganti) ikut diperbarui.
+    void updateObject(Object3D& obj) {
+        auto it = treeHandles.find(&obj);
+        if (it == treeHandles.end()) {
+            detachStatic(obj);
+            treeHandles[&obj] = dynamicTree.insert(&obj);
+            return;
+        }
+        // Slot yang baru dilepas langsung dipakai lagi: handle tetap sama
+        dynamicTree.remove(it->second);
+        it->second = dynamicTree.insert(&obj);
+    }
+    
+    void addObject(Object3D& obj) {
+        int handle = dynamicTree.insert(&obj);
+        if (obj.isDynamic) dynamicHandles.push_back(handle);
+        treeHandles[&obj] = handle;
+    }
+    
+    void removeObject(Object3D& obj) {
+        auto it = treeHandles.find(&obj);
+        if (it == treeHandles.end()) {
+            detachStatic(obj);
+            return;
+        }
+        dynamicTree.remove(it->second);
+        dynamicHandles.erase(std::remove(dynamicHandles.begin(), dynamicHandles.end(), it->second),
+                             dynamicHandles.end());
+        treeHandles.erase(it);
+    }
+    
+    void updateDynamic() {
+        for (int handle : dynamicHandles) dynamicTree.update(handle);
+    }
+    
+    void queryFrustum(const Frustum& frustum, std::vector<Object3D*>& out) {
+        out.clear();
+        lastStats.reset();
+        if (!staticBVH.nodes.empty()) queryStatic(0, frustum, out, false);
+        dynamicTree.queryFrustum(frustum, out, lastStats);
+    }
+    
+private:
+    BVH staticBVH;
+    std::vector<Object3D*> staticObjects;
+    std::vector<AABB> staticObjectBounds;
+    std::unordered_map<const Object3D*, int> staticSlots;   // Objek -> slot di staticObjects
+    std::vector<Object3D*> dynamicObjects;
+    std::vector<int> dynamicHandles;
+    std::unordered_map<const Object3D*, int> treeHandles;   // Semua objek di loose octree
+    
+    void initDynamicTree(const AABB& sceneBounds) {
+        dynamicHandles.clear();
+        treeHandles.clear();
+        glm::vec3 center = (sceneBounds.min + sceneBounds.max) * 0.5f;
+        glm::vec3 size = sceneBounds.max - sceneBounds.min;
+        float halfSize = std::max(size.x, std::max(size.y, size.z)) * 0.5f + 1.0f;
+        if (sceneBounds.min.x > sceneBounds.max.x) { center = glm::vec3(0.0f); halfSize = 1.0f; }   // Kosong
+        dynamicTree.init(center, halfSize);
+    }
+    
+    void detachStatic(const Object3D& obj) {
+        auto it = staticSlots.find(&obj);
+        if (it == staticSlots.end()) return;
+        staticObjects[it->second] = nullptr;
+        staticSlots.erase(it);
+    }
+    
+    void queryStatic(int nodeIndex, const Frustum& frustum, std::vector<Object3D*>& out,
+                     bool fullyInside) {
+        const BVHNode& node = staticBVH.nodes[nodeIndex];
+        lastStats.nodesVisited++;
+        if (!fullyInside) {
+            FrustumResult r = frustum.testAABB(node.bounds);
+            if (r == FRUSTUM_OUTSIDE) { lastStats.nodesCulled++; return; }
+            if (r == FRUSTUM_INSIDE) { fullyInside = true; lastStats.nodesFullyInside++; }
+        }
+        if (node.count > 0) {
+            for (int i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                int idx = staticBVH.primIndices[i];
+                if (!staticObjects[idx]) continue;   // Pindah ke octree (diedit)
+                if (!fullyInside) {
+                    lastStats.objectsTested++;
+                    if (frustum.testAABB(staticObjectBounds[idx]) == FRUSTUM_OUTSIDE) continue;
+                }
+                out.push_back(staticObjects[idx]);
+                lastStats.objectsVisible++;
+            }
+        } else {
+            queryStatic(node.leftFirst, frustum, out, fullyInside);
+            queryStatic(node.leftFirst + 1, frustum, out, fullyInside);
+        }
+    }
+};
+
+// =====================================================================
+// DRAW LIST: FRUSTUM CULLING + CULLING FITUR KECIL DALAM SATU PASS
+// =====================================================================
+// Ambang ukuran layer detail di layar (pixel, radius proyeksi). 0 = off.
+float detailPixelThreshold = 1.0f;
+
+struct DrawItem {
+    Object3D* object;
+    const DrawRange* range;     // nullptr: gambar seluruh mesh
+    glm::mat4 model;
+    bool mirrored;              // Skala negatif membalik winding
+};
+
+struct DrawList {
+    std::vector<DrawItem> culled;       // Digambar dengan back-face culling
+    std::vector<DrawItem> twoSided;     // Digambar tanpa culling
+    int drawnTriangles = 0;
+    int skippedDetailTriangles = 0;
+    
+    void clear() {
+        culled.clear();
+        twoSided.clear();
+        drawnTriangles = 0;
+        skippedDetailTriangles = 0;
+    }
+};
+
+// Query frustum lalu, dalam pass yang sama, hitung matriks model sekali
+// per objek dan uji setiap layer detail terhadap ambang pixel.
+void buildDrawList(SceneIndex& index, const glm::mat4& projection, const glm::mat4& view,
+                   glm::vec3 eye, float fovDegrees, float viewportHeight,
+                   std::vector<Object3D*>& visible, DrawList& list) {
+    Frustum frustum;
+    frustum.extract(projection * view);
+    index.queryFrustum(frustum, visible);
+    list.clear();
+    
+    // Faktor konversi radius dunia -> pixel pada jarak 1
+    float pixelsPerUnit = viewportHeight * 0.5f / std::tan(glm::radians(fovDegrees) * 0.5f);
+    
+    for (Object3D* obj : visible) {
+        glm::mat4 model = obj->getModelMatrix();
+        glm::mat3 linear(model);
+        bool mirrored = glm::determinant(linear) < 0.0f;
+        
+        if (obj->drawRanges.empty()) {
+            list.twoSided.push_back({obj, nullptr, model, mirrored});
+            list.drawnTriangles += (int)obj->vertices.size() / 3;
+            continue;
+        }
+        
+        float maxScale = std::max(glm::length(linear[0]),
+                                  std::max(glm::length(linear[1]), glm::length(linear[2])));
+        int lastPart = -2;
+        bool partVisible = true;
+        for (const DrawRange& range : obj->drawRanges) {
+            if (range.detailPart != lastPart) {
+                lastPart = range.detailPart;
+                partVisible = true;
+                if (range.detailPart >= 0 && detailPixelThreshold > 0.0f) {
+                    const DetailPart& part = obj->detailParts[range.detailPart];
+                    glm::vec3 center = glm::vec3(model * glm::vec4(part.center, 1.0f));
+                    float distance = glm::length(center - eye) - part.radius * maxScale;
+                    distance = std::max(distance, 0.1f);
+                    float pixels = part.featureRadius * maxScale * pixelsPerUnit / distance;
+                    partVisible = pixels >= detailPixelThreshold;
+                }
+            }
+            if (!partVisible) {
+                list.skippedDetailTriangles += range.count / 3;
+                continue;
+            }
+            DrawItem item = {obj, &range, model, mirrored};
+            if (range.twoSided) list.twoSided.push_back(item);
+            else list.culled.push_back(item);
+            list.drawnTriangles += range.count / 3;
+        }
+    }
+}
+
+// Gambar satu daftar item; VAO dan uniform model hanya diganti saat objek berganti
+void drawItems(const std::vector<DrawItem>& items, int modelLocation) {
+    const Object3D* current = nullptr;
+    for (const DrawItem& item : items) {
+        if (item.object != current) {
+            current = item.object;
+            glBindVertexArray(item.object->VAO);
+            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(item.model));
+            glFrontFace(item.mirrored ? GL_CW : GL_CCW);
+        }
+        if (item.range) glDrawArrays(GL_TRIANGLES, item.range->first, item.range->count);
+        else glDrawArrays(GL_TRIANGLES, 0, item.object->vertices.size());
+    }
+    glFrontFace(GL_CCW);
+    glBindVertexArray(0);
+}
+
+// =====================================================================
+// SUMBER SHADER: EMBEDDED ATAU FOLDER OVERRIDE (MEMORY-MAPPED)
+// =====================================================================
+// Build CMake meng-embed semua file shaders/ ke executable (lihat
+// cmake/EmbedShaders.cmake), sehingga produksi tidak membaca file sama
+// sekali. Untuk pengembangan, --shader-dir <folder> mendahulukan file di
+// folder tersebut; file di-mmap (bukan disalin lewat stream) dan tetap
+// ter-map selama program berjalan, sehingga source dikembalikan sebagai
+// std::string_view tanpa salinan.
+std::string shaderOverrideDir;   // --shader-dir
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+    
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(file, &fileSize);
+        size = (size_t)fileSize.QuadPart;
+        if (size > 0) {
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (mapping) {
+                data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        size = fstat(fd, &info) == 0 ? (size_t)info.st_size : 0;
+        if (size > 0) {
+            void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            data = mapped == MAP_FAILED ? nullptr : (const char*)mapped;
+        }
+        ::close(fd);
+#endif
+        if (size > 0 && !data) {
+            size = 0;
+            return false;
+        }
+        return true;
+    }
+    
+    std::string_view view() const { return std::string_view(data ? data : "", size); }
+    
+    void close() {
+        if (data) {
+#ifdef _WIN32
+            UnmapViewOfFile(data);
+#else
+            munmap((void*)data, size);
+#endif
+        }
+        data = nullptr;
+        size = 0;
+    }
+    
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+// View file yang di-map (file tetap ter-map sampai program selesai)
+bool mapShaderFile(const std::string& path, std::string_view& source) {
+    static std::map<std::string, std::unique_ptr<MappedFile>> mappedFiles;
+    auto it = mappedFiles.find(path);
+    if (it == mappedFiles.end()) {
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        if (!file->open(path)) return false;
+        it = mappedFiles.emplace(path, std::move(file)).first;
+    }
+    source = it->second->view();
+    return true;
+}
+
+// =====================================================================
+// CACHE BINARY PROGRAM SHADER (GL_ARB_get_program_binary)
+// =====================================================================
+// Program yang berhasil di-link disimpan sebagai binary driver di
+// cache/shaders/. Kunci = hash source (termasuk #define varian) dan string
+// vendor/renderer/versi driver, sehingga ganti driver otomatis memakai
+// file baru. Binary yang ditolak driver (format/versi berbeda) jatuh
+// kembali ke compile dari source. glad hanya memuat GL 3.3 core, jadi
+// fungsi ekstensi dimuat sendiri lewat glfwGetProcAddress.
+
+// Hash FNV-1a untuk kunci cache (program shader, bake)
+struct SceneHasher {
+    uint64_t value = 1469598103934665603ull;
+    
+    void mix(const void* data, size_t bytes) {
+        const unsigned char* p = (const unsigned char*)data;
+        for (size_t i = 0; i < bytes; i++) {
+            value ^= p[i];
+            value *= 1099511628211ull;
+        }
+    }
+    
+    // Geometri dan transform semua objek statis. Blok vertex yang dipakai
+    // bersama banyak instance di-hash sekali; instance berikutnya cukup
+    // mencampur nomor urut blok (bukan alamat, agar hash stabil antar run).
+    void mixStaticObjects(const std::vector<Object3D>& objects) {
+        std::unordered_map<const Vertex*, uint32_t> blocks;
+        for (const Object3D& obj : objects) {
+            if (obj.isDynamic) continue;
+            glm::mat4 model = obj.getModelMatrix();
+            mix(&model, sizeof(model));
+            mix(&obj.castsShadow, sizeof(obj.castsShadow));
+            uint32_t block = (uint32_t)blocks.size();
+            auto found = blocks.emplace(obj.vertices.data(), block);
+            block = found.first->second;
+            mix(&block, sizeof(block));
+            if (found.second) mix(obj.vertices.data(), obj.vertices.size() * sizeof(Vertex));
+        }
+    }
+};
+
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+
+typedef void (APIENTRYP PFNGETPROGRAMBINARY)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+typedef void (APIENTRYP PFNPROGRAMBINARY)(GLuint, GLenum, const void*, GLsizei);
+typedef void (APIENTRYP PFNPROGRAMPARAMETERI)(GLuint, GLenum, GLint);
+
+bool shaderCacheEnabled = true;   // --no-shader-cache
+
+class ProgramBinaryCache {
+public:
+    int hits = 0;
+    bool lastWasHit = false;
+    
+    // Dipanggil sekali setelah context GL aktif
+    void init(const std::string& directory = "cache/shaders") {
+        dir = directory;
+        available = false;
+        if (!shaderCacheEnabled || !glfwExtensionSupported("GL_ARB_get_program_binary")) return;
+        getProgramBinary = (PFNGETPROGRAMBINARY)glfwGetProcAddress("glGetProgramBinary");
+        programBinary = (PFNPROGRAMBINARY)glfwGetProcAddress("glProgramBinary");
+        programParameteri = (PFNPROGRAMPARAMETERI)glfwGetProcAddress("glProgramParameteri");
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        available = getProgramBinary && programBinary && programParameteri && formats > 0;
+        
+        const char* strings[3] = {(const char*)glGetString(GL_VENDOR), (const char*)glGetString(GL_RENDERER),
+                                  (const char*)glGetString(GL_VERSION)};
+        driver.clear();
+        for (const char* s : strings) driver += std::string(s ? s : "") + "|";
+        std::error_code error;
+        if (available) std::filesystem::create_directories(dir, error);
+    }
+    
+    bool isAvailable() const { return available; }
+    
+    uint64_t key(std::string_view vertexCode, std::string_view fragmentCode,
+                 std::string_view geometryCode) const {
+        SceneHasher hash;
+        std::string_view parts[4] = {driver, vertexCode, fragmentCode, geometryCode};
+        for (std::string_view part : parts) {
+            uint64_t size = part.size();
+            hash.mix(&size, sizeof(size));
+            hash.mix(part.data(), part.size());
+        }
+        return hash.value;
+    }
+    
+    // Program dari binary cache, atau 0 jika tidak ada / ditolak driver
+    unsigned int load(uint64_t programKey) {
+        lastWasHit = false;
+        if (!available) return 0;
+        std::ifstream file(path(programKey), std::ios::binary);
+        if (!file) return 0;
+        char magic[4];
+        GLenum format = 0;
+        uint32_t length = 0;
+        file.read(magic, 4);
+        file.read((char*)&format, sizeof(format));
+        file.read((char*)&length, sizeof(length));
+        if (!file || std::memcmp(magic, "PBIN", 4) != 0) return 0;
+        std::vector<char> binary(length);
+        file.read(binary.data(), length);
+        if (!file) return 0;
+        
+        unsigned int program = glCreateProgram();
+        programBinary(program, format, binary.data(), (GLsizei)length);
+        GLint linked = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            glDeleteProgram(program);
+            return 0;
+        }
+        hits++;
+        lastWasHit = true;
+        return program;
+    }
+    
+    // Sebelum link: minta driver menyimpan binary yang bisa diambil
+    void prepare(unsigned int program) const {
+        if (available) programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    
+    // Setelah link berhasil
+    void store(uint64_t programKey, unsigned int program) {
+        if (!available) return;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0) return;
+        std::vector<char> binary(length);
+        GLenum format = 0;
+        getProgramBinary(program, length, nullptr, &format, binary.data());
+        
+        std::ofstream file(path(programKey), std::ios::binary);
+        if (!file) {
+            std::cerr << "WARNING::SHADER_CACHE::NOT_WRITTEN " << path(programKey) << std::endl;
+            return;
+        }
+        uint32_t size = (uint32_t)length;
+        file.write("PBIN", 4);
+        file.write((const char*)&format, sizeof(format));
+        file.write((const char*)&size, sizeof(size));
+        file.write(binary.data(), length);
+    }
+    
+private:
+    bool available = false;
+    std::string dir;
+    std::string driver;
+    PFNGETPROGRAMBINARY getProgramBinary = nullptr;
+    PFNPROGRAMBINARY programBinary = nullptr;
+    PFNPROGRAMPARAMETERI programParameteri = nullptr;
+    
+    std::string path(uint64_t programKey) const {
+        char name[64];
+        std::snprintf(name, sizeof(name), "/prog_%016llx.bin", (unsigned long long)programKey);
+        return dir + name;
+    }
+};
+
+ProgramBinaryCache& programBinaryCache() {
+    static ProgramBinaryCache cache;
+    return cache;
+}
+
+// =====================================================================
+// PREPROCESSOR #include SHADER
+// =====================================================================
+// Baris #include "file" diganti isi file (relatif terhadap folder file yang
+// meng-include), dicari lewat readShaderFile sehingga berlaku untuk shader
+// embedded maupun folder override. Setiap file hanya disisipkan sekali per
+// program (seperti #pragma once). Ekspansi tidak memahami #ifdef: include
+// selalu disisipkan, fitur dipilih di dalam file yang di-include.
+//
+// Setiap file mendapat nomor source-string tetap dan diberi #line, sehingga
+// log error driver ("3:12(5): error ...") bisa diterjemahkan kembali ke
+// path file aslinya. Hasil ekspansi di-cache per hash isi file utama: semua
+// varian #define dari satu shader memakai satu ekspansi yang sama.
+class ShaderPreprocessor {
+public:
+    int expansions = 0;   // File utama yang benar-benar diekspansi
+    int cacheHits = 0;
+    
+    std::string_view expand(const char* path) {
+        std::string_view source = readShaderFile(path);
+        SceneHasher hash;
+        hash.mix(path, std::strlen(path));
+        hash.mix(source.data(), source.size());
+        auto it = cache.find(hash.value);
+        if (it != cache.end()) {
+            cacheHits++;
+            return it->second;
+        }
+        
+        std::string output;
+        std::set<std::string> included;
+        included.insert(path);
+        expandFile(path, source, true, included, output);
+        expansions++;
+        return cache.emplace(hash.value, std::move(output)).first->second;
+    }
+    
+    // Ganti nomor source-string di awal tiap baris log dengan path file
+    std::string describeLog(const char* log) const {
+        std::string result;
+        std::string_view text(log);
+        while (!text.empty()) {
+            size_t end = text.find('\n');
+            std::string_view line = text.substr(0, end);
+            text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+            
+            // Format umum: "0:12(5): ..." (Mesa), "0(12) : ..." (NVIDIA),
+            // "ERROR: 0:12: ..." (AMD/Intel)
+            size_t start = line.compare(0, 7, "ERROR: ") == 0 ? 7 :
+                           line.compare(0, 9, "WARNING: ") == 0 ? 9 : 0;
+            size_t digits = start;
+            while (digits < line.size() && std::isdigit((unsigned char)line[digits])) digits++;
+            size_t index = digits > start ? std::stoul(std::string(line.substr(start, digits - start))) : 0;
+            if (index > 0 && index <= files.size() && digits < line.size() &&
+                (line[digits] == ':' || line[digits] == '(')) {
+                result.append(line.substr(0, start));
+                result += files[index - 1];
+                result.append(line.substr(digits));
+            } else {
+                result.append(line);
+            }
+            result += '\n';
+        }
+        return result;
+    }
+    
+private:
+    std::map<uint64_t, std::string> cache;
+    std::vector<std::string> files;               // Nomor source-string - 1
+    std::map<std::string, int> fileNumbers;
+    
+    // Nomor 0 tidak dipakai agar source tanpa #line (pass post) tidak tertukar
+    int fileNumber(const std::string& path) {
+        auto it = fileNumbers.find(path);
+        if (it != fileNumbers.end()) return it->second;
+        files.push_back(path);
+        return fileNumbers[path] = (int)files.size();
+    }
+    
+    void expandFile(const std::string& path, std::string_view source, bool root,
+                    std::set<std::string>& included, std::string& output) {
+        std::string number = std::to_string(fileNumber(path));
+        std::string directory = path.substr(0, path.find_last_of('/') + 1);
+        // #line tidak boleh mendahului #version: file utama diberi #line
+        // setelah baris #version, file include langsung di baris pertama
+        if (!root || source.find("#version") == std::string_view::npos) {
+            output += "#line 1 " + number + "\n";
+        }
+        
+        int lineNumber = 0;
+        while (!source.empty()) {
+            size_t end = source.find('\n');
+            std::string_view line = source.substr(0, end);
+            source = end == std::string_view::npos ? std::string_view() : source.substr(end + 1);
+            lineNumber++;
+            
+            size_t first = line.find_first_not_of(" \t");
+            std::string_view directive = first == std::string_view::npos ? std::string_view() : line.substr(first);
+            if (directive.compare(0, 8, "#version") == 0) {
+                output.append(line);
+                output += "\n#line " + std::to_string(lineNumber + 1) + " " + number + "\n";
+                continue;
+            }
+            if (directive.compare(0, 8, "#include") != 0) {
+                output.append(line);
+                output += '\n';
+                continue;
+            }
+            
+            size_t open = directive.find('"');
+            size_t close = open == std::string_view::npos ? open : directive.find('"', open + 1);
+            if (close == std::string_view::npos) {
+                std::cerr << "ERROR: Invalid #include in " << path << ":" << lineNumber << std::endl;
+                output += '\n';
+                continue;
+            }
+            std::string includePath = directory + std::string(directive.substr(open + 1, close - open - 1));
+            // Sudah disisipkan: baris kosong agar nomor baris tetap sama
+            if (!included.insert(includePath).second) {
+                output += '\n';
+                continue;
+            }
+            std::string_view includeSource = readShaderFile(includePath.c_str());
+            if (includeSource.empty()) {
+                std::cerr << "ERROR: Shader include not found: " << includePath
+                          << " (" << path << ":" << lineNumber << ")" << std::endl;
+            }
+            expandFile(includePath, includeSource, false, included, output);
+            output += "#line " + std::to_string(lineNumber + 1) + " " + number + "\n";
+        }
+    }
+};
+
+ShaderPreprocessor& shaderPreprocessor() {
+    static ShaderPreprocessor preprocessor;
+    return preprocessor;
+}
+
+// =====================================================================
+// COMPILE SHADER BATCH (PARALEL, STATUS DIPERIKSA SAAT DIPAKAI)
+// =====================================================================
+// submit() langsung mengirim compile semua stage dan link program tanpa
+// menanyakan status, sehingga driver bebas mengerjakannya di belakang
+// (paralel jika GL_KHR/ARB_parallel_shader_compile tersedia). Status
+// compile/link, log error, dan penyimpanan binary cache baru dikerjakan
+// finish() saat program pertama kali dibutuhkan.
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+
+typedef void (APIENTRYP PFNMAXSHADERCOMPILERTHREADS)(GLuint);
+
+class ShaderCompiler {
+public:
+    int submitted = 0;
+    int compiled = 0;         // Tidak termasuk hit binary cache
+    
+    void init() {
+        const char* extensions[2] = {"GL_KHR_parallel_shader_compile", "GL_ARB_parallel_shader_compile"};
+        const char* functions[2] = {"glMaxShaderCompilerThreadsKHR", "glMaxShaderCompilerThreadsARB"};
+        for (int i = 0; i < 2 && !parallel; i++) {
+            if (!glfwExtensionSupported(extensions[i])) continue;
+            PFNMAXSHADERCOMPILERTHREADS maxThreads =
+                (PFNMAXSHADERCOMPILERTHREADS)glfwGetProcAddress(functions[i]);
+            if (!maxThreads) continue;
+            maxThreads(0xFFFFFFFFu);   // Biarkan driver memakai semua core
+            parallel = true;
+        }
+    }
+    
+    bool isParallel() const { return parallel; }
+    
+    // Program baru (compile + link sudah dikirim, mungkin belum selesai)
+    unsigned int submit(std::string_view vertexCode, std::string_view fragmentCode,
+                        std::string_view geometryCode = {}) {
+        submitted++;
+        // Binary dari run sebelumnya melewati compile dan link sepenuhnya
+        ProgramBinaryCache& binaryCache = programBinaryCache();
+        uint64_t cacheKey = binaryCache.key(vertexCode, fragmentCode, geometryCode);
+        if (unsigned int cached = binaryCache.load(cacheKey)) return cached;
+        
+        Pending job;
+        job.cacheKey = cacheKey;
+        job.shaders[0] = compileStage(GL_VERTEX_SHADER, vertexCode);
+        job.shaders[1] = compileStage(GL_FRAGMENT_SHADER, fragmentCode);
+        if (!geometryCode.empty()) job.shaders[2] = compileStage(GL_GEOMETRY_SHADER, geometryCode);
+        
+        unsigned int program = glCreateProgram();
+        for (unsigned int shader : job.shaders) {
+            if (shader) glAttachShader(program, shader);
+        }
+        binaryCache.prepare(program);
+        glLinkProgram(program);
+        pending[program] = job;
+        compiled++;
+        return program;
+    }
+    
+    // Tanpa blocking: true jika compile/link program sudah selesai di driver
+    bool isReady(unsigned int program) const {
+        if (!parallel || !pending.count(program)) return true;
+        GLint done = GL_FALSE;
+        glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &done);
+        return done == GL_TRUE;
+    }
+    
+    // Periksa status (menunggu jika belum selesai), tulis log error dan
+    // simpan binary. Aman dipanggil berulang kali.
+    void finish(unsigned int program) {
+        auto it = pending.find(program);
+        if (it == pending.end()) return;
+        const Pending& job = it->second;
+        
+        const char* stageNames[3] = {"Vertex", "Fragment", "Geometry"};
+        int success;
+        char infoLog[512];
+        for (int i = 0; i < 3; i++) {
+            if (!job.shaders[i]) continue;
+            glGetShaderiv(job.shaders[i], GL_COMPILE_STATUS, &success);
+            if (!success) {
+                glGetShaderInfoLog(job.shaders[i], 512, NULL, infoLog);
+                std::cerr << "ERROR: " << stageNames[i] << " shader compilation failed\n"
+                          << shaderPreprocessor().describeLog(infoLog) << std::endl;
+            }
+        }
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            glGetProgramInfoLog(program, 512, NULL, infoLog);
+            std::cerr << "ERROR: Shader program linking failed\n" << infoLog << std::endl;
+        } else {
+            programBinaryCache().store(job.cacheKey, program);
+        }
+        
+        for (unsigned int shader : job.shaders) {
+            if (shader) glDeleteShader(shader);
+        }
+        pending.erase(it);
+    }
+    
+    // Selesaikan program yang sudah jadi tanpa menunggu yang lain
+    void finishReady() {
+        std::vector<unsigned int> ready;
+        for (const auto& entry : pending) {
+            if (isReady(entry.first)) ready.push_back(entry.first);
+        }
+        for (unsigned int program : ready) finish(program);
+    }
+    
+    void finishAll() {
+        while (!pending.empty()) finish(pending.begin()->first);
+    }
+    
+    size_t pendingCount() const { return pending.size(); }
+    
+private:
+    struct Pending {
+        unsigned int shaders[3] = {0, 0, 0};
+        uint64_t cacheKey = 0;
+    };
+    
+    bool parallel = false;
+    std::map<unsigned int, Pending> pending;
+    
+    // Panjang dikirim eksplisit: source berupa view (tanpa terminator nol)
+    static unsigned int compileStage(GLenum type, std::string_view code) {
+        const char* source = code.data();
+        GLint length = (GLint)code.size();
+        unsigned int shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, &length);
+        glCompileShader(shader);
+        return shader;
+    }
+};
+
+ShaderCompiler& shaderCompiler() {
+    static ShaderCompiler compiler;
+    return compiler;
+}
+
+// =====================================================================
+// PERMUTASI SHADER (VARIAN DENGAN #define)
+// =====================================================================
+// Fitur shader dipilih saat compile, bukan lewat uniform: setiap bit
+// menjadi satu #define yang disisipkan setelah baris #version. Program
+// untuk tiap kombinasi di-cache dan baru dikompilasi saat pertama dipakai,
+// sehingga varian murah (misalnya lampu mati tanpa specular) tidak
+// mengeluarkan biaya apa pun sampai benar-benar digambar.
+enum ShaderFeature : uint32_t {
+    FEATURE_SPECULAR  = 1u << 0,   // Specular lampu utama dan lampu lokal
+    FEATURE_SHADOWS   = 1u << 1,   // Sampling cube shadow map
+    FEATURE_CLUSTERED = 1u << 2,   // Loop lampu lokal per cluster
+    FEATURE_BAKED     = 1u << 3,   // Cahaya baked per vertex untuk objek statis
+    FEATURE_FOG       = 1u << 4    // Kabut eksponensial berdasarkan jarak
+};
+
+const char* SHADER_FEATURE_NAMES[] = {"SPECULAR", "SHADOWS", "CLUSTERED_LIGHTS", "BAKED_LIGHTING", "FOG"};
+const int SHADER_FEATURE_COUNT = 5;
+
+// Kabut (--fog atau tombol F)
+bool fogEnabled = false;
+
+// Baris #define untuk satu kombinasi fitur (ditambah konstanta bersama)
+std::string shaderDefines(uint32_t features) {
+    std::string defines = shaderConstants();
+    for (int i = 0; i < SHADER_FEATURE_COUNT; i++) {
+        if (features & (1u << i)) defines += std::string("#define ") + SHADER_FEATURE_NAMES[i] + "\n";
+    }
+    return defines;
+}
+
+class ShaderVariants {
+public:
+    ShaderVariants(const char* vertexPath, const char* fragmentPath, const char* geometryPath = nullptr)
+        : vertexPath(vertexPath), fragmentPath(fragmentPath),
+          geometryPath(geometryPath ? geometryPath : "") {}
+    
+    // Kirim compile beberapa varian sekaligus tanpa menunggu hasilnya
+    void prewarm(const std::vector<uint32_t>& featureSets) {
+        int count = 0;
+        for (uint32_t features : featureSets) {
+            if (programs.count(features)) continue;
+            programs[features] = submitShader(vertexPath.c_str(), fragmentPath.c_str(),
+                                              geometryPath.empty() ? nullptr : geometryPath.c_str(),
+                                              shaderDefines(features));
+            count++;
+        }
+        std::cout << "Varian shader " << fragmentPath << ": " << count
+                  << " varian dikirim ke compiler" << std::endl;
+    }
+    
+    // Program untuk kombinasi fitur ini (dikompilasi saat pertama diminta;
+    // varian prewarm baru diperiksa statusnya di sini)
+    unsigned int get(uint32_t features) {
+        auto it = programs.find(features);
+        if (it != programs.end()) {
+            shaderCompiler().finish(it->second);
+            return it->second;
+        }
+        
+        double start = monotonicTime();
+        unsigned int program = loadShader(vertexPath.c_str(), fragmentPath.c_str(),
+                                          geometryPath.empty() ? nullptr : geometryPath.c_str(),
+                                          shaderDefines(features));
+        std::cout << "Varian shader " << fragmentPath << " [";
+        for (int i = 0, n = 0; i < SHADER_FEATURE_COUNT; i++) {
+            if (features & (1u << i)) std::cout << (n++ ? " " : "") << SHADER_FEATURE_NAMES[i];
+        }
+        std::cout << "] " << (programBinaryCache().lastWasHit ? "dari cache" : "dikompilasi")
+                  << " (" << (monotonicTime() - start) * 1000.0 << " ms)" << std::endl;
+        programs[features] = program;
+        return program;
+    }
+    
+    size_t compiledCount() const { return programs.size(); }
+    
+    void cleanup() {
+        for (auto& entry : programs) glDeleteProgram(entry.second);
+        programs.clear();
+    }
+    
+private:
+    std::string vertexPath;
+    std::string fragmentPath;
+    std::string geometryPath;
+    std::map<uint32_t, unsigned int> programs;
+};
+
+// =====================================================================
+// SHADOW MAP OMNIDIRECTIONAL (CUBE MAP) DENGAN CACHE
+// =====================================================================
+// Bayangan lampu titik disimpan dalam dua cube map depth:
+// - Layer statis (resolusi tinggi) berisi dinding dan perabot tetap,
+//   hanya di-render ulang saat lampu berpindah atau invalidateStatic()
+// - Layer dinamis (resolusi kecil) berisi objek isDynamic, di-render
+//   ulang hanya saat lampu atau salah satu objek dinamis bergerak
+// Fragment shader mengambil nilai minimum keduanya, sehingga frame
+// tanpa perubahan tidak membayar satu pass shadow pun.
+bool shadowsEnabled = true;
+
+class PointShadowMap {
+public:
+    int staticSize = 1024;
+    int dynamicSize = 256;
+    float nearPlane = 0.05f;
+    float farPlane = 25.0f;
+    
+    // Statistik jumlah render ulang per layer
+    int staticRenders = 0;
+    int dynamicRenders = 0;
+    
+    void init() {
+        glGenFramebuffers(1, &fbo);
+        staticCube = createCubeTexture(staticSize);
+        dynamicCube = createCubeTexture(dynamicSize);
+    }
+    
+    void invalidateStatic() { staticDirty = true; }
+    
+    // Kedua layer digambar ulang (objek baru masuk saat loading bertahap)
+    void invalidate() { hasCache = false; }
+    
+    // dynamicVersion berubah setiap kali objek dinamis bergerak
+    // (lihat LooseOctree::moveCount)
+    void update(glm::vec3 lightPos, std::vector<Object3D>& objects, int dynamicVersion,
+                unsigned int program) {
+        bool lightMoved = !hasCache || lightPos != cachedLightPos;
+        bool renderStatic = lightMoved || staticDirty;
+        bool renderDynamic = lightMoved || dynamicVersion != cachedDynamicVersion;
+        if (!renderStatic && !renderDynamic) return;
+        
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        glUseProgram(program);
+        glUniform3fv(glGetUniformLocation(program, "lightPos"), 1, glm::value_ptr(lightPos));
+        glUniform1f(glGetUniformLocation(program, "farPlane"), farPlane);
+        glUniformMatrix4fv(glGetUniformLocation(program, "shadowMatrices"), 6, GL_FALSE,
+                           glm::value_ptr(faceMatrices(lightPos)[0]));
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+        
+        if (renderStatic) {
+            renderLayer(staticCube, staticSize, false, objects, program);
+            staticRenders++;
+        }
+        if (renderDynamic) {
+            renderLayer(dynamicCube, dynamicSize, true, objects, program);
+            dynamicRenders++;
+        }
+        
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+        
+        cachedLightPos = lightPos;
+        cachedDynamicVersion = dynamicVersion;
+        staticDirty = false;
+        hasCache = true;
+    }
+    
+    // Pasang kedua cube map ke shader utama
+    void bind(unsigned int program, int staticUnit, int dynamicUnit) const {
+        glActiveTexture(GL_TEXTURE0 + staticUnit);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, staticCube);
+        glActiveTexture(GL_TEXTURE0 + dynamicUnit);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, dynamicCube);
+        glActiveTexture(GL_TEXTURE0);
+        glUniform1i(glGetUniformLocation(program, "shadowStatic"), staticUnit);
+        glUniform1i(glGetUniformLocation(program, "shadowDynamic"), dynamicUnit);
+        glUniform1f(glGetUniformLocation(program, "farPlane"), farPlane);
+    }
+    
+    void cleanup() {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteTextures(1, &staticCube);
+        glDeleteTextures(1, &dynamicCube);
+    }
+    
+private:
+    unsigned int fbo = 0;
+    unsigned int staticCube = 0;
+    unsigned int dynamicCube = 0;
+    glm::vec3 cachedLightPos = glm::vec3(0.0f);
+    int cachedDynamicVersion = -1;
+    bool staticDirty = true;
+    bool hasCache = false;
+    
+    unsigned int createCubeTexture(int size) {
+        unsigned int tex;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, tex);
+        for (int face = 0; face < 6; face++) {
+            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_DEPTH_COMPONENT24,
+                         size, size, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+        }
+        // Perbandingan depth di hardware (PCF 2x2 dengan GL_LINEAR)
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+        glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+        glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+        return tex;
+    }
+    
+    std::vector<glm::mat4> faceMatrices(glm::vec3 lightPos) const {
+        glm::mat4 proj = glm::perspective(glm::radians(90.0f), 1.0f, nearPlane, farPlane);
+        return {
+            proj * glm::lookAt(lightPos, lightPos + glm::vec3( 1, 0, 0), glm::vec3(0, -1,  0)),
+            proj * glm::lookAt(lightPos, lightPos + glm::vec3(-1, 0, 0), glm::vec3(0, -1,  0)),
+            proj * glm::lookAt(lightPos, lightPos + glm::vec3( 0, 1, 0), glm::vec3(0,  0,  1)),
+            proj * glm::lookAt(lightPos, lightPos + glm::vec3( 0,-1, 0), glm::vec3(0,  0, -1)),
+            proj * glm::lookAt(lightPos, lightPos + glm::vec3( 0, 0, 1), glm::vec3(0, -1,  0)),
+            proj * glm::lookAt(lightPos, lightPos + glm::vec3( 0, 0,-1), glm::vec3(0, -1,  0))
+        };
+    }
+    
+    void renderLayer(unsigned int cube, int size, bool dynamicLayer,
+                     std::vector<Object3D>& objects, unsigned int program) {
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, cube, 0);
+        glViewport(0, 0, size, size);
+        glClear(GL_DEPTH_BUFFER_BIT);
+        
+        int modelLocation = glGetUniformLocation(program, "model");
+        for (auto& obj : objects) {
+            if (!obj.gpuReady || !obj.castsShadow || obj.isDynamic != dynamicLayer) continue;
+            glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(obj.getModelMatrix()));
+            obj.draw();
+        }
+    }
+};
+
+// =====================================================================
+// THREAD POOL (PEKERJAAN PARALEL CPU)
+// =====================================================================
+// Worker dibuat sekali dan tidur di antara job. parallelFor membagi indeks
+// [0, count) ke semua worker plus thread pemanggil, lalu menunggu selesai.
+class ThreadPool {
+public:
+    // threadCount <= 0: pakai jumlah core hardware
+    explicit ThreadPool(int threadCount = 0) {
+        if (threadCount <= 0) threadCount = (int)std::thread::hardware_concurrency();
+        threadCount = std::max(threadCount, 1);
+        for (int i = 1; i < threadCount; i++) {
+            workers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+    
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    // Jumlah thread yang ikut bekerja (termasuk pemanggil)
+    int size() const { return (int)workers.size() + 1; }
+    
+    // Jalankan fn(i) untuk setiap i di [0, count), blocking sampai selesai
+    void parallelFor(int count, const std::function<void(int)>& fn) {
+        if (count <= 0) return;
+        if (workers.empty() || count == 1) {
+            for (int i = 0; i < count; i++) fn(i);
+            return;
+        }
+        std::lock_guard<std::mutex> callLock(callMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            jobCount = count;
+            nextIndex = 0;
+            busyWorkers = (int)workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        runJob();
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this]() { return busyWorkers == 0; });
+        job = nullptr;
+    }
+    
+private:
+    std::vector<std::thread> workers;
+    std::mutex callMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(int)>* job = nullptr;
+    int jobCount = 0;
+    std::atomic<int> nextIndex{0};
+    int busyWorkers = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+    
+    void runJob() {
+        int i;
+        while ((i = nextIndex.fetch_add(1)) < jobCount) (*job)(i);
+    }
+    
+    void workerLoop() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            lock.unlock();
+            runJob();
+            lock.lock();
+            if (--busyWorkers == 0) done.notify_one();
+        }
+    }
+};
+
+// Pool bersama untuk seluruh program
+ThreadPool& workerPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+// =====================================================================
+// CLUSTERED FORWARD SHADING (LAMPU TITIK LOKAL)
+// =====================================================================
+// Frustum kamera dibagi menjadi grid cluster (x, y di layar, z eksponensial
+// di view space). Setiap frame daftar lampu per cluster dibangun di CPU,
+// satu slice z per job thread pool, lalu di-upload ke texture buffer.
+// Fragment shader hanya meng-loop lampu di cluster-nya, sehingga biaya
+// per pixel mengikuti kepadatan lampu lokal, bukan jumlah lampu total.
+// Lampu gantung utama tetap dihitung terpisah karena memiliki shadow map.
+struct PointLight {
+    glm::vec3 position;
+    glm::vec3 color;
+    float radius;   // jangkauan, kontribusi nol di luar radius
+};
+
+// Lampu acak tambahan dari command line (--lights N)
+int extraLightCount = 0;
+
+class LightClusters {
+public:
+    static const int GRID_X = 16;
+    static const int GRID_Y = 9;
+    static const int GRID_Z = 24;
+    static const int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+    static const int MAX_PER_CLUSTER = 256;
+    float zNear = 0.1f;
+    float zFar = 100.0f;
+    
+    // Statistik build terakhir
+    int visibleLights = 0;
+    int references = 0;
+    int activeClusters = 0;
+    int maxPerCluster = 0;
+    int overflowed = 0;
+    
+    LightClusters() : scratch((size_t)CLUSTER_COUNT * MAX_PER_CLUSTER), counts(CLUSTER_COUNT),
+                      clusterBounds(CLUSTER_COUNT), grid(CLUSTER_COUNT * 2) {}
+    
+    void init() {
+        glGenBuffers(3, buffers);
+        glGenTextures(3, textures);
+        GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+        for (int i = 0; i < 3; i++) {
+            glBindBuffer(GL_TEXTURE_BUFFER, buffers[i]);
+            glBufferData(GL_TEXTURE_BUFFER, 16, NULL, GL_STREAM_DRAW);
+            glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+            glTexBuffer(GL_TEXTURE_BUFFER, formats[i], buffers[i]);
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+    
+    // Bangun daftar lampu per cluster (CPU saja, aman dipanggil tanpa GL)
+    void build(const std::vector<PointLight>& lights, const glm::mat4& view,
+               const glm::mat4& projection, ThreadPool& pool) {
+        if (projection != cachedProjection) computeClusterBounds(projection);
+        
+        // Lampu ke view space, buang yang di luar rentang kedalaman
+        viewLights.clear();
+        for (int i = 0; i < (int)lights.size(); i++) {
+            glm::vec3 center = glm::vec3(view * glm::vec4(lights[i].position, 1.0f));
+            float depth = -center.z;
+            if (depth + lights[i].radius < zNear || depth - lights[i].radius > zFar) continue;
+            viewLights.push_back({center, lights[i].radius, i});
+        }
+        visibleLights = (int)viewLights.size();
+        
+        // Setiap slice z hanya menulis cluster miliknya sendiri (tanpa lock)
+        float scaleX = projection[0][0], scaleY = projection[1][1];
+        pool.parallelFor(GRID_Z, [&](int z) {
+            float sliceNear = sliceDepth(z), sliceFar = sliceDepth(z + 1);
+            int* sliceCounts = &counts[z * GRID_X * GRID_Y];
+            std::fill(sliceCounts, sliceCounts + GRID_X * GRID_Y, 0);
+            for (const ViewLight& light : viewLights) {
+                float depth = -light.center.z;
+                if (depth + light.radius < sliceNear || depth - light.radius > sliceFar) continue;
+                
+                // Rentang tile konservatif: x/d minimum dan maksimum pada
+                // rentang kedalaman bola yang jatuh di slice ini
+                float d0 = std::max(sliceNear, depth - light.radius);
+                float d1 = std::min(sliceFar, depth + light.radius);
+                float left = light.center.x - light.radius, right = light.center.x + light.radius;
+                float bottom = light.center.y - light.radius, top = light.center.y + light.radius;
+                int x0 = tileIndex(scaleX * left / (left >= 0.0f ? d1 : d0), GRID_X);
+                int x1 = tileIndex(scaleX * right / (right >= 0.0f ? d0 : d1), GRID_X);
+                int y0 = tileIndex(scaleY * bottom / (bottom >= 0.0f ? d1 : d0), GRID_Y);
+                int y1 = tileIndex(scaleY * top / (top >= 0.0f ? d0 : d1), GRID_Y);
+                
+                for (int y = y0; y <= y1; y++) {
+                    for (int x = x0; x <= x1; x++) {
+                        int cluster = x + GRID_X * (y + GRID_Y * z);
+                        if (!sphereOverlaps(clusterBounds[cluster], light.center, light.radius)) continue;
+                        int& count = counts[cluster];
+                        if (count < MAX_PER_CLUSTER) {
+                            scratch[(size_t)cluster * MAX_PER_CLUSTER + count] = (uint32_t)light.index;
+                        }
+                        count++;
+                    }
+                }
+            }
+        });
+        
+        // Padatkan menjadi (offset, count) per cluster + daftar indeks
+        indices.clear();
+        references = activeClusters = maxPerCluster = overflowed = 0;
+        for (int c = 0; c < CLUSTER_COUNT; c++) {
+            int count = counts[c];
+            if (count > MAX_PER_CLUSTER) {
+                overflowed++;
+                count = MAX_PER_CLUSTER;
+            }
+            grid[c * 2] = (uint32_t)indices.size();
+            grid[c * 2 + 1] = (uint32_t)count;
+            const uint32_t* list = &scratch[(size_t)c * MAX_PER_CLUSTER];
+            indices.insert(indices.end(), list, list + count);
+            if (count > 0) activeClusters++;
+            maxPerCluster = std::max(maxPerCluster, count);
+        }
+        references = (int)indices.size();
+        
+        // Data lampu: 2 texel per lampu (posisi + radius, warna)
+        lightData.resize(std::max<size_t>(lights.size(), 1) * 8, 0.0f);
+        for (size_t i = 0; i < lights.size(); i++) {
+            float* texel = &lightData[i * 8];
+            texel[0] = lights[i].position.x;
+            texel[1] = lights[i].position.y;
+            texel[2] = lights[i].position.z;
+            texel[3] = lights[i].radius;
+            texel[4] = lights[i].color.r;
+            texel[5] = lights[i].color.g;
+            texel[6] = lights[i].color.b;
+        }
+        if (indices.empty()) indices.push_back(0);
+    }
+    
+    // Upload hasil build ke texture buffer (buffer lama di-orphan)
+    void upload() {
+        uploadBuffer(buffers[0], lightData.data(), lightData.size() * sizeof(float));
+        uploadBuffer(buffers[1], grid.data(), grid.size() * sizeof(uint32_t));
+        uploadBuffer(buffers[2], indices.data(), indices.size() * sizeof(uint32_t));
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+    
+    // Pasang texture buffer dan parameter grid ke shader utama
+    void bind(unsigned int program, int firstUnit, glm::vec2 screenSize) const {
+        const char* names[3] = {"lightData", "clusterGrid", "lightIndices"};
+        for (int i = 0; i < 3; i++) {
+            glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+            glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+            glUniform1i(glGetUniformLocation(program, names[i]), firstUnit + i);
+        }
+        glActiveTexture(GL_TEXTURE0);
+        glUniform2fv(glGetUniformLocation(program, "screenSize"), 1, glm::value_ptr(screenSize));
+        glUniform1f(glGetUniformLocation(program, "clusterNear"), zNear);
+        glUniform1f(glGetUniformLocation(program, "clusterLogScale"),
+                    GRID_Z / std::log(zFar / zNear));
+    }
+    
+    void cleanup() {
+        glDeleteTextures(3, textures);
+        glDeleteBuffers(3, buffers);
+    }
+    
+private:
+    struct ViewLight {
+        glm::vec3 center;
+        float radius;
+        int index;
+    };
+    
+    unsigned int buffers[3] = {0, 0, 0};
+    unsigned int textures[3] = {0, 0, 0};
+    std::vector<ViewLight> viewLights;
+    std::vector<uint32_t> scratch;
+    std::vector<int> counts;
+    std::vector<AABB> clusterBounds;
+    std::vector<uint32_t> grid;
+    std::vector<uint32_t> indices;
+    std::vector<float> lightData;
+    glm::mat4 cachedProjection = glm::mat4(0.0f);
+    
+    // Kedalaman (positif) batas depan slice ke-z, distribusi eksponensial
+    float sliceDepth(int z) const {
+        return zNear * std::pow(zFar / zNear, (float)z / GRID_Z);
+    }
+    
+    static int tileIndex(float ndc, int tiles) {
+        int tile = (int)std::floor((ndc * 0.5f + 0.5f) * tiles);
+        return std::min(std::max(tile, 0), tiles - 1);
+    }
+    
+    static bool sphereOverlaps(const AABB& box, glm::vec3 center, float radius) {
+        glm::vec3 closest = glm::clamp(center, box.min, box.max);
+        glm::vec3 d = closest - center;
+        return glm::dot(d, d) <= radius * radius;
+    }
+    
+    // AABB view space setiap cluster, dihitung ulang hanya saat proyeksi berubah
+    void computeClusterBounds(const glm::mat4& projection) {
+        cachedProjection = projection;
+        float invX = 1.0f / projection[0][0], invY = 1.0f / projection[1][1];
+        for (int z = 0; z < GRID_Z; z++) {
+            float depths[2] = {sliceDepth(z), sliceDepth(z + 1)};
+            for (int y = 0; y < GRID_Y; y++) {
+                for (int x = 0; x < GRID_X; x++) {
+                    float ndcX[2] = {x * 2.0f / GRID_X - 1.0f, (x + 1) * 2.0f / GRID_X - 1.0f};
+                    float ndcY[2] = {y * 2.0f / GRID_Y - 1.0f, (y + 1) * 2.0f / GRID_Y - 1.0f};
+                    AABB box;
+                    for (float d : depths)
+                        for (float nx : ndcX)
+                            for (float ny : ndcY)
+                                box.expand(glm::vec3(nx * d * invX, ny * d * invY, -d));
+                    clusterBounds[x + GRID_X * (y + GRID_Y * z)] = box;
+                }
+            }
+        }
+    }
+    
+    static void uploadBuffer(unsigned int buffer, const void* data, size_t bytes) {
+        glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+        glBufferData(GL_TEXTURE_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    }
+};
+
+// Lampu lokal dari file scene, ditambah lampu acak untuk uji beban
+std::vector<PointLight> createRoomLights(const std::vector<PointLight>& sceneLights,
+                                         float width, float height, float depth, int extra) {
+    std::vector<PointLight> lights = sceneLights;
+    
+    unsigned int rng = 97531u;
+    auto nextFloat = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return (rng >> 8) * (1.0f / 16777216.0f);
+    };
+    for (int i = 0; i < extra; i++) {
+        glm::vec3 position((nextFloat() - 0.5f) * width, 0.3f + nextFloat() * (height - 0.6f),
+                           (nextFloat() - 0.5f) * depth);
+        glm::vec3 color(0.3f + 0.7f * nextFloat(), 0.3f + 0.7f * nextFloat(), 0.3f + 0.7f * nextFloat());
+        lights.push_back({position, color * 0.4f, 0.8f + nextFloat() * 1.2f});
+    }
+    return lights;
+}
+
+// Konstanta yang dipakai C++ dan shader, disisipkan shaderDefines ke setiap
+// varian sehingga nilainya hanya ditulis di sini. Jumlah lampu sendiri
+// bukan sumbu varian: --lights dan isi cluster berubah saat runtime, jadi
+// varian per jumlah lampu berarti compile ulang setiap kali berubah. Yang
+// tetap saat compile adalah ukuran grid cluster dan batas lampu per cluster.
+std::string shaderConstants() {
+    std::ostringstream defines;
+    defines << "#define CLUSTER_GRID ivec3(" << LightClusters::GRID_X << ", " << LightClusters::GRID_Y
+            << ", " << LightClusters::GRID_Z << ")\n";
+    defines << "#define MAX_LIGHTS_PER_CLUSTER " << LightClusters::MAX_PER_CLUSTER << "\n";
+    defines << "#define MAX_MATERIALS " << MAX_MATERIALS << "\n";
+    return defines.str();
+}
+
+// =====================================================================
+// MATERIAL: TEXTURE ARRAY (SATU BIND UNTUK SEMUA PERABOT)
+// =====================================================================
+// Detail albedo semua material disimpan sebagai layer dari satu
+// GL_TEXTURE_2D_ARRAY (ukuran dan format sama, mipmap lengkap). Setiap
+// vertex membawa indeks material (atribut 5), dan shader memilih layer
+// dari indeks itu. Texture hanya dibind sekali per frame, sehingga ratusan
+// perabot dengan material berbeda tetap digambar tanpa ganti texture atau
+// program di antara draw call. Mesh tidak menyimpan UV: koordinat tekstur
+// dihitung vertex shader dengan box mapping (lihat vertex_shader.glsl).
+//
+// Layer dibangun prosedural (grayscale, rata-rata 128/255) dan dikalikan
+// dengan warna vertex, sehingga hue tetap dari builder/file scene.
+struct MaterialInfo {
+    const char* name;
+    float tiling;       // Ulangan tekstur per meter
+};
+
+const MaterialInfo MATERIALS[MATERIAL_COUNT] = {
+    {"none",    0.0f},
+    {"wood",    1.0f},
+    {"fabric",  4.0f},
+    {"tile",    0.8f},
+    {"plaster", 0.5f},
+    {"metal",   2.0f},
+};
+
+const int MATERIAL_TEXTURE_UNIT = 9;
+bool materialsEnabled = true;   // --no-materials: layer datar (warna vertex saja)
+
+// Indeks material dari nama (file scene), -1 jika tidak dikenal
+int findMaterial(const std::string& name) {
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        if (name == MATERIALS[i].name) return i;
+    }
+    return -1;
+}
+
+#define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
+#define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
+
+class MaterialLibrary {
+public:
+    static const int LAYER_SIZE = 256;
+    
+    int layers = 0;
+    int size = 0;
+    int levels = 0;
+    
+    void init(bool enabled) {
+        double start = monotonicTime();
+        layers = MATERIAL_COUNT - 1;
+        size = enabled ? LAYER_SIZE : 1;
+        
+        // Setiap layer dibangun terpisah di worker pool
+        std::vector<uint8_t> pixels((size_t)size * size * 4 * layers);
+        workerPool().parallelFor(layers, [&](int layer) {
+            buildLayer((MaterialId)(layer + 1), &pixels[(size_t)layer * size * size * 4]);
+        });
+        
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, size, size, layers, 0,
+                     GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        if (glfwExtensionSupported("GL_EXT_texture_filter_anisotropic")) {
+            float maxAnisotropy = 1.0f;
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+            glTexParameterf(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                            std::min(maxAnisotropy, 8.0f));
+        }
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        
+        levels = 1;
+        while ((size >> levels) > 0) levels++;
+        std::cout << "Material: " << layers << " layer " << size << "x" << size
+                  << " RGBA8, " << levels << " level mip ("
+                  << (monotonicTime() - start) * 1000.0 << " ms)"
+                  << (enabled ? "" : " [datar, --no-materials]") << std::endl;
+    }
+    
+    // Pasang texture array dan skala tiling ke program geometri
+    void bind(unsigned int program, int unit) const {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+        glActiveTexture(GL_TEXTURE0);
+        glUniform1i(glGetUniformLocation(program, "materialTextures"), unit);
+        float tiling[MAX_MATERIALS] = {};
+        for (int i = 0; i < MATERIAL_COUNT; i++) tiling[i] = MATERIALS[i].tiling;
+        glUniform1fv(glGetUniformLocation(program, "materialTiling"), MAX_MATERIALS, tiling);
+    }
+    
+    void cleanup() {
+        glDeleteTextures(1, &texture);
+        texture = 0;
+    }
+    
+private:
+    unsigned int texture = 0;
+    
+    // Value noise yang berulang setiap `period` sel (tekstur tanpa sambungan)
+    static float latticeValue(int x, int y, int period, uint32_t seed) {
+        x = ((x % period) + period) % period;
+        y = ((y % period) + period) % period;
+        uint32_t h = (uint32_t)x * 374761393u + (uint32_t)y * 668265263u + seed * 2246822519u;
+        h = (h ^ (h >> 13)) * 1274126177u;
+        return ((h ^ (h >> 16)) & 0xFFFFFF) * (1.0f / 16777216.0f);
+    }
+    
+    static float noise(float u, float v, int period, uint32_t seed) {
+        float x = u * period, y = v * period;
+        int x0 = (int)std::floor(x), y0 = (int)std::floor(y);
+        float fx = x - x0, fy = y - y0;
+        fx = fx * fx * (3.0f - 2.0f * fx);
+        fy = fy * fy * (3.0f - 2.0f * fy);
+        float a = glm::mix(latticeValue(x0, y0, period, seed), latticeValue(x0 + 1, y0, period, seed), fx);
+        float b = glm::mix(latticeValue(x0, y0 + 1, period, seed), latticeValue(x0 + 1, y0 + 1, period, seed), fx);
+        return glm::mix(a, b, fy);
+    }
+    
+    // Jumlah beberapa oktaf noise (periode berlipat dua tiap oktaf), 0..1
+    static float fbm(float u, float v, int period, int octaves, uint32_t seed) {
+        float sum = 0.0f, amplitude = 0.5f, total = 0.0f;
+        for (int o = 0; o < octaves; o++) {
+            sum += noise(u, v, period << o, seed + o) * amplitude;
+            total += amplitude;
+            amplitude *= 0.5f;
+        }
+        return sum / total;
+    }
+    
+    // Intensitas pola material di koordinat (u, v) dalam [0, 1)
+    static float pattern(MaterialId material, float u, float v) {
+        switch (material) {
+            case MATERIAL_WOOD: {
+                // Cincin serat sepanjang u, dibelokkan noise, plus serat halus
+                float warp = fbm(u, v, 4, 3, 11u);
+                float ring = glm::fract(v * 6.0f + warp * 1.5f);
+                float grain = noise(u * 0.25f, v, 128, 12u);
+                return 0.7f + 0.2f * glm::smoothstep(0.0f, 0.7f, ring) * (1.0f - ring) * 2.0f
+                       + 0.1f * grain;
+            }
+            case MATERIAL_FABRIC: {
+                // Anyaman: benang horizontal dan vertikal bergantian di atas
+                const float threads = 32.0f;
+                float su = std::abs(std::sin(u * threads * glm::pi<float>()));
+                float sv = std::abs(std::sin(v * threads * glm::pi<float>()));
+                bool horizontalOnTop = (((int)(u * threads) + (int)(v * threads)) & 1) != 0;
+                float thread = horizontalOnTop ? sv : su;
+                return 0.65f + 0.3f * thread + 0.1f * noise(u, v, 64, 21u);
+            }
+            case MATERIAL_TILE: {
+                // Keramik berbintik dengan bercak samar
+                float mottling = fbm(u, v, 4, 3, 31u);
+                float speckle = noise(u, v, 128, 32u);
+                return 0.8f + 0.15f * mottling + (speckle > 0.85f ? -0.2f : 0.05f * speckle);
+            }
+            case MATERIAL_PLASTER:
+                // Plester: variasi frekuensi rendah ditambah butiran halus
+                return 0.9f + 0.08f * fbm(u, v, 4, 4, 41u) + 0.04f * noise(u, v, 128, 42u);
+            case MATERIAL_METAL: {
+                // Brushed metal: goresan panjang sepanjang u
+                float streak = fbm(u * 0.0625f, v, 128, 2, 51u);
+                return 0.8f + 0.25f * streak + 0.05f * noise(u, v, 32, 52u);
+            }
+            default:
+                return 1.0f;
+        }
+    }
+    
+    // Isi satu layer RGBA8 dan normalisasi rata-ratanya ke 128
+    void buildLayer(MaterialId material, uint8_t* out) const {
+        std::vector<float> values((size_t)size * size, 1.0f);
+        double sum = 0.0;
+        if (size > 1) {
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    float value = pattern(material, (x + 0.5f) / size, (y + 0.5f) / size);
+                    values[(size_t)y * size + x] = value;
+                    sum += value;
+                }
+            }
+        } else {
+            sum = 1.0;
+        }
+        float scale = (float)(128.0 * values.size() / sum);
+        for (size_t i = 0; i < values.size(); i++) {
+            uint8_t level = (uint8_t)glm::clamp(values[i] * scale + 0.5f, 0.0f, 255.0f);
+            out[i * 4 + 0] = level;
+            out[i * 4 + 1] = level;
+            out[i * 4 + 2] = level;
+            out[i * 4 + 3] = 255;
+        }
+    }
+};
+
+// =====================================================================
+// DEFERRED SHADING (G-BUFFER)
+// =====================================================================
+// Jalur render alternatif: pass geometri menulis albedo (ObjectColor),
+// normal, cahaya baked, dan depth ke beberapa render target (MRT), lalu satu
+// pass layar penuh menghitung lampu utama + lampu cluster hanya sekali
+// per pixel yang terlihat. Dipilih saat startup dengan --deferred.
+enum RenderPath { PATH_FORWARD, PATH_DEFERRED };
+RenderPath renderPath = PATH_FORWARD;
+
+class GBuffer {
+public:
+    int width = 0;
+    int height = 0;
+    
+    void init(int w, int h) {
+        glGenFramebuffers(1, &fbo);
+        glGenVertexArrays(1, &emptyVAO);
+        resize(w, h);
+    }
+    
+    // Buat ulang attachment jika ukuran framebuffer berubah
+    void resize(int w, int h) {
+        if (w == width && h == height) return;
+        width = w;
+        height = h;
+        deleteTextures();
+        albedo = createTexture(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+        normal = createTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);
+        baked = createTexture(GL_RGBA16F, GL_RGBA, GL_FLOAT);
+        depth = createTexture(GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT);
+        
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedo, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normal, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, baked, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+        GLenum attachments[3] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2};
+        glDrawBuffers(3, attachments);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "ERROR::GBUFFER::FRAMEBUFFER_INCOMPLETE" << std::endl;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+    
+    // Pass geometri: render ke G-buffer
+    void beginGeometryPass() const {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glViewport(0, 0, width, height);
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+    
+    // Pass lampu: segitiga layar penuh ke target scene (default atau HDR
+    // post-process). Depth G-buffer ditulis ulang lewat gl_FragDepth agar
+    // objek forward (kubus lampu) tetap teruji depth dengan benar.
+    void lightingPass(unsigned int program, int firstUnit, unsigned int targetFramebuffer) const {
+        glBindFramebuffer(GL_FRAMEBUFFER, targetFramebuffer);
+        const char* names[4] = {"gAlbedo", "gNormal", "gBaked", "gDepth"};
+        unsigned int textures[4] = {albedo, normal, baked, depth};
+        for (int i = 0; i < 4; i++) {
+            glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+            glBindTexture(GL_TEXTURE_2D, textures[i]);
+            glUniform1i(glGetUniformLocation(program, names[i]), firstUnit + i);
+        }
+        glActiveTexture(GL_TEXTURE0);
+        
+        glDepthFunc(GL_ALWAYS);
+        glBindVertexArray(emptyVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        glBindVertexArray(0);
+        glDepthFunc(GL_LESS);
+    }
+    
+    void cleanup() {
+        deleteTextures();
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteVertexArrays(1, &emptyVAO);
+    }
+    
+private:
+    unsigned int fbo = 0;
+    unsigned int emptyVAO = 0;
+    unsigned int albedo = 0, normal = 0, baked = 0, depth = 0;
+    
+    void deleteTextures() {
+        unsigned int textures[4] = {albedo, normal, baked, depth};
+        if (albedo) glDeleteTextures(4, textures);
+        albedo = normal = baked = depth = 0;
+    }
+    
+    unsigned int createTexture(GLenum internalFormat, GLenum format, GLenum type) const {
+        unsigned int tex;
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return tex;
+    }
+};
+
+// Pencahayaan baked per vertex untuk objek statis (--baked, lihat bagian BAKE)
+bool bakedLightingEnabled = false;
+
+// Parameter lampu utama untuk kedua state (dipakai shader dan baker)
+struct LightingParams {
+    glm::vec3 color;
+    float ambient;
+    float diffuse;
+    float specular;
+};
+
+LightingParams lightingParams(bool on, const glm::vec3& color = lightColor) {
+    if (on) return {color, 0.3f, 0.8f, 0.5f};
+    return {glm::vec3(0.3f, 0.3f, 0.35f), 0.15f, 0.2f, 0.1f};
+}
+
+// Uniform pencahayaan lampu utama (sama untuk jalur forward dan deferred)
+void setLightingUniforms(unsigned int program) {
+    LightingParams params = lightingParams(lightOn);
+    glUniform3fv(glGetUniformLocation(program, "lightPos"), 1, glm::value_ptr(lightPos));
+    glUniform3fv(glGetUniformLocation(program, "viewPos"), 1, glm::value_ptr(cameraPos));
+    glUniform3fv(glGetUniformLocation(program, "lightColor"), 1, glm::value_ptr(params.color));
+    glUniform1f(glGetUniformLocation(program, "ambientStrength"), params.ambient);
+    glUniform1f(glGetUniformLocation(program, "diffuseStrength"), params.diffuse);
+    glUniform1f(glGetUniformLocation(program, "specularStrength"), params.specular);
+    glUniform1f(glGetUniformLocation(program, "shininess"), 32.0f);
+    glUniform3f(glGetUniformLocation(program, "fogColor"), 0.1f, 0.1f, 0.15f);
+    glUniform1f(glGetUniformLocation(program, "fogDensity"), 0.08f);
+}
+
+// Kombinasi fitur shader yang dibutuhkan state saat ini. Lampu mati
+// memakai varian tanpa specular (kontribusinya tidak terlihat).
+uint32_t activeShaderFeatures(bool hasLocalLights) {
+    uint32_t features = 0;
+    if (lightOn) features |= FEATURE_SPECULAR;
+    if (shadowsEnabled) features |= FEATURE_SHADOWS;
+    if (hasLocalLights) features |= FEATURE_CLUSTERED;
+    if (bakedLightingEnabled) features |= FEATURE_BAKED;
+    if (fogEnabled) features |= FEATURE_FOG;
+    return features;
+}
+
+// Semua kombinasi yang bisa dicapai lewat toggle runtime (L dan F) dari
+// konfigurasi command line saat ini
+std::vector<uint32_t> reachableShaderFeatures(bool hasLocalLights) {
+    uint32_t base = activeShaderFeatures(hasLocalLights) & ~(FEATURE_SPECULAR | FEATURE_FOG);
+    return {base, base | FEATURE_SPECULAR, base | FEATURE_FOG, base | FEATURE_SPECULAR | FEATURE_FOG};
+}
+
+// =====================================================================
+// POST-PROCESS GRAPH (TARGET HDR, PENGGABUNGAN PASS, TEXTURE POOL)
+// =====================================================================
+// Scene dirender ke target HDR offscreen, lalu diproses daftar pass.
+// Setiap pass mendeklarasikan input, output, skala resolusi (relatif
+// terhadap scene), dan fungsi GLSL di shaders/post/. Pass "pointwise"
+// (hanya membaca pixel yang sama dari input utamanya) digabung ke pass
+// sebelumnya, sehingga beberapa efek berjalan dalam satu shader dan satu
+// round trip layar penuh. Texture perantara diambil dari pool dan dipakai
+// ulang (alias) begitu pembaca terakhirnya selesai.
+bool postProcessEnabled = true;
+const float LAMP_EMISSIVE_HDR = 4.0f;   // Kecerahan bohlam di target HDR (sumber bloom)
+
+struct PostPass {
+    std::string function;             // Nama fungsi GLSL di file snippet
+    std::string file;                 // Snippet (tanpa #version)
+    std::vector<std::string> inputs;  // inputs[0] = sumber utama
+    std::string output;               // "" = layar (framebuffer default)
+    float scale = 1.0f;
+    GLenum format = GL_RGBA8;
+    // Pointwise: vec4 f(vec4 color, sampler2D extra...)
+    // Lainnya:   vec4 f(sampler2D source, sampler2D extra...)
+    bool pointwise = false;
+    // Hanya mengubah resolusi (pass terakhir ke layar): dilewati jika
+    // scene sudah seukuran layar, pass sebelumnya langsung menulis ke layar
+    bool resample = false;
+};
+
+// Render target 2D (texture + FBO) yang dipakai ulang antar pass
+class TexturePool {
+public:
+    struct Target {
+        unsigned int texture;
+        unsigned int framebuffer;
+        int width, height;
+        GLenum format;
+        bool inUse;
+    };
+    
+    // Indeks target bebas dengan ukuran/format sama, dibuat jika tidak ada
+    int acquire(int w, int h, GLenum format) {
+        for (size_t i = 0; i < targets.size(); i++) {
+            Target& t = targets[i];
+            if (!t.inUse && t.width == w && t.height == h && t.format == format) {
+                t.inUse = true;
+                return (int)i;
+            }
+        }
+        Target t = {0, 0, w, h, format, true};
+        glGenTextures(1, &t.texture);
+        glBindTexture(GL_TEXTURE_2D, t.texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, w, h, 0, GL_RGBA,
+                     format == GL_RGBA8 ? GL_UNSIGNED_BYTE : GL_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        
+        glGenFramebuffers(1, &t.framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, t.framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, t.texture, 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "ERROR::POST::TARGET_INCOMPLETE " << w << "x" << h << std::endl;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        targets.push_back(t);
+        return (int)targets.size() - 1;
+    }
+    
+    void release(int index) { targets[index].inUse = false; }
+    const Target& get(int index) const { return targets[index]; }
+    size_t size() const { return targets.size(); }
+    
+    void clear() {
+        for (const Target& t : targets) {
+            glDeleteTextures(1, &t.texture);
+            glDeleteFramebuffers(1, &t.framebuffer);
+        }
+        targets.clear();
+    }
+    
+private:
+    std::vector<Target> targets;
+};
+
+class PostProcessGraph {
+public:
+    int sceneWidth = 0;
+    int sceneHeight = 0;
+    
+    void init() {
+        glGenFramebuffers(1, &sceneFBO);
+        glGenRenderbuffers(1, &sceneDepth);
+        glGenVertexArrays(1, &emptyVAO);
+    }
+    
+    void addPass(const PostPass& pass) { passes.push_back(pass); }
+    
+    // Gabungkan pass pointwise ke pass sebelumnya lalu compile satu
+    // program per kelompok. Dipanggil sekali setelah semua addPass.
+    void compile() {
+        std::map<std::string, int> readers;
+        for (const PostPass& pass : passes) {
+            for (const std::string& input : pass.inputs) readers[input]++;
+        }
+        
+        groups.clear();
+        for (int i = 0; i < (int)passes.size(); i++) {
+            const PostPass& pass = passes[i];
+            if (pass.pointwise && !groups.empty()) {
+                Group& last = groups.back();
+                const PostPass& previous = passes[last.passes.back()];
+                // Output pass sebelumnya cukup hidup di register jika hanya
+                // dibaca pass ini pada pixel yang sama dan resolusi sama
+                if (!previous.output.empty() && pass.inputs[0] == previous.output &&
+                    pass.scale == previous.scale && readers[previous.output] == 1) {
+                    last.passes.push_back(i);
+                    last.output = pass.output;
+                    last.format = pass.format;
+                    continue;
+                }
+            }
+            Group group;
+            group.passes.push_back(i);
+            group.output = pass.output;
+            group.scale = pass.scale;
+            group.format = pass.format;
+            groups.push_back(group);
+        }
+        
+        // Resource yang dibaca tiap kelompok dan kelompok pembaca terakhirnya
+        lastReader.clear();
+        std::string_view vertexCode = shaderPreprocessor().expand("shaders/deferred_vertex.glsl");
+        for (int g = 0; g < (int)groups.size(); g++) {
+            Group& group = groups[g];
+            for (size_t k = 0; k < group.passes.size(); k++) {
+                const PostPass& pass = passes[group.passes[k]];
+                for (size_t in = (k == 0 ? 0 : 1); in < pass.inputs.size(); in++) {
+                    const std::string& name = pass.inputs[in];
+                    if (std::find(group.samplers.begin(), group.samplers.end(), name) == group.samplers.end())
+                        group.samplers.push_back(name);
+                    lastReader[name] = g;
+                }
+            }
+            // Lokasi sampler dibaca saat pertama dijalankan (setelah finish):
+            // query sekarang akan menunggu link yang masih berjalan
+            group.program = shaderCompiler().submit(vertexCode, generateSource(group));
+            group.samplerLocations.clear();
+        }
+        
+        // Kelompok resample hanya bisa dilewati jika satu-satunya input
+        // dihasilkan kelompok tepat sebelumnya pada resolusi scene
+        resampleGroup = -1;
+        if (groups.size() >= 2) {
+            const Group& last = groups.back();
+            const Group& source = groups[groups.size() - 2];
+            const PostPass& pass = passes[last.passes[0]];
+            if (pass.resample && last.passes.size() == 1 && last.output.empty() &&
+                pass.inputs.size() == 1 && pass.inputs[0] == source.output &&
+                source.scale == 1.0f && readers[source.output] == 1) {
+                resampleGroup = (int)groups.size() - 1;
+            }
+        }
+        
+        std::cout << "Post-process: " << passes.size() << " pass digabung menjadi "
+                  << groups.size() << " round trip" << std::endl;
+    }
+    
+    // Bind target HDR scene (dibuat ulang jika ukuran berubah)
+    void beginScene(int w, int h) {
+        if (w != sceneWidth || h != sceneHeight) {
+            sceneWidth = w;
+            sceneHeight = h;
+            if (sceneColor) glDeleteTextures(1, &sceneColor);
+            glGenTextures(1, &sceneColor);
+            glBindTexture(GL_TEXTURE_2D, sceneColor);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, w, h, 0, GL_RGBA, GL_FLOAT, NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glBindRenderbuffer(GL_RENDERBUFFER, sceneDepth);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            
+            glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sceneColor, 0);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, sceneDepth);
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "ERROR::POST::SCENE_TARGET_INCOMPLETE" << std::endl;
+            }
+            // Target perantara ukuran lama tidak terpakai lagi
+            pool.clear();
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, sceneFBO);
+        glViewport(0, 0, w, h);
+    }
+    
+    unsigned int sceneFramebuffer() const { return sceneFBO; }
+    
+    // Jalankan semua kelompok pass; kelompok terakhir menulis ke layar.
+    // Scene seukuran layar (skala 1.0 atau --fixed-res): kelompok resample
+    // dilewati dan kelompok sebelumnya yang menulis ke layar.
+    void execute(int screenWidth, int screenHeight) {
+        glDisable(GL_DEPTH_TEST);
+        glBindVertexArray(emptyVAO);
+        
+        bool skipResample = resampleGroup >= 0 && sceneWidth == screenWidth && sceneHeight == screenHeight;
+        int groupCount = skipResample ? resampleGroup : (int)groups.size();
+        lastRoundTrips = groupCount;
+        
+        std::map<std::string, int> live;   // resource -> indeks pool
+        for (int g = 0; g < groupCount; g++) {
+            Group& group = groups[g];
+            int target = -1;
+            if (group.output.empty() || (skipResample && g == groupCount - 1)) {
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                glViewport(0, 0, screenWidth, screenHeight);
+            } else {
+                int w = std::max(1, (int)(sceneWidth * group.scale));
+                int h = std::max(1, (int)(sceneHeight * group.scale));
+                target = pool.acquire(w, h, group.format);
+                glBindFramebuffer(GL_FRAMEBUFFER, pool.get(target).framebuffer);
+                glViewport(0, 0, w, h);
+            }
+            
+            shaderCompiler().finish(group.program);
+            if (group.samplerLocations.size() != group.samplers.size()) {
+                for (const std::string& name : group.samplers) {
+                    group.samplerLocations.push_back(
+                        glGetUniformLocation(group.program, (name + "Texture").c_str()));
+                }
+            }
+            glUseProgram(group.program);
+            for (size_t s = 0; s < group.samplers.size(); s++) {
+                const std::string& name = group.samplers[s];
+                glActiveTexture(GL_TEXTURE0 + (int)s);
+                glBindTexture(GL_TEXTURE_2D, name == "scene" ? sceneColor : pool.get(live[name]).texture);
+                glUniform1i(group.samplerLocations[s], (int)s);
+            }
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+            
+            // Input yang tidak dibaca lagi dikembalikan ke pool, begitu juga
+            // output yang tidak punya pembaca (tidak ditahan sampai frame berikutnya)
+            for (const std::string& name : group.samplers) {
+                if (name != "scene" && lastReader[name] == g) pool.release(live[name]);
+            }
+            if (target >= 0) {
+                auto reader = lastReader.find(group.output);
+                if (reader != lastReader.end() && reader->second > g) live[group.output] = target;
+                else pool.release(target);
+            }
+        }
+        
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(0);
+        glEnable(GL_DEPTH_TEST);
+    }
+    
+    size_t passCount() const { return passes.size(); }
+    size_t groupCount() const { return groups.size(); }
+    int roundTrips() const { return lastRoundTrips; }   // Kelompok yang dijalankan frame terakhir
+    size_t pooledTargets() const { return pool.size(); }
+    
+    void cleanup() {
+        for (const Group& group : groups) glDeleteProgram(group.program);
+        pool.clear();
+        if (sceneColor) glDeleteTextures(1, &sceneColor);
+        glDeleteRenderbuffers(1, &sceneDepth);
+        glDeleteFramebuffers(1, &sceneFBO);
+        glDeleteVertexArrays(1, &emptyVAO);
+    }
+    
+private:
+    struct Group {
+        std::vector<int> passes;
+        std::vector<std::string> samplers;   // Resource yang dibaca
+        std::vector<int> samplerLocations;
+        std::string output;
+        float scale = 1.0f;
+        GLenum format = GL_RGBA8;
+        unsigned int program = 0;
+    };
+    
+    std::vector<PostPass> passes;
+    std::vector<Group> groups;
+    std::map<std::string, int> lastReader;
+    int resampleGroup = -1;   // Kelompok yang dilewati saat scene seukuran layar
+    int lastRoundTrips = 0;
+    TexturePool pool;
+    unsigned int sceneFBO = 0, sceneColor = 0, sceneDepth = 0;
+    unsigned int emptyVAO = 0;
+    
+    // Fragment shader satu kelompok: snippet (tiap file sekali) lalu
+    // pemanggilan fungsi berantai di main()
+    std::string generateSource(const Group& group) const {
+        std::string source = "#version 330 core\n\nin vec2 TexCoord;\nout vec4 FragColor;\n\n";
+        for (const std::string& name : group.samplers) source += "uniform sampler2D " + name + "Texture;\n";
+        
+        std::vector<std::string> files;
+        for (int p : group.passes) {
+            if (std::find(files.begin(), files.end(), passes[p].file) != files.end()) continue;
+            files.push_back(passes[p].file);
+            source += "\n";
+            source.append(readShaderFile(passes[p].file.c_str()));
+            source += "\n";
+        }
+        
+        source += "void main()\n{\n    vec4 color;\n";
+        for (size_t k = 0; k < group.passes.size(); k++) {
+            const PostPass& pass = passes[group.passes[k]];
+            std::string args;
+            if (k > 0) args = "color";
+            else if (pass.pointwise) args = "texture(" + pass.inputs[0] + "Texture, TexCoord)";
+            else args = pass.inputs[0] + "Texture";
+            for (size_t in = 1; in < pass.inputs.size(); in++) args += ", " + pass.inputs[in] + "Texture";
+            source += "    color = " + pass.function + "(" + args + ");\n";
+        }
+        source += "    FragColor = color;\n}\n";
+        return source;
+    }
+};
+
+// Rantai efek ruangan: bloom setengah resolusi, lalu komposit + tone
+// mapping + color grading (digabung jadi satu pass), FXAA, dan upscale
+// dari resolusi scene (dinamis) ke layar
+void addRoomPostPasses(PostProcessGraph& graph) {
+    graph.addPass({"bloomBright", "shaders/post/bloom.glsl", {"scene"}, "bloomBright", 0.5f, GL_RGBA16F, false});
+    graph.addPass({"bloomBlurHorizontal", "shaders/post/bloom.glsl", {"bloomBright"}, "bloomBlurH", 0.5f, GL_RGBA16F, false});
+    graph.addPass({"bloomBlurVertical", "shaders/post/bloom.glsl", {"bloomBlurH"}, "bloom", 0.5f, GL_RGBA16F, false});
+    graph.addPass({"bloomComposite", "shaders/post/bloom.glsl", {"scene", "bloom"}, "hdr", 1.0f, GL_RGBA16F, true});
+    graph.addPass({"tonemap", "shaders/post/tonemap.glsl", {"hdr"}, "ldr", 1.0f, GL_RGBA8, true});
+    graph.addPass({"colorGrade", "shaders/post/color_grade.glsl", {"ldr"}, "graded", 1.0f, GL_RGBA8, true});
+    graph.addPass({"fxaa", "shaders/post/fxaa.glsl", {"graded"}, "antialiased", 1.0f, GL_RGBA8, false});
+    graph.addPass({"upscale", "shaders/post/upscale.glsl", {"antialiased"}, "", 1.0f, GL_RGBA8, false, true});
+}
+
+// =====================================================================
+// RESOLUSI DINAMIS (DIKENDALIKAN TIMER QUERY GPU)
+// =====================================================================
+// Waktu GPU per frame diukur dengan query GL_TIME_ELAPSED. Hasil dibaca
+// beberapa frame kemudian (ring query) agar CPU tidak menunggu GPU.
+// Skala render scene disesuaikan untuk menjaga target waktu frame, lalu
+// pass upscale post-process membawa hasilnya ke resolusi layar penuh.
+// Skala dikuantisasi dan diberi jeda agar target tidak dibuat ulang
+// setiap frame.
+bool dynamicResolutionEnabled = true;
+float targetFrameMs = 16.6f;   // --target-ms
+float fixedRenderScale = 0.0f; // --render-scale (0 = adaptif)
+
+class DynamicResolution {
+public:
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    float scaleStep = 0.05f;     // Kuantisasi skala
+    int cooldownFrames = 15;     // Jeda minimum antar perubahan skala
+    
+    float scale = 1.0f;
+    float gpuMs = 0.0f;          // Waktu GPU terakhir yang terbaca (dihaluskan)
+    
+    void init() {
+        glGenQueries(QUERY_COUNT, queries);
+        if (fixedRenderScale > 0.0f) {
+            scale = glm::clamp(fixedRenderScale, 0.1f, 2.0f);
+            adaptive = false;
+        }
+    }
+    
+    void beginFrame() {
+        // Baca query tertua di ring jika GPU sudah selesai
+        int slot = frame % QUERY_COUNT;
+        if (frame >= QUERY_COUNT) {
+            GLint available = 0;
+            glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint64 elapsed = 0;
+                glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &elapsed);
+                // Nilai > 1 detik dianggap bacaan driver yang rusak
+                float ms = (float)(elapsed / 1.0e6);
+                if (ms < 1000.0f) {
+                    gpuMs = gpuMs == 0.0f ? ms : gpuMs * 0.8f + ms * 0.2f;
+                    if (adaptive) adjust();
+                }
+            }
+        }
+        glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+    }
+    
+    void endFrame() {
+        glEndQuery(GL_TIME_ELAPSED);
+        frame++;
+    }
+    
+    // Ukuran render scene untuk ukuran layar ini
+    void renderSize(int screenWidth, int screenHeight, int& width, int& height) const {
+        width = std::max(1, (int)(screenWidth * scale + 0.5f));
+        height = std::max(1, (int)(screenHeight * scale + 0.5f));
+    }
+    
+    void cleanup() {
+        glDeleteQueries(QUERY_COUNT, queries);
+    }
+    
+private:
+    static const int QUERY_COUNT = 4;
+    unsigned int queries[QUERY_COUNT] = {};
+    long long frame = 0;
+    long long lastChange = 0;
+    bool adaptive = true;
+    
+    void adjust() {
+        if (frame - lastChange < cooldownFrames) return;
+        // Biaya kira-kira sebanding jumlah pixel (skala kuadrat); sisakan
+        // 10% ruang agar tidak berosilasi di sekitar target
+        float desired = scale * std::sqrt(targetFrameMs * 0.9f / std::max(gpuMs, 0.01f));
+        desired = glm::clamp(desired, minScale, maxScale);
+        float quantized = glm::clamp(std::floor(desired / scaleStep + 0.5f) * scaleStep, minScale, maxScale);
+        // Naik hanya jika jelas ada ruang; turun segera jika melewati target
+        bool over = gpuMs > targetFrameMs;
+        if ((over && quantized < scale) || (!over && quantized > scale + scaleStep * 0.5f)) {
+            std::cout << "Resolusi dinamis: skala " << scale << " -> " << quantized
+                      << " (GPU " << gpuMs << " ms, target " << targetFrameMs << " ms)" << std::endl;
+            scale = quantized;
+            lastChange = frame;
+        }
+    }
+};
+
+// =====================================================================
+// BAKE PENCAHAYAAN PER VERTEX (DIRECT + INDIRECT)
+// =====================================================================
+// Objek statis tidak pernah bergerak dan lampu utama hanya punya dua
+// state, sehingga pencahayaan diffuse-nya bisa dihitung sekali saat load:
+// - Direct: lampu utama dengan ray bayangan terhadap BVH scene
+// - Indirect: satu pantulan, sampel hemisphere cosine-weighted, warna
+//   permukaan yang terkena ray dikalikan cahaya direct di titik itu
+// Hasil disimpan per vertex untuk kedua state lampu dan di-cache di disk
+// dengan kunci hash scene. Permukaan besar dipecah dulu agar gradasi
+// cahaya dan bayangan tertangkap resolusi vertex.
+
+// Pecah segitiga yang sisinya lebih panjang dari maxEdge (midpoint 1->4,
+// berulang). Urutan segitiga dipertahankan sehingga rentang detail part
+// tetap valid setelah dipetakan ulang.
+void subdivideLargeTriangles(Object3D& obj, float maxEdge) {
+    std::vector<Vertex> result;
+    std::vector<int> newFirstTriangle(obj.vertices.size() / 3 + 1);
+    std::vector<Vertex> pending;
+    for (size_t t = 0; t < obj.vertices.size() / 3; t++) {
+        newFirstTriangle[t] = (int)result.size() / 3;
+        pending.assign(obj.vertices.begin() + t * 3, obj.vertices.begin() + t * 3 + 3);
+        while (!pending.empty()) {
+            Vertex a = pending[pending.size() - 3];
+            Vertex b = pending[pending.size() - 2];
+            Vertex c = pending[pending.size() - 1];
+            pending.resize(pending.size() - 3);
+            float longest = std::max(glm::length(a.position - b.position),
+                            std::max(glm::length(b.position - c.position),
+                                     glm::length(c.position - a.position)));
+            if (longest <= maxEdge) {
+                result.push_back(a);
+                result.push_back(b);
+                result.push_back(c);
+                continue;
+            }
+            auto mid = [](const Vertex& p, const Vertex& q) {
+                Vertex m = p;
+                m.position = (p.position + q.position) * 0.5f;
+                m.color = (p.color + q.color) * 0.5f;
+                return m;
+            };
+            Vertex ab = mid(a, b), bc = mid(b, c), ca = mid(c, a);
+            // Dimasukkan terbalik agar keluar dari stack sesuai urutan asli
+            Vertex children[12] = {ab, bc, ca,  ca, bc, c,  ab, b, bc,  a, ab, ca};
+            pending.insert(pending.end(), children, children + 12);
+        }
+    }
+    newFirstTriangle.back() = (int)result.size() / 3;
+    
+    for (DetailPart& part : obj.detailParts) {
+        int first = newFirstTriangle[part.authorFirst / 3] * 3;
+        int last = newFirstTriangle[(part.authorFirst + part.authorCount) / 3] * 3;
+        part.authorFirst = first;
+        part.authorCount = last - first;
+    }
+    obj.vertices.swap(result);
+}
+
+// Titik sampel bake untuk vertex v (world space): digeser sedikit ke tengah
+// segitiga dan keluar permukaan agar tidak memotong geometri yang
+// bersentuhan. Mengembalikan seed dari posisi sudut (dikuantisasi 1 mm)
+// dan normal: vertex yang berimpit memakai sampel sama sehingga noise
+// tidak putus antar segitiga.
+uint32_t bakeSamplePoint(const Object3D& obj, int v, glm::vec3& point, glm::vec3& normal) {
+    glm::mat4 model = obj.getModelMatrix();
+    glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
+    int tri = v / 3;
+    glm::vec3 centroid = (obj.vertices[tri * 3].position + obj.vertices[tri * 3 + 1].position
+                          + obj.vertices[tri * 3 + 2].position) / 3.0f;
+    glm::vec3 local = glm::mix(obj.vertices[v].position, centroid, 0.02f);
+    normal = glm::normalize(normalMatrix * obj.vertices[v].normal);
+    point = glm::vec3(model * glm::vec4(local, 1.0f)) + normal * 0.002f;
+    
+    glm::vec3 corner = glm::vec3(model * glm::vec4(obj.vertices[v].position, 1.0f));
+    glm::ivec3 cell = glm::ivec3(glm::round(corner * 1000.0f));
+    glm::ivec3 facing = glm::ivec3(glm::round(normal * 8.0f));
+    return (uint32_t)(cell.x * 73856093) ^ (uint32_t)(cell.y * 19349663)
+         ^ (uint32_t)(cell.z * 83492791) ^ (uint32_t)(facing.x * 2654435761u)
+         ^ (uint32_t)(facing.y * 40503) ^ (uint32_t)(facing.z * 1181783497u);
+}
+
+// Arah acak cosine-weighted di hemisphere sekitar normal (LCG per vertex)
+glm::vec3 cosineHemisphereSample(glm::vec3 normal, uint32_t& rng) {
+    glm::vec3 tangent = std::fabs(normal.y) < 0.99f
+        ? glm::normalize(glm::cross(normal, glm::vec3(0.0f, 1.0f, 0.0f)))
+        : glm::normalize(glm::cross(normal, glm::vec3(1.0f, 0.0f, 0.0f)));
+    glm::vec3 bitangent = glm::cross(normal, tangent);
+    rng = rng * 1664525u + 1013904223u;
+    float r = std::sqrt((rng >> 8) * (1.0f / 16777216.0f));
+    rng = rng * 1664525u + 1013904223u;
+    float phi = 6.2831853f * ((rng >> 8) * (1.0f / 16777216.0f));
+    return glm::normalize(tangent * (r * std::cos(phi)) + bitangent * (r * std::sin(phi))
+                          + normal * std::sqrt(std::max(0.0f, 1.0f - r * r)));
+}
+
+class VertexLightBaker {
+public:
+    int indirectSamples = 64;
+    float indirectScale = 0.6f;
+    glm::vec3 color = lightColor;   // Warna lampu utama saat menyala
+    
+    // Statistik bake terakhir
+    int bakedVertices = 0;
+    long long raysCast = 0;
+    bool loadedFromCache = false;
+    
+    // Hash seluruh input bake: geometri + transform objek statis, posisi
+    // dan parameter lampu, serta pengaturan sampel
+    uint64_t sceneHash(const std::vector<Object3D>& objects, glm::vec3 light) const {
+        SceneHasher hash;
+        const uint32_t version = 2;
+        hash.mix(&version, sizeof(version));
+        hash.mix(&indirectSamples, sizeof(indirectSamples));
+        hash.mix(&indirectScale, sizeof(indirectScale));
+        hash.mix(&light, sizeof(light));
+        for (int state = 0; state < 2; state++) {
+            LightingParams params = lightingParams(state == 1, color);
+            hash.mix(&params, sizeof(params));
+        }
+        hash.mixStaticObjects(objects);
+        return hash.value;
+    }
+    
+    // Isi bakedLight semua objek statis, dari cache jika hash cocok
+    void bake(std::vector<Object3D>& objects, glm::vec3 light, ThreadPool& pool,
+              const std::string& cacheDir = "cache") {
+        if (begin(objects, light, cacheDir)) return;
+        bakeObjects(objects, 0, objects.size(), pool);
+        finish(objects);
+    }
+    
+    // Bake bertahap (thread loader): begin() mencoba cache (true = semua
+    // objek sudah terisi) atau menyiapkan penghalang dari seluruh scene,
+    // bakeObjects() mengisi objek [first, last) sehingga objek itu bisa
+    // ditampilkan lebih dulu, finish() menyimpan cache.
+    bool begin(std::vector<Object3D>& objects, glm::vec3 light, const std::string& cacheDir = "cache") {
+        cacheHash = sceneHash(objects, light);
+        char fileName[64];
+        std::snprintf(fileName, sizeof(fileName), "/bake_%016llx.bin", (unsigned long long)cacheHash);
+        cacheFolder = cacheDir;
+        cachePath = cacheDir + fileName;
+        
+        loadedFromCache = loadCache(cachePath, cacheHash, objects);
+        if (loadedFromCache) return true;
+        prepare(objects, light);
+        return false;
+    }
+    
+    void finish(const std::vector<Object3D>& objects) {
+        occluders.clear();
+        if (!loadedFromCache && !cacheFolder.empty()) saveCache(cacheFolder, cachePath, cacheHash, objects);
+    }
+    
+    // Bake tanpa cache (dipakai juga oleh benchmark)
+    void bakeAll(std::vector<Object3D>& objects, glm::vec3 light, ThreadPool& pool) {
+        prepare(objects, light);
+        bakeObjects(objects, 0, objects.size(), pool);
+        occluders.clear();
+    }
+    
+    void bakeObjects(std::vector<Object3D>& objects, size_t first, size_t last, ThreadPool& pool) {
+        glm::vec3 light = lightPosition;
+        
+        // Daftar pekerjaan: setiap vertex objek statis dalam world space
+        struct Sample {
+            Object3D* object;
+            int vertex;
+        };
+        std::vector<Sample> work;
+        for (size_t i = first; i < last; i++) {
+            Object3D& obj = objects[i];
+            for (auto& states : obj.bakedLight) states.clear();
+            if (obj.isDynamic) continue;
+            obj.bakedLight[0].resize(obj.vertices.size());
+            obj.bakedLight[1].resize(obj.vertices.size());
+            for (int v = 0; v < (int)obj.vertices.size(); v++) work.push_back({&obj, v});
+        }
+        bakedVertices += (int)work.size();
+        
+        LightingParams states[2] = {lightingParams(false, color), lightingParams(true, color)};
+        std::atomic<long long> rays{0};
+        const int chunk = 64;
+        int chunkCount = ((int)work.size() + chunk - 1) / chunk;
+        pool.parallelFor(chunkCount, [&](int c) {
+            long long localRays = 0;
+            int end = std::min((int)work.size(), (c + 1) * chunk);
+            for (int w = c * chunk; w < end; w++) {
+                Object3D& obj = *work[w].object;
+                int v = work[w].vertex;
+                glm::vec3 point, normal;
+                uint32_t seed = bakeSamplePoint(obj, v, point, normal);
+                
+                float direct = directTerm(occluders, point, normal, light, localRays);
+                glm::vec3 indirect = indirectTerm(occluders, point, normal, light, seed, localRays);
+                for (int state = 0; state < 2; state++) {
+                    const LightingParams& p = states[state];
+                    obj.bakedLight[state][v] = p.color * (p.ambient + p.diffuse * direct
+                                                          + p.diffuse * indirectScale * indirect);
+                }
+            }
+            rays += localRays;
+        });
+        raysCast += rays;
+    }
+    
+private:
+    PickScene occluders;          // Penghalang bake bertahap (begin..finish)
+    glm::vec3 lightPosition{0.0f};
+    uint64_t cacheHash = 0;
+    std::string cacheFolder, cachePath;
+    
+    // Penghalang: semua objek statis yang memberi bayangan
+    void prepare(std::vector<Object3D>& objects, glm::vec3 light) {
+        lightPosition = light;
+        bakedVertices = 0;
+        raysCast = 0;
+        occluders.clear();
+        for (auto& obj : objects) {
+            if (!obj.isDynamic && obj.castsShadow) occluders.addObject(obj);
+        }
+        occluders.build();
+    }
+    
+    // Cahaya direct (tanpa warna/kekuatan) di titik dengan normal tertentu
+    static float directTerm(const PickScene& occluders, glm::vec3 point, glm::vec3 normal,
+                            glm::vec3 light, long long& rays) {
+        glm::vec3 toLight = light - point;
+        float distance = glm::length(toLight);
+        glm::vec3 dir = toLight / distance;
+        float cosine = glm::dot(normal, dir);
+        if (cosine <= 0.0f) return 0.0f;
+        rays++;
+        Ray ray = {point, dir};
+        PickHit hit;
+        if (occluders.raycast(ray, hit, distance - 0.01f)) return 0.0f;
+        return cosine;
+    }
+    
+    // Rata-rata cahaya pantulan pertama dari sampel hemisphere cosine-weighted
+    glm::vec3 indirectTerm(const PickScene& occluders, glm::vec3 point, glm::vec3 normal,
+                           glm::vec3 light, uint32_t seed, long long& rays) const {
+        uint32_t rng = seed;
+        glm::vec3 total(0.0f);
+        for (int s = 0; s < indirectSamples; s++) {
+            glm::vec3 dir = cosineHemisphereSample(normal, rng);
+            rays++;
+            PickHit hit;
+            if (!occluders.raycast({point, dir}, hit)) continue;
+            
+            // Warna dan normal segitiga yang terkena (normal menghadap ray)
+            const Object3D& other = *hit.object;
+            const Vertex* tri = &other.vertices[hit.triangle * 3];
+            glm::vec3 albedo = (tri[0].color + tri[1].color + tri[2].color) / 3.0f;
+            glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(other.getModelMatrix())));
+            glm::vec3 hitNormal = glm::normalize(normalMatrix * tri[0].normal);
+            if (glm::dot(hitNormal, dir) > 0.0f) hitNormal = -hitNormal;
+            glm::vec3 hitPoint = hit.point + hitNormal * 0.002f;
+            total += albedo * directTerm(occluders, hitPoint, hitNormal, light, rays);
+        }
+        return total / (float)std::max(indirectSamples, 1);
+    }
+    
+    bool loadCache(const std::string& path, uint64_t hash, std::vector<Object3D>& objects) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        char magic[4];
+        uint64_t storedHash = 0;
+        uint32_t vertexCount = 0;
+        file.read(magic, 4);
+        file.read((char*)&storedHash, sizeof(storedHash));
+        file.read((char*)&vertexCount, sizeof(vertexCount));
+        if (!file || std::memcmp(magic, "BAKE", 4) != 0 || storedHash != hash) return false;
+        
+        uint32_t expected = 0;
+        for (auto& obj : objects) {
+            if (!obj.isDynamic) expected += (uint32_t)obj.vertices.size();
+        }
+        if (vertexCount != expected) return false;
+        
+        for (auto& obj : objects) {
+            for (auto& states : obj.bakedLight) states.clear();
+            if (obj.isDynamic) continue;
+            for (auto& states : obj.bakedLight) {
+                states.resize(obj.vertices.size());
+                file.read((char*)states.data(), states.size() * sizeof(glm::vec3));
+            }
+        }
+        bakedVertices = (int)vertexCount;
+        raysCast = 0;
+        return (bool)file;
+    }
+    
+    void saveCache(const std::string& dir, const std::string& path, uint64_t hash,
+                   const std::vector<Object3D>& objects) const {
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "WARNING::BAKE::CACHE_NOT_WRITTEN " << path << std::endl;
+            return;
+        }
+        uint32_t vertexCount = (uint32_t)bakedVertices;
+        file.write("BAKE", 4);
+        file.write((const char*)&hash, sizeof(hash));
+        file.write((const char*)&vertexCount, sizeof(vertexCount));
+        for (const auto& obj : objects) {
+            if (obj.isDynamic) continue;
+            for (const auto& states : obj.bakedLight) {
+                file.write((const char*)states.data(), states.size() * sizeof(glm::vec3));
+            }
+        }
+    }
+};
+
+// =====================================================================
+// AMBIENT OCCLUSION PER VERTEX (BAKE SAAT LOAD)
+// =====================================================================
+// Untuk setiap vertex objek statis, sampel hemisphere pendek (radius
+// aoRadius) ditembakkan ke segitiga penghalang. Ray dari satu vertex
+// berangkat dari titik yang sama, sehingga diproses sebagai paket 4 ray:
+// uji ray/box node BVH dikerjakan sekaligus dengan SSE (fallback skalar
+// di platform tanpa SSE2). Hasil disimpan per instance di
+// Object3D::bakedAO (buffer atribut 4 sendiri, vertex mesh tetap dipakai
+// bersama) dan dipakai shader untuk meredam ambient tanpa biaya runtime
+// tambahan. Biaya bake = vertex statis x sampel, jadi scene besar dibatasi
+// anggaran ray: sampel per vertex diturunkan (minimal MIN_SAMPLES) sampai
+// muat, dan jika masih melebihi anggaran bake dilewati (ambient memakai
+// Vertex::ao) agar load scene tidak tertahan puluhan detik.
+bool aoEnabled = true;
+long long aoRayBudget = 16000000;      // --ao-budget <juta ray>, 0 = tanpa batas
+
+struct RayPacket4 {
+    float originX[4], originY[4], originZ[4];
+    float invDirX[4], invDirY[4], invDirZ[4];
+    float tMax[4];
+};
+
+// Bitmask ray dalam paket yang mengenai box sebelum tMax masing-masing
+inline int intersectPacketAABB(const RayPacket4& packet, const AABB& box) {
+#ifdef ROOM_SIMD_SSE
+    __m128 ox = _mm_loadu_ps(packet.originX), oy = _mm_loadu_ps(packet.originY),
+           oz = _mm_loadu_ps(packet.originZ);
+    __m128 ix = _mm_loadu_ps(packet.invDirX), iy = _mm_loadu_ps(packet.invDirY),
+           iz = _mm_loadu_ps(packet.invDirZ);
+    __m128 x0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.x), ox), ix);
+    __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.x), ox), ix);
+    __m128 y0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.y), oy), iy);
+    __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.y), oy), iy);
+    __m128 z0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min.z), oz), iz);
+    __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max.z), oz), iz);
+    __m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(x0, x1), _mm_min_ps(y0, y1)),
+                              _mm_max_ps(_mm_min_ps(z0, z1), _mm_setzero_ps()));
+    __m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(x0, x1), _mm_max_ps(y0, y1)),
+                             _mm_min_ps(_mm_max_ps(z0, z1), _mm_loadu_ps(packet.tMax)));
+    return _mm_movemask_ps(_mm_cmple_ps(enter, exit));
+#else
+    int mask = 0;
+    for (int i = 0; i < 4; i++) {
+        glm::vec3 origin(packet.originX[i], packet.originY[i], packet.originZ[i]);
+        glm::vec3 invDir(packet.invDirX[i], packet.invDirY[i], packet.invDirZ[i]);
+        if (intersectRayAABB(origin, invDir, box, packet.tMax[i]) < 1e30f) mask |= 1 << i;
+    }
+    return mask;
+#endif
+}
+
+// Segitiga penghalang dalam world space + BVH, untuk query paket ray
+class OcclusionScene {
+public:
+    void build(const std::vector<Object3D>& objects) {
+        std::vector<glm::vec3> world;
+        for (const Object3D& obj : objects) {
+            if (obj.isDynamic || !obj.castsShadow) continue;
+            glm::mat4 model = obj.getModelMatrix();
+            for (const Vertex& v : obj.vertices) world.push_back(glm::vec3(model * glm::vec4(v.position, 1.0f)));
+        }
+        size_t triCount = world.size() / 3;
+        std::vector<AABB> bounds(triCount);
+        for (size_t t = 0; t < triCount; t++) {
+            bounds[t].expand(world[t * 3]);
+            bounds[t].expand(world[t * 3 + 1]);
+            bounds[t].expand(world[t * 3 + 2]);
+        }
+        bvh.build(bounds);
+        
+        // Simpan segitiga sesuai urutan leaf
+        triangles.resize(triCount * 3);
+        for (size_t i = 0; i < triCount; i++) {
+            int tri = bvh.primIndices[i];
+            for (int k = 0; k < 3; k++) triangles[i * 3 + k] = world[tri * 3 + k];
+        }
+    }
+    
+    // Jarak hit terdekat per ray (tetap tMax awal jika tidak kena)
+    void closestHits(RayPacket4& packet, const glm::vec3 directions[4]) const {
+        if (bvh.nodes.empty()) return;
+        BVHStack stack(bvh);
+        stack.push(0);
+        while (!stack.empty()) {
+            const BVHNode& node = bvh.nodes[stack.pop()];
+            int mask = intersectPacketAABB(packet, node.bounds);
+            if (!mask) continue;
+            
+            if (node.count > 0) {
+                for (int i = node.leftFirst; i < node.leftFirst + node.count; i++) {
+                    for (int r = 0; r < 4; r++) {
+                        if (!(mask & (1 << r))) continue;
+                        Ray ray = {glm::vec3(packet.originX[r], packet.originY[r], packet.originZ[r]),
+                                   directions[r]};
+                        float t;
+                        if (intersectRayTriangle(ray, triangles[i * 3], triangles[i * 3 + 1],
+                                                 triangles[i * 3 + 2], t) && t < packet.tMax[r]) {
+                            packet.tMax[r] = t;
+                        }
+                    }
+                }
+            } else {
+                stack.push(node.leftFirst + 1);
+                stack.push(node.leftFirst);
+            }
+        }
+    }
+    
+private:
+    BVH bvh;
+    std::vector<glm::vec3> triangles;
+};
+
+class AmbientOcclusionBaker {
+public:
+    int samples = 64;            // Kelipatan 4 (satu paket)
+    float aoRadius = 0.6f;       // Penghalang lebih jauh tidak dihitung
+    
+    static const int MIN_SAMPLES = 8;
+    
+    int bakedVertices = 0;
+    long long raysCast = 0;
+    bool loadedFromCache = false;
+    bool skipped = false;         // Melebihi aoRayBudget bahkan dengan MIN_SAMPLES
+    
+    // Turunkan samples agar vertex statis x samples muat di anggaran;
+    // false jika tidak muat bahkan dengan MIN_SAMPLES
+    bool fitRayBudget(const std::vector<Object3D>& objects, long long budget) {
+        long long vertices = 0;
+        for (const auto& obj : objects) {
+            if (!obj.isDynamic) vertices += (long long)obj.vertices.size();
+        }
+        if (budget <= 0 || vertices * samples <= budget) return true;
+        int fitted = (int)std::min<long long>(budget / vertices, samples) & ~3;
+        if (fitted < MIN_SAMPLES) return false;
+        samples = fitted;
+        return true;
+    }
+    
+    uint64_t sceneHash(const std::vector<Object3D>& objects) const {
+        SceneHasher hash;
+        const uint32_t version = 2;
+        hash.mix(&version, sizeof(version));
+        hash.mix(&samples, sizeof(samples));
+        hash.mix(&aoRadius, sizeof(aoRadius));
+        hash.mixStaticObjects(objects);
+        return hash.value;
+    }
+    
+    // Isi bakedAO semua objek statis, dari cache jika hash cocok
+    void bake(std::vector<Object3D>& objects, ThreadPool& pool, const std::string& cacheDir = "cache") {
+        if (begin(objects, cacheDir)) return;
+        bakeObjects(objects, 0, objects.size(), pool);
+        finish(objects);
+    }
+    
+    // Bake bertahap (thread loader): begin() mencoba cache (true = semua
+    // objek sudah terisi, atau bake dilewati karena anggaran ray) atau
+    // membangun penghalang dari seluruh scene, bakeObjects() mengisi objek
+    // [first, last), finish() menyimpan cache. Vertex tidak pernah ditulis,
+    // jadi tetap dipakai bersama prototype.
+    bool begin(std::vector<Object3D>& objects, const std::string& cacheDir = "cache") {
+        for (auto& obj : objects) obj.bakedAO.clear();
+        skipped = !fitRayBudget(objects, aoRayBudget);
+        if (skipped) {
+            cacheFolder.clear();
+            return true;
+        }
+        cacheHash = sceneHash(objects);
+        char fileName[64];
+        std::snprintf(fileName, sizeof(fileName), "/ao_%016llx.bin", (unsigned long long)cacheHash);
+        cacheFolder = cacheDir;
+        cachePath = cacheDir + fileName;
+        
+        loadedFromCache = loadCache(cachePath, cacheHash, objects);
+        if (loadedFromCache) return true;
+        prepare(objects);
+        return false;
+    }
+    
+    void finish(const std::vector<Object3D>& objects) {
+        occluders = OcclusionScene();
+        if (!loadedFromCache && !cacheFolder.empty()) saveCache(cacheFolder, cachePath, cacheHash, objects);
+    }
+    
+    void bakeAll(std::vector<Object3D>& objects, ThreadPool& pool) {
+        prepare(objects);
+        bakeObjects(objects, 0, objects.size(), pool);
+        occluders = OcclusionScene();
+    }
+    
+    void bakeObjects(std::vector<Object3D>& objects, size_t first, size_t last, ThreadPool& pool) {
+        struct Sample {
+            Object3D* object;
+            int vertex;
+        };
+        std::vector<Sample> work;
+        for (size_t i = first; i < last; i++) {
+            Object3D& obj = objects[i];
+            if (obj.isDynamic) continue;
+            obj.bakedAO.resize(obj.vertices.size());
+            for (int v = 0; v < (int)obj.vertices.size(); v++) work.push_back({&obj, v});
+        }
+        bakedVertices += (int)work.size();
+        
+        int packets = std::max(samples / 4, 1);
+        const int chunk = 128;
+        int chunkCount = ((int)work.size() + chunk - 1) / chunk;
+        pool.parallelFor(chunkCount, [&](int c) {
+            int end = std::min((int)work.size(), (c + 1) * chunk);
+            for (int w = c * chunk; w < end; w++) {
+                Object3D& obj = *work[w].object;
+                int v = work[w].vertex;
+                glm::vec3 point, normal;
+                uint32_t rng = bakeSamplePoint(obj, v, point, normal);
+                
+                float occlusion = 0.0f;
+                for (int p = 0; p < packets; p++) {
+                    RayPacket4 packet;
+                    glm::vec3 directions[4];
+                    for (int r = 0; r < 4; r++) {
+                        glm::vec3 dir = cosineHemisphereSample(normal, rng);
+                        // Hindari pembagian nol pada slab test
+                        for (int k = 0; k < 3; k++) {
+                            if (std::fabs(dir[k]) < 1e-6f) dir[k] = dir[k] < 0.0f ? -1e-6f : 1e-6f;
+                        }
+                        directions[r] = dir;
+                        packet.originX[r] = point.x;
+                        packet.originY[r] = point.y;
+                        packet.originZ[r] = point.z;
+                        packet.invDirX[r] = 1.0f / dir.x;
+                        packet.invDirY[r] = 1.0f / dir.y;
+                        packet.invDirZ[r] = 1.0f / dir.z;
+                        packet.tMax[r] = aoRadius;
+                    }
+                    occluders.closestHits(packet, directions);
+                    // Penghalang dekat menggelapkan penuh, melemah linear ke radius
+                    for (int r = 0; r < 4; r++) occlusion += 1.0f - packet.tMax[r] / aoRadius;
+                }
+                obj.bakedAO[v] = 1.0f - occlusion / (packets * 4);
+            }
+        });
+        raysCast += (long long)work.size() * packets * 4;
+    }
+    
+private:
+    OcclusionScene occluders;     // Penghalang bake bertahap (begin..finish)
+    uint64_t cacheHash = 0;
+    std::string cacheFolder, cachePath;
+    
+    void prepare(const std::vector<Object3D>& objects) {
+        bakedVertices = 0;
+        raysCast = 0;
+        occluders.build(objects);
+    }
+    
+    bool loadCache(const std::string& path, uint64_t hash, std::vector<Object3D>& objects) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) return false;
+        char magic[4];
+        uint64_t storedHash = 0;
+        uint32_t vertexCount = 0;
+        file.read(magic, 4);
+        file.read((char*)&storedHash, sizeof(storedHash));
+        file.read((char*)&vertexCount, sizeof(vertexCount));
+        if (!file || std::memcmp(magic, "AOBK", 4) != 0 || storedHash != hash) return false;
+        
+        std::vector<float> values(vertexCount);
+        file.read((char*)values.data(), values.size() * sizeof(float));
+        if (!file) return false;
+        size_t expected = 0;
+        for (auto& obj : objects) {
+            if (!obj.isDynamic) expected += obj.vertices.size();
+        }
+        if (expected != vertexCount) return false;
+        
+        size_t next = 0;
+        for (auto& obj : objects) {
+            if (obj.isDynamic) continue;
+            obj.bakedAO.assign(values.begin() + next, values.begin() + next + obj.vertices.size());
+            next += obj.vertices.size();
+        }
+        bakedVertices = (int)vertexCount;
+        raysCast = 0;
+        return true;
+    }
+    
+    void saveCache(const std::string& dir, const std::string& path, uint64_t hash,
+                   const std::vector<Object3D>& objects) const {
+        std::error_code error;
+        std::filesystem::create_directories(dir, error);
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "WARNING::AO::CACHE_NOT_WRITTEN " << path << std::endl;
+            return;
+        }
+        std::vector<float> values;
+        for (const auto& obj : objects) {
+            if (obj.isDynamic) continue;
+            values.insert(values.end(), obj.bakedAO.begin(), obj.bakedAO.end());
+        }
+        uint32_t vertexCount = (uint32_t)values.size();
+        file.write("AOBK", 4);
+        file.write((const char*)&hash, sizeof(hash));
+        file.write((const char*)&vertexCount, sizeof(vertexCount));
+        file.write((const char*)values.data(), values.size() * sizeof(float));
+    }
+};
+
+// =====================================================================
+// IMPORT MODEL (WAVEFRONT OBJ DAN glTF 2.0)
+// =====================================================================
+// File model di-mmap lalu dikonversi langsung ke Vertex (segitiga lepas,
+// sama seperti keluaran builder create*), sehingga hasilnya melewati
+// validasi, cache mesh, dan Object3D::setup yang sama.
+// - OBJ dibagi per blok baris ke worker thread. Pass 1 menghitung v/vn/
+//   segitiga per blok, prefix sum memberi offset global, pass 2 menulis
+//   posisi dan indeks langsung ke array akhir (indeks negatif di-resolve
+//   saat itu juga), pass 3 menyusun vertex per blok segitiga.
+// - glTF (.gltf dengan buffer data URI atau file .bin, dan .glb) memakai
+//   parser JSON kecil. Node hierarchy di-flatten beserta transformnya dan
+//   segitiga setiap primitive dikonversi per blok secara paralel.
+// Normal yang tidak ada di file dibuat flat (per segitiga) atau smooth
+// (rata-rata berbobot luas per posisi). Teks file tidak pernah disalin:
+// memori tambahan hanya posisi, indeks, dan vertex hasil.
+enum NormalMode { NORMALS_SMOOTH, NORMALS_FLAT };
+
+// Nilai JSON minimal untuk membaca glTF
+struct JsonValue {
+    enum Type { JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT };
+    Type type = JSON_NULL;
+    double number = 0.0;
+    std::string text;
+    std::vector<JsonValue> items;
+    std::vector<std::pair<std::string, JsonValue>> members;
+    
+    const JsonValue* find(const char* key) const {
+        for (const auto& member : members) {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+    
+    double numberOr(const char* key, double fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == JSON_NUMBER ? value->number : fallback;
+    }
+    
+    int intOr(const char* key, int fallback) const { return (int)numberOr(key, fallback); }
+    
+    // Ukuran/offset byte (default 0); false jika negatif, pecahan, atau
+    // terlalu besar untuk dihitung tanpa overflow
+    bool byteCount(const char* key, size_t& out) const {
+        double value = numberOr(key, 0.0);
+        if (!(value >= 0.0 && value <= 4503599627370496.0) || value != std::floor(value)) return false;
+        out = (size_t)value;
+        return true;
+    }
+    
+    // Array angka (misal "translation") ke out; false jika jumlahnya beda
+    bool numbers(const char* key, float* out, size_t count) const {
+        const JsonValue* value = find(key);
+        if (!value || value->type != JSON_ARRAY || value->items.size() != count) return false;
+        for (size_t i = 0; i < count; i++) out[i] = (float)value->items[i].number;
+        return true;
+    }
+};
+
+class JsonParser {
+public:
+    bool parse(std::string_view source, JsonValue& root) {
+        text = source;
+        pos = 0;
+        if (!parseValue(root, 0)) return false;
+        skipSpace();
+        return pos == text.size();
+    }
+    
+private:
+    std::string_view text;
+    size_t pos = 0;
+    
+    void skipSpace() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' ||
+                                     text[pos] == '\n' || text[pos] == '\r')) pos++;
+    }
+    
+    bool literal(const char* word) {
+        size_t length = std::strlen(word);
+        if (text.compare(pos, length, word) != 0) return false;
+        pos += length;
+        return true;
+    }
+    
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > 64) return false;
+        skipSpace();
+        if (pos >= text.size()) return false;
+        char c = text[pos];
+        if (c == '{') {
+            out.type = JsonValue::JSON_OBJECT;
+            pos++;
+            skipSpace();
+            if (pos < text.size() && text[pos] == '}') { pos++; return true; }
+            for (;;) {
+                skipSpace();
+                std::string key;
+                if (!parseString(key)) return false;
+                skipSpace();
+                if (pos >= text.size() || text[pos++] != ':') return false;
+                out.members.emplace_back(std::move(key), JsonValue());
+                if (!parseValue(out.members.back().second, depth + 1)) return false;
+                skipSpace();
+                if (pos >= text.size()) return false;
+                if (text[pos] == ',') { pos++; continue; }
+                if (text[pos++] == '}') return true;
+                return false;
+            }
+        }
+        if (c == '[') {
+            out.type = JsonValue::JSON_ARRAY;
+            pos++;
+            skipSpace();
+            if (pos < text.size() && text[pos] == ']') { pos++; return true; }
+            for (;;) {
+                out.items.emplace_back();
+                if (!parseValue(out.items.back(), depth + 1)) return false;
+                skipSpace();
+                if (pos >= text.size()) return false;
+                if (text[pos] == ',') { pos++; continue; }
+                if (text[pos++] == ']') return true;
+                return false;
+            }
+        }
+        if (c == '"') {
+            out.type = JsonValue::JSON_STRING;
+            return parseString(out.text);
+        }
+        if (literal("true")) { out.type = JsonValue::JSON_BOOL; out.number = 1.0; return true; }
+        if (literal("false")) { out.type = JsonValue::JSON_BOOL; return true; }
+        if (literal("null")) return true;
+        
+        out.type = JsonValue::JSON_NUMBER;
+        std::from_chars_result result = std::from_chars(text.data() + pos, text.data() + text.size(), out.number);
+        if (result.ec != std::errc()) return false;
+        pos = result.ptr - text.data();
+        return true;
+    }
+    
+    bool parseString(std::string& out) {
+        if (pos >= text.size() || text[pos] != '"') return false;
+        pos++;
+        // Tanpa escape (kasus umum, termasuk data URI besar): satu salinan
+        size_t end = text.find('"', pos);
+        if (end == std::string_view::npos) return false;
+        if (text.substr(pos, end - pos).find('\\') == std::string_view::npos) {
+            out.assign(text.substr(pos, end - pos));
+            pos = end + 1;
+            return true;
+        }
+        while (pos < text.size()) {
+            char c = text[pos++];
+            if (c == '"') return true;
+            if (c != '\\') { out += c; continue; }
+            if (pos >= text.size()) return false;
+            char e = text[pos++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    unsigned int code = 0;
+                    if (!parseHex4(code)) return false;
+                    // Surrogate pair UTF-16
+                    if (code >= 0xD800 && code <= 0xDBFF && text.compare(pos, 2, "\\u") == 0) {
+                        pos += 2;
+                        unsigned int low = 0;
+                        if (!parseHex4(low)) return false;
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, code);
+                    break;
+                }
+                default: out += e; break;   // \" \\ \/
+            }
+        }
+        return false;
+    }
+    
+    bool parseHex4(unsigned int& code) {
+        if (pos + 4 > text.size()) return false;
+        std::from_chars_result result = std::from_chars(text.data() + pos, text.data() + pos + 4, code, 16);
+        if (result.ptr != text.data() + pos + 4) return false;
+        pos += 4;
+        return true;
+    }
+    
+    static void appendUtf8(std::string& out, unsigned int code) {
+        if (code < 0x80) {
+            out += (char)code;
+        } else if (code < 0x800) {
+            out += (char)(0xC0 | (code >> 6));
+            out += (char)(0x80 | (code & 0x3F));
+        } else if (code < 0x10000) {
+            out += (char)(0xE0 | (code >> 12));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        } else {
+            out += (char)(0xF0 | (code >> 18));
+            out += (char)(0x80 | ((code >> 12) & 0x3F));
+            out += (char)(0x80 | ((code >> 6) & 0x3F));
+            out += (char)(0x80 | (code & 0x3F));
+        }
+    }
+};
+
+// Dekode base64 (data URI buffer glTF); false jika ada karakter asing
+bool decodeBase64(std::string_view input, std::vector<char>& out) {
+    static int table[256];
+    static bool tableReady = [] {
+        for (int& entry : table) entry = -1;
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; i++) table[(unsigned char)alphabet[i]] = i;
+        return true;
+    }();
+    (void)tableReady;
+    out.clear();
+    out.reserve(input.size() / 4 * 3);
+    unsigned int bits = 0;
+    int bitCount = 0;
+    for (char c : input) {
+        if (c == '=') break;
+        int value = table[(unsigned char)c];
+        if (value < 0) return false;
+        bits = (bits << 6) | (unsigned int)value;
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            out.push_back((char)((bits >> bitCount) & 0xFF));
+        }
+    }
+    return true;
+}
+
+class ModelImporter {
+public:
+    NormalMode normalMode = NORMALS_SMOOTH;
+    glm::vec3 defaultColor = glm::vec3(0.7f);   // Jika file tidak punya material
+    int triangles = 0;
+    int generatedNormals = 0;   // Sudut segitiga yang normalnya dibuat importer
+    
+    bool load(const std::string& path, Object3D& out, ThreadPool& pool) {
+        std::string extension = std::filesystem::path(path).extension().string();
+        for (char& c : extension) c = (char)std::tolower((unsigned char)c);
+        triangles = 0;
+        generatedNormals = 0;
+        out.vertices.clear();
+        if (extension == ".obj") return loadObj(path, out, pool);
+        if (extension == ".gltf" || extension == ".glb") return loadGltf(path, out, pool);
+        std::cerr << "ERROR: Unsupported model format: " << path << std::endl;
+        return false;
+    }
+    
+private:
+    static constexpr int TRIANGLES_PER_TASK = 65536;
+    
+    // ---------------------------------------------------------------
+    // Wavefront OBJ
+    // ---------------------------------------------------------------
+    struct ObjBlock {
+        std::string_view text;
+        int positions = 0, normals = 0, triangles = 0;       // Pass 1
+        int positionBase = 0, normalBase = 0, triangleBase = 0;
+        std::string lastMaterial;      // usemtl terakhir di blok
+        int startMaterial = 0;         // Material aktif di awal blok
+        std::vector<std::string> libraries;
+        int invalidIndices = 0;
+        int skippedFaces = 0;          // Face dengan indeks posisi tidak valid
+    };
+    
+    static std::string_view nextWord(std::string_view& line) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string_view::npos) {
+            line = std::string_view();
+            return line;
+        }
+        size_t end = line.find_first_of(" \t\r", start);
+        std::string_view word = line.substr(start, end == std::string_view::npos ? end : end - start);
+        line = end == std::string_view::npos ? std::string_view() : line.substr(end);
+        return word;
+    }
+    
+    static std::string_view restOfLine(std::string_view line) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string_view::npos) return std::string_view();
+        size_t end = line.find_last_not_of(" \t\r");
+        return line.substr(start, end - start + 1);
+    }
+    
+    static float parseFloat(std::string_view word) {
+        if (!word.empty() && word[0] == '+') word.remove_prefix(1);
+        float value = 0.0f;
+        std::from_chars(word.data(), word.data() + word.size(), value);
+        return value;
+    }
+    
+    static glm::vec3 parseVec3(std::string_view& line) {
+        float x = parseFloat(nextWord(line));
+        float y = parseFloat(nextWord(line));
+        float z = parseFloat(nextWord(line));
+        return glm::vec3(x, y, z);
+    }
+    
+    // Panggil fn(line) untuk setiap baris teks
+    template <typename Fn>
+    static void forEachLine(std::string_view text, Fn fn) {
+        while (!text.empty()) {
+            size_t end = text.find('\n');
+            fn(text.substr(0, end));
+            text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+        }
+    }
+    
+    // Warna Kd per nama material dari file .mtl (kecil, dibaca serial)
+    static void loadMaterialLibrary(const std::string& path, std::map<std::string, glm::vec3>& colors) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "WARNING::MODEL::MTL_NOT_FOUND " << path << std::endl;
+            return;
+        }
+        std::string current;
+        forEachLine(file.view(), [&](std::string_view line) {
+            std::string_view keyword = nextWord(line);
+            if (keyword == "newmtl") {
+                current.assign(restOfLine(line));
+                colors[current] = glm::vec3(0.7f);
+            } else if (keyword == "Kd" && !current.empty()) {
+                colors[current] = parseVec3(line);
+            }
+        });
+    }
+    
+    bool loadObj(const std::string& path, Object3D& out, ThreadPool& pool) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "ERROR: Cannot open model file: " << path << std::endl;
+            return false;
+        }
+        std::string_view text = file.view();
+        
+        // Blok ~1 MB, dipotong di batas baris
+        const size_t blockSize = 1 << 20;
+        std::vector<ObjBlock> blocks;
+        for (size_t start = 0; start < text.size();) {
+            size_t end = std::min(start + blockSize, text.size());
+            if (end < text.size()) {
+                size_t newline = text.find('\n', end);
+                end = newline == std::string_view::npos ? text.size() : newline + 1;
+            }
+            blocks.emplace_back();
+            blocks.back().text = text.substr(start, end - start);
+            start = end;
+        }
+        
+        // Pass 1: hitung elemen per blok
+        pool.parallelFor((int)blocks.size(), [&](int b) {
+            ObjBlock& block = blocks[b];
+            forEachLine(block.text, [&](std::string_view line) {
+                std::string_view keyword = nextWord(line);
+                if (keyword == "v") {
+                    block.positions++;
+                } else if (keyword == "vn") {
+                    block.normals++;
+                } else if (keyword == "f") {
+                    int corners = 0;
+                    while (!nextWord(line).empty()) corners++;
+                    if (corners >= 3) block.triangles += corners - 2;
+                } else if (keyword == "usemtl") {
+                    block.lastMaterial.assign(restOfLine(line));
+                } else if (keyword == "mtllib") {
+                    block.libraries.emplace_back(restOfLine(line));
+                }
+            });
+        });
+        
+        // Prefix sum dan material (serial, per blok)
+        std::string directory = std::filesystem::path(path).parent_path().string();
+        if (!directory.empty()) directory += "/";
+        std::map<std::string, glm::vec3> libraryColors;
+        std::set<std::string> loadedLibraries;
+        int positionCount = 0, normalCount = 0, triangleCount = 0;
+        for (ObjBlock& block : blocks) {
+            block.positionBase = positionCount;
+            block.normalBase = normalCount;
+            block.triangleBase = triangleCount;
+            positionCount += block.positions;
+            normalCount += block.normals;
+            triangleCount += block.triangles;
+            for (const std::string& library : block.libraries) {
+                if (loadedLibraries.insert(library).second)
+                    loadMaterialLibrary(directory + library, libraryColors);
+            }
+        }
+        std::vector<glm::vec3> materialColors = {defaultColor};
+        std::map<std::string, int> materialIndex;
+        for (const auto& entry : libraryColors) {
+            materialIndex[entry.first] = (int)materialColors.size();
+            materialColors.push_back(entry.second);
+        }
+        auto findMaterial = [&](const std::string& name) {
+            auto it = materialIndex.find(name);
+            return it == materialIndex.end() ? 0 : it->second;
+        };
+        int activeMaterial = 0;
+        for (ObjBlock& block : blocks) {
+            block.startMaterial = activeMaterial;
+            if (!block.lastMaterial.empty()) activeMaterial = findMaterial(block.lastMaterial);
+        }
+        if (positionCount == 0 || triangleCount == 0) {
+            std::cerr << "ERROR: Model has no triangles: " << path << std::endl;
+            return false;
+        }
+        
+        // Pass 2: tulis langsung ke array global
+        std::vector<glm::vec3> positions(positionCount);
+        std::vector<glm::vec3> normals(normalCount);
+        std::vector<int> cornerPositions((size_t)triangleCount * 3);
+        std::vector<int> cornerNormals((size_t)triangleCount * 3);
+        std::vector<int> triangleMaterials(triangleCount);
+        pool.parallelFor((int)blocks.size(), [&](int b) {
+            ObjBlock& block = blocks[b];
+            int nextPosition = block.positionBase;
+            int nextNormal = block.normalBase;
+            int nextTriangle = block.triangleBase;
+            int material = block.startMaterial;
+            std::vector<int> facePositions, faceNormals;
+            forEachLine(block.text, [&](std::string_view line) {
+                std::string_view keyword = nextWord(line);
+                if (keyword == "v") {
+                    positions[nextPosition++] = parseVec3(line);
+                } else if (keyword == "vn") {
+                    normals[nextNormal++] = parseVec3(line);
+                } else if (keyword == "usemtl") {
+                    material = findMaterial(std::string(restOfLine(line)));
+                } else if (keyword == "f") {
+                    facePositions.clear();
+                    faceNormals.clear();
+                    bool validFace = true;
+                    std::string_view corner;
+                    while (!(corner = nextWord(line)).empty()) {
+                        int indices[3] = {0, 0, 0};   // v / vt / vn (0 = tidak ditulis)
+                        bool malformed[3] = {false, false, false};
+                        const char* p = corner.data();
+                        const char* end = corner.data() + corner.size();
+                        for (int k = 0; k < 3 && p < end; k++) {
+                            if (*p != '/') {
+                                // OBJ 1-based: indeks 0 atau teks yang bukan angka tidak valid
+                                std::from_chars_result parsed = std::from_chars(p, end, indices[k]);
+                                if (parsed.ec != std::errc() || indices[k] == 0) malformed[k] = true;
+                                p = parsed.ptr;
+                            }
+                            if (p < end && *p == '/') {
+                                p++;
+                            } else {
+                                if (p < end) malformed[k] = true;
+                                break;
+                            }
+                        }
+                        // 1-based, negatif = relatif dari elemen terakhir yang sudah dibaca
+                        int v = indices[0] > 0 ? indices[0] - 1 : nextPosition + indices[0];
+                        int n = indices[2] > 0 ? indices[2] - 1 : indices[2] < 0 ? nextNormal + indices[2] : -1;
+                        if (malformed[0] || indices[0] == 0 || v < 0 || v >= positionCount) {
+                            block.invalidIndices++;
+                            validFace = false;
+                            v = 0;
+                        }
+                        if (malformed[2] || n >= normalCount || (indices[2] != 0 && n < 0)) {
+                            block.invalidIndices++;
+                            n = -1;   // Normal dibuat ulang
+                        }
+                        facePositions.push_back(v);
+                        faceNormals.push_back(n);
+                    }
+                    // Poligon dipecah menjadi fan segitiga. Face dengan posisi
+                    // tidak valid tetap memakai slotnya (material -1) lalu
+                    // dibuang setelah pass ini.
+                    if (!validFace && facePositions.size() >= 3) block.skippedFaces++;
+                    for (size_t i = 1; i + 1 < facePositions.size(); i++) {
+                        size_t corners[3] = {0, i, i + 1};
+                        for (int k = 0; k < 3; k++) {
+                            cornerPositions[(size_t)nextTriangle * 3 + k] = facePositions[corners[k]];
+                            cornerNormals[(size_t)nextTriangle * 3 + k] = faceNormals[corners[k]];
+                        }
+                        triangleMaterials[nextTriangle++] = validFace ? material : -1;
+                    }
+                }
+            });
+        });
+        int invalidIndices = 0, skippedFaces = 0;
+        for (const ObjBlock& block : blocks) {
+            invalidIndices += block.invalidIndices;
+            skippedFaces += block.skippedFaces;
+        }
+        if (invalidIndices > 0) {
+            std::cerr << "WARNING::MODEL::INVALID_INDICES " << path << " (" << invalidIndices
+                      << ", " << skippedFaces << " faces skipped)" << std::endl;
+        }
+        if (skippedFaces > 0) {
+            int kept = 0;
+            for (int t = 0; t < triangleCount; t++) {
+                if (triangleMaterials[t] < 0) continue;
+                for (int k = 0; k < 3; k++) {
+                    cornerPositions[(size_t)kept * 3 + k] = cornerPositions[(size_t)t * 3 + k];
+                    cornerNormals[(size_t)kept * 3 + k] = cornerNormals[(size_t)t * 3 + k];
+                }
+                triangleMaterials[kept++] = triangleMaterials[t];
+            }
+            triangleCount = kept;
+            if (triangleCount == 0) {
+                std::cerr << "ERROR: Model has no triangles: " << path << std::endl;
+                return false;
+            }
+        }
+        
+        // Normal smooth: jumlah normal segitiga (berbobot luas) per posisi
+        std::vector<glm::vec3> smoothNormals;
+        if (normalMode == NORMALS_SMOOTH) {
+            bool missing = false;
+            for (int n : cornerNormals) {
+                if (n < 0) { missing = true; break; }
+            }
+            if (missing) {
+                smoothNormals.assign(positionCount, glm::vec3(0.0f));
+                for (int t = 0; t < triangleCount; t++) {
+                    const int* c = &cornerPositions[(size_t)t * 3];
+                    glm::vec3 face = glm::cross(positions[c[1]] - positions[c[0]], positions[c[2]] - positions[c[0]]);
+                    for (int k = 0; k < 3; k++) smoothNormals[c[k]] += face;
+                }
+            }
+        }
+        
+        // Pass 3: susun vertex per blok segitiga
+        out.vertices.resize((size_t)triangleCount * 3);
+        std::vector<Vertex>& vertices = out.vertices.edit();
+        std::atomic<int> generated{0};
+        int tasks = (triangleCount + TRIANGLES_PER_TASK - 1) / TRIANGLES_PER_TASK;
+        pool.parallelFor(tasks, [&](int task) {
+            int first = task * TRIANGLES_PER_TASK;
+            int last = std::min(triangleCount, first + TRIANGLES_PER_TASK);
+            int made = 0;
+            for (int t = first; t < last; t++) {
+                const int* c = &cornerPositions[(size_t)t * 3];
+                const int* n = &cornerNormals[(size_t)t * 3];
+                glm::vec3 p[3] = {positions[c[0]], positions[c[1]], positions[c[2]]};
+                glm::vec3 face = safeNormalize(glm::cross(p[1] - p[0], p[2] - p[0]), glm::vec3(0.0f, 1.0f, 0.0f));
+                for (int k = 0; k < 3; k++) {
+                    Vertex& v = vertices[(size_t)t * 3 + k];
+                    v.position = p[k];
+                    v.color = materialColors[triangleMaterials[t]];
+                    if (n[k] >= 0) {
+                        v.normal = safeNormalize(normals[n[k]], face);
+                    } else {
+                        v.normal = smoothNormals.empty() ? face : safeNormalize(smoothNormals[c[k]], face);
+                        made++;
+                    }
+                }
+            }
+            generated += made;
+        });
+        triangles = triangleCount;
+        generatedNormals = generated;
+        return true;
+    }
+    
+    static glm::vec3 safeNormalize(glm::vec3 v, glm::vec3 fallback) {
+        float length = glm::length(v);
+        return length > 1e-20f ? v / length : fallback;
+    }
+    
+    // ---------------------------------------------------------------
+    // glTF 2.0
+    // ---------------------------------------------------------------
+    struct AccessorView {
+        const unsigned char* data = nullptr;
+        size_t stride = 0;
+        int count = 0;
+        int componentType = 0;
+    };
+    
+    struct GltfPrimitive {
+        AccessorView positions, normals, indices;
+        bool hasNormals = false, hasIndices = false;
+        glm::mat4 transform = glm::mat4(1.0f);
+        glm::mat3 normalMatrix = glm::mat3(1.0f);
+        bool flipWinding = false;   // Transform dengan determinan negatif
+        glm::vec3 color = glm::vec3(0.7f);
+        int triangleCount = 0;
+        int firstTriangle = 0;
+        std::vector<glm::vec3> smoothNormals;   // Per vertex accessor (ruang lokal)
+    };
+    
+    static glm::vec3 readVec3(const AccessorView& view, uint32_t i) {
+        glm::vec3 v;
+        std::memcpy(&v, view.data + view.stride * i, sizeof(v));
+        return v;
+    }
+    
+    static uint32_t readIndex(const AccessorView& view, uint32_t i) {
+        const unsigned char* p = view.data + view.stride * i;
+        if (view.componentType == 5121) return *p;
+        if (view.componentType == 5123) {
+            uint16_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+    
+    bool loadGltf(const std::string& path, Object3D& out, ThreadPool& pool) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "ERROR: Cannot open model file: " << path << std::endl;
+            return false;
+        }
+        std::string_view data = file.view();
+        std::string_view json = data, binaryChunk;
+        
+        // .glb: header 12 byte lalu chunk JSON dan BIN
+        if (data.size() >= 12 && data.compare(0, 4, "glTF") == 0) {
+            json = std::string_view();
+            size_t offset = 12;
+            while (offset + 8 <= data.size()) {
+                uint32_t chunkLength, chunkType;
+                std::memcpy(&chunkLength, data.data() + offset, 4);
+                std::memcpy(&chunkType, data.data() + offset + 4, 4);
+                if (offset + 8 + chunkLength > data.size()) break;
+                std::string_view chunk = data.substr(offset + 8, chunkLength);
+                if (chunkType == 0x4E4F534Au) json = chunk;           // "JSON"
+                else if (chunkType == 0x004E4942u) binaryChunk = chunk;   // "BIN\0"
+                offset += 8 + ((chunkLength + 3) & ~3u);
+            }
+        }
+        JsonValue root;
+        if (json.empty() || !JsonParser().parse(json, root) || root.type != JsonValue::JSON_OBJECT) {
+            std::cerr << "ERROR: Invalid glTF JSON: " << path << std::endl;
+            return false;
+        }
+        
+        // Buffer: chunk BIN, data URI base64, atau file eksternal (di-mmap)
+        std::string directory = std::filesystem::path(path).parent_path().string();
+        if (!directory.empty()) directory += "/";
+        std::vector<std::string_view> buffers;
+        std::vector<std::vector<char>> decoded;
+        std::vector<std::unique_ptr<MappedFile>> external;
+        if (const JsonValue* list = root.find("buffers")) {
+            decoded.reserve(list->items.size());
+            for (const JsonValue& buffer : list->items) {
+                const JsonValue* uri = buffer.find("uri");
+                std::string_view contents;
+                if (!uri) {
+                    contents = binaryChunk;
+                } else if (uri->text.compare(0, 5, "data:") == 0) {
+                    size_t comma = uri->text.find(";base64,");
+                    decoded.emplace_back();
+                    if (comma == std::string::npos ||
+                        !decodeBase64(std::string_view(uri->text).substr(comma + 8), decoded.back())) {
+                        std::cerr << "ERROR: Invalid glTF data URI: " << path << std::endl;
+                        return false;
+                    }
+                    contents = std::string_view(decoded.back().data(), decoded.back().size());
+                } else {
+                    external.emplace_back(new MappedFile());
+                    if (!external.back()->open(directory + uri->text)) {
+                        std::cerr << "ERROR: Cannot open glTF buffer: " << directory + uri->text << std::endl;
+                        return false;
+                    }
+                    contents = external.back()->view();
+                }
+                size_t length;
+                if (!buffer.byteCount("byteLength", length)) {
+                    std::cerr << "ERROR: Invalid glTF buffer length: " << path << std::endl;
+                    return false;
+                }
+                if (length > contents.size()) {
+                    std::cerr << "ERROR: glTF buffer too short: " << path << std::endl;
+                    return false;
+                }
+                buffers.push_back(contents.substr(0, length));
+            }
+        }
+        
+        const JsonValue emptyArray;
+        auto arrayOf = [&](const char* key) -> const std::vector<JsonValue>& {
+            const JsonValue* value = root.find(key);
+            return value ? value->items : emptyArray.items;
+        };
+        const std::vector<JsonValue>& accessors = arrayOf("accessors");
+        const std::vector<JsonValue>& bufferViews = arrayOf("bufferViews");
+        const std::vector<JsonValue>& meshes = arrayOf("meshes");
+        const std::vector<JsonValue>& nodes = arrayOf("nodes");
+        const std::vector<JsonValue>& materials = arrayOf("materials");
+        
+        // Accessor -> pointer data dengan cek batas buffer view
+        auto accessor = [&](int index, int components, bool indices, AccessorView& view) {
+            if (index < 0 || index >= (int)accessors.size()) return false;
+            const JsonValue& a = accessors[index];
+            int viewIndex = a.intOr("bufferView", -1);
+            if (a.find("sparse") || viewIndex < 0 || viewIndex >= (int)bufferViews.size()) return false;
+            const JsonValue& bv = bufferViews[viewIndex];
+            int bufferIndex = bv.intOr("buffer", -1);
+            if (bufferIndex < 0 || bufferIndex >= (int)buffers.size()) return false;
+            view.componentType = a.intOr("componentType", 0);
+            // Jumlah elemen wajib bulat positif; batas int juga menjaga
+            // perkalian stride * count di bawah dari overflow
+            size_t count;
+            if (!a.byteCount("count", count) || count == 0 || count > (size_t)std::numeric_limits<int>::max())
+                return false;
+            view.count = (int)count;
+            size_t elementSize;
+            if (indices) {
+                if (view.componentType == 5121) elementSize = 1;
+                else if (view.componentType == 5123) elementSize = 2;
+                else if (view.componentType == 5125) elementSize = 4;
+                else return false;
+            } else {
+                if (view.componentType != 5126) return false;   // Hanya float
+                elementSize = 4 * components;
+            }
+            size_t viewOffset, viewLength, offset;
+            if (!bv.byteCount("byteStride", view.stride) || !bv.byteCount("byteOffset", viewOffset) ||
+                !bv.byteCount("byteLength", viewLength) || !a.byteCount("byteOffset", offset)) return false;
+            if (view.stride > 252) return false;   // Batas glTF (juga mencegah overflow di bawah)
+            if (view.stride == 0) view.stride = elementSize;
+            std::string_view buffer = buffers[bufferIndex];
+            if (viewOffset + viewLength > buffer.size()) return false;
+            if (offset + view.stride * (count - 1) + elementSize > viewLength) return false;
+            view.data = (const unsigned char*)buffer.data() + viewOffset + offset;
+            return true;
+        };
+        
+        std::vector<GltfPrimitive> primitives;
+        int unsupported = 0;
+        auto addMesh = [&](int meshIndex, const glm::mat4& transform) {
+            if (meshIndex < 0 || meshIndex >= (int)meshes.size()) return;
+            const JsonValue* list = meshes[meshIndex].find("primitives");
+            if (!list) return;
+            for (const JsonValue& p : list->items) {
+                const JsonValue* attributes = p.find("attributes");
+                GltfPrimitive primitive;
+                if (p.intOr("mode", 4) != 4 || !attributes ||
+                    !accessor(attributes->intOr("POSITION", -1), 3, false, primitive.positions)) {
+                    unsupported++;
+                    continue;
+                }
+                primitive.hasNormals = accessor(attributes->intOr("NORMAL", -1), 3, false, primitive.normals) &&
+                                       primitive.normals.count == primitive.positions.count;
+                if (p.find("indices")) {
+                    primitive.hasIndices = accessor(p.intOr("indices", -1), 1, true, primitive.indices);
+                    if (!primitive.hasIndices) {
+                        unsupported++;
+                        continue;
+                    }
+                }
+                primitive.transform = transform;
+                primitive.normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+                primitive.flipWinding = glm::determinant(glm::mat3(transform)) < 0.0f;
+                primitive.color = defaultColor;
+                int material = p.intOr("material", -1);
+                if (material >= 0 && material < (int)materials.size()) {
+                    const JsonValue* pbr = materials[material].find("pbrMetallicRoughness");
+                    float factor[4];
+                    if (pbr && pbr->numbers("baseColorFactor", factor, 4))
+                        primitive.color = glm::vec3(factor[0], factor[1], factor[2]);
+                }
+                primitive.triangleCount = (primitive.hasIndices ? primitive.indices.count
+                                                                : primitive.positions.count) / 3;
+                if (primitive.triangleCount > 0) primitives.push_back(std::move(primitive));
+            }
+        };
+        
+        // Transform node: matrix, atau translation * rotation * scale
+        std::vector<char> visited(nodes.size(), 0);
+        std::function<void(int, const glm::mat4&)> visit = [&](int index, const glm::mat4& parent) {
+            if (index < 0 || index >= (int)nodes.size() || visited[index]) return;
+            visited[index] = 1;
+            const JsonValue& node = nodes[index];
+            glm::mat4 local(1.0f);
+            float m[16], t[3], r[4], s[3];
+            if (node.numbers("matrix", m, 16)) {
+                std::memcpy(glm::value_ptr(local), m, sizeof(m));   // Column-major seperti GLM
+            } else {
+                if (node.numbers("translation", t, 3)) local = glm::translate(local, glm::vec3(t[0], t[1], t[2]));
+                if (node.numbers("rotation", r, 4)) local *= glm::mat4_cast(glm::quat(r[3], r[0], r[1], r[2]));
+                if (node.numbers("scale", s, 3)) local = glm::scale(local, glm::vec3(s[0], s[1], s[2]));
+            }
+            glm::mat4 world = parent * local;
+            addMesh(node.intOr("mesh", -1), world);
+            if (const JsonValue* children = node.find("children")) {
+                for (const JsonValue& child : children->items) visit((int)child.number, world);
+            }
+        };
+        const std::vector<JsonValue>& scenes = arrayOf("scenes");
+        int sceneIndex = root.intOr("scene", 0);
+        if (sceneIndex >= 0 && sceneIndex < (int)scenes.size()) {
+            if (const JsonValue* roots = scenes[sceneIndex].find("nodes")) {
+                for (const JsonValue& node : roots->items) visit((int)node.number, glm::mat4(1.0f));
+            }
+        } else {
+            // Tanpa scene: semua mesh apa adanya
+            for (int m = 0; m < (int)meshes.size(); m++) addMesh(m, glm::mat4(1.0f));
+        }
+        if (unsupported > 0) {
+            std::cerr << "WARNING::MODEL::PRIMITIVES_SKIPPED " << path << " (" << unsupported
+                      << " bukan segitiga / format tidak didukung)" << std::endl;
+        }
+        
+        // Offset output per primitive dan normal smooth (ruang lokal)
+        int triangleCount = 0;
+        for (GltfPrimitive& primitive : primitives) {
+            primitive.firstTriangle = triangleCount;
+            triangleCount += primitive.triangleCount;
+            if (primitive.hasNormals || normalMode != NORMALS_SMOOTH || !primitive.hasIndices) continue;
+            primitive.smoothNormals.assign(primitive.positions.count, glm::vec3(0.0f));
+            for (int t = 0; t < primitive.triangleCount; t++) {
+                uint32_t c[3];
+                bool valid = true;
+                for (int k = 0; k < 3; k++) {
+                    c[k] = readIndex(primitive.indices, t * 3 + k);
+                    valid = valid && c[k] < (uint32_t)primitive.positions.count;
+                }
+                if (!valid) continue;
+                glm::vec3 p0 = readVec3(primitive.positions, c[0]);
+                glm::vec3 face = glm::cross(readVec3(primitive.positions, c[1]) - p0,
+                                            readVec3(primitive.positions, c[2]) - p0);
+                for (int k = 0; k < 3; k++) primitive.smoothNormals[c[k]] += face;
+            }
+        }
+        if (triangleCount == 0) {
+            std::cerr << "ERROR: Model has no triangles: " << path << std::endl;
+            return false;
+        }
+        
+        // Konversi paralel per blok segitiga (blok tidak melewati batas primitive)
+        struct Task { int primitive, first, count; };
+        std::vector<Task> tasks;
+        for (int p = 0; p < (int)primitives.size(); p++) {
+            for (int first = 0; first < primitives[p].triangleCount; first += TRIANGLES_PER_TASK)
+                tasks.push_back({p, first, std::min(TRIANGLES_PER_TASK, primitives[p].triangleCount - first)});
+        }
+        // Segitiga dengan indeks di luar jumlah vertex dilewati utuh (seperti
+        // face OBJ tidak valid) lalu dibuang saat dipadatkan
+        out.vertices.resize((size_t)triangleCount * 3);
+        std::vector<Vertex>& vertices = out.vertices.edit();
+        std::vector<char> skipped(triangleCount, 0);
+        std::atomic<int> generated{0};
+        std::atomic<int> invalid{0};
+        std::atomic<int> skippedTriangles{0};
+        pool.parallelFor((int)tasks.size(), [&](int taskIndex) {
+            const Task& task = tasks[taskIndex];
+            const GltfPrimitive& primitive = primitives[task.primitive];
+            int made = 0, bad = 0, dropped = 0;
+            for (int t = task.first; t < task.first + task.count; t++) {
+                uint32_t c[3];
+                int badCorners = 0;
+                for (int k = 0; k < 3; k++) {
+                    c[k] = primitive.hasIndices ? readIndex(primitive.indices, t * 3 + k) : (uint32_t)(t * 3 + k);
+                    if (c[k] >= (uint32_t)primitive.positions.count) badCorners++;
+                }
+                if (badCorners > 0) {
+                    skipped[primitive.firstTriangle + t] = 1;
+                    bad += badCorners;
+                    dropped++;
+                    continue;
+                }
+                if (primitive.flipWinding) std::swap(c[1], c[2]);
+                glm::vec3 p[3];
+                for (int k = 0; k < 3; k++)
+                    p[k] = glm::vec3(primitive.transform * glm::vec4(readVec3(primitive.positions, c[k]), 1.0f));
+                glm::vec3 face = safeNormalize(glm::cross(p[1] - p[0], p[2] - p[0]), glm::vec3(0.0f, 1.0f, 0.0f));
+                for (int k = 0; k < 3; k++) {
+                    Vertex& v = vertices[(size_t)(primitive.firstTriangle + t) * 3 + k];
+                    v.position = p[k];
+                    v.color = primitive.color;
+                    if (primitive.hasNormals) {
+                        v.normal = safeNormalize(primitive.normalMatrix * readVec3(primitive.normals, c[k]), face);
+                    } else {
+                        v.normal = primitive.smoothNormals.empty() ? face
+                            : safeNormalize(primitive.normalMatrix * primitive.smoothNormals[c[k]], face);
+                        made++;
+                    }
+                }
+            }
+            generated += made;
+            invalid += bad;
+            skippedTriangles += dropped;
+        });
+        if (invalid > 0) {
+            std::cerr << "WARNING::MODEL::INVALID_INDICES " << path << " (" << invalid
+                      << ", " << skippedTriangles << " triangles skipped)" << std::endl;
+        }
+        if (skippedTriangles > 0) {
+            int kept = 0;
+            for (int t = 0; t < triangleCount; t++) {
+                if (skipped[t]) continue;
+                for (int k = 0; k < 3; k++)
+                    vertices[(size_t)kept * 3 + k] = vertices[(size_t)t * 3 + k];
+                kept++;
+            }
+            triangleCount = kept;
+            vertices.resize((size_t)triangleCount * 3);
+            if (triangleCount == 0) {
+                std::cerr << "ERROR: Model has no triangles: " << path << std::endl;
+                return false;
+            }
+        }
+        triangles = triangleCount;
+        generatedNormals = generated;
+        return true;
+    }
+};
+
+// =====================================================================
+// CACHE MESH BINARY (MEMORY-MAPPED)
+// =====================================================================
+// Mesh prototype yang sudah disiapkan (builder -> pecah permukaan besar ->
+// validasi winding) disimpan di cache/meshes.bin: header berversi, tabel
+// mesh (kunci hash parameter builder, offset, jumlah, bounds), lalu blob
+// vertex, draw range, dan detail part yang di-align 64 byte. Start
+// berikutnya file di-mmap: builder, subdivisi, dan validasi dilewati.
+// Prototype dan semua instance-nya menunjuk halaman mmap (MeshVertices)
+// sampai diedit, dan di-upload ke GPU langsung dari sana; AO per instance
+// disimpan terpisah (Object3D::bakedAO). Naikkan MESH_CACHE_VERSION setiap
+// kali builder create*, importer model, atau validateMesh diubah.
+const uint32_t MESH_CACHE_VERSION = 5;
+bool meshCacheEnabled = true;   // --no-mesh-cache
+
+class MeshCache {
+public:
+    int hits = 0;
+    int misses = 0;
+    
+    // Map file cache (sekali); file rusak atau versi lain diabaikan
+    void open() {
+        if (opened) return;
+        opened = true;
+        if (!file.open(path)) return;
+        std::string_view data = file.view();
+        if (data.size() < sizeof(Header)) return;
+        const Header* header = (const Header*)data.data();
+        if (std::memcmp(header->magic, "MSHC", 4) != 0 || header->version != MESH_CACHE_VERSION ||
+            header->vertexSize != sizeof(Vertex) || header->rangeSize != sizeof(DrawRange) ||
+            header->partSize != sizeof(DetailPart) ||
+            sizeof(Header) + (uint64_t)header->meshCount * sizeof(Entry) > data.size()) return;
+        
+        const Entry* entries = (const Entry*)(data.data() + sizeof(Header));
+        for (uint32_t i = 0; i < header->meshCount; i++) {
+            const Entry& entry = entries[i];
+            if (entry.vertexOffset + (uint64_t)entry.vertexCount * sizeof(Vertex) > data.size() ||
+                entry.rangeOffset + (uint64_t)entry.rangeCount * sizeof(DrawRange) > data.size() ||
+                entry.partOffset + (uint64_t)entry.partCount * sizeof(DetailPart) > data.size()) {
+                table.clear();
+                return;
+            }
+            table[entry.key] = &entry;
+        }
+    }
+    
+    // Isi obj dari cache. Vertex tidak disalin: obj.vertices menunjuk
+    // halaman mmap (dipakai kolisi, picking, bake, dan upload GPU).
+    bool load(uint64_t key, Object3D& obj) {
+        open();
+        auto it = table.find(key);
+        if (it == table.end()) {
+            misses++;
+            return false;
+        }
+        const Entry& entry = *it->second;
+        const char* base = file.view().data();
+        const DrawRange* ranges = (const DrawRange*)(base + entry.rangeOffset);
+        const DetailPart* parts = (const DetailPart*)(base + entry.partOffset);
+        std::shared_ptr<MappedVertices>& span = spans[key];
+        if (!span) span = std::make_shared<MappedVertices>();
+        span->data = (const Vertex*)(base + entry.vertexOffset);
+        span->count = entry.vertexCount;
+        obj.vertices.reference(span);
+        obj.drawRanges.assign(ranges, ranges + entry.rangeCount);
+        obj.detailParts.assign(parts, parts + entry.partCount);
+        obj.setLocalBounds(AABB(entry.boundsMin, entry.boundsMax));
+        hits++;
+        return true;
+    }
+    
+    void store(uint64_t key, const Object3D& obj) {
+        added.push_back({key, obj.vertices, obj.drawRanges, obj.detailParts, obj.getLocalBounds()});
+    }
+    
+    // Tulis ulang file jika ada mesh baru: entri lama (dari mmap) + baru.
+    // Ditulis ke file sementara lalu di-rename. Mapping lama dilepas sebelum
+    // rename (Windows tidak bisa mengganti file yang masih ter-map), lalu
+    // file baru di-map dan vertex yang sudah dibagikan digeser ke sana.
+    // Dipanggil saat tidak ada thread lain yang membaca vertex cache (akhir
+    // SceneDescription::loadFile, sebelum instance dibuat).
+    void save() {
+        if (added.empty()) return;
+        struct Blob { const void* data; size_t bytes; };
+        std::vector<Entry> entries;
+        std::vector<Blob> blobs;
+        uint64_t offset = sizeof(Header) + (table.size() + added.size()) * sizeof(Entry);
+        auto place = [&](const void* data, size_t bytes) {
+            offset = (offset + 63) & ~(uint64_t)63;
+            uint64_t start = offset;
+            blobs.push_back({data, bytes});
+            offset += bytes;
+            return start;
+        };
+        const char* base = file.view().data();
+        for (const auto& item : table) {
+            Entry entry = *item.second;
+            const Entry& old = *item.second;
+            entry.vertexOffset = place(base + old.vertexOffset, old.vertexCount * sizeof(Vertex));
+            entry.rangeOffset = place(base + old.rangeOffset, old.rangeCount * sizeof(DrawRange));
+            entry.partOffset = place(base + old.partOffset, old.partCount * sizeof(DetailPart));
+            entries.push_back(entry);
+        }
+        for (const Added& mesh : added) {
+            Entry entry = {};
+            entry.key = mesh.key;
+            entry.vertexCount = (uint32_t)mesh.vertices.size();
+            entry.rangeCount = (uint32_t)mesh.ranges.size();
+            entry.partCount = (uint32_t)mesh.parts.size();
+            entry.boundsMin = mesh.bounds.min;
+            entry.boundsMax = mesh.bounds.max;
+            entry.vertexOffset = place(mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+            entry.rangeOffset = place(mesh.ranges.data(), mesh.ranges.size() * sizeof(DrawRange));
+            entry.partOffset = place(mesh.parts.data(), mesh.parts.size() * sizeof(DetailPart));
+            entries.push_back(entry);
+        }
+        
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+        std::string tempPath = path + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary);
+            Header header = {{'M', 'S', 'H', 'C'}, MESH_CACHE_VERSION, (uint32_t)entries.size(),
+                             (uint32_t)sizeof(Vertex), (uint32_t)sizeof(DrawRange), (uint32_t)sizeof(DetailPart)};
+            out.write((const char*)&header, sizeof(header));
+            out.write((const char*)entries.data(), entries.size() * sizeof(Entry));
+            uint64_t written = sizeof(Header) + entries.size() * sizeof(Entry);
+            const char padding[64] = {};
+            for (const Blob& blob : blobs) {
+                uint64_t aligned = (written + 63) & ~(uint64_t)63;
+                out.write(padding, aligned - written);
+                out.write((const char*)blob.data, blob.bytes);
+                written = aligned + blob.bytes;
+            }
+            if (!out) {
+                std::cerr << "WARNING::MESH::CACHE_NOT_WRITTEN " << tempPath << std::endl;
+                return;
+            }
+        }
+        file.close();
+        table.clear();
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            std::cerr << "WARNING::MESH::CACHE_NOT_WRITTEN " << path << std::endl;
+            std::filesystem::remove(tempPath, error);
+        } else {
+            added.clear();
+        }
+        remap();
+    }
+    
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t meshCount;
+        uint32_t vertexSize;   // Ukuran struct harus sama dengan build ini
+        uint32_t rangeSize;
+        uint32_t partSize;
+    };
+    struct Entry {
+        uint64_t key;
+        uint64_t vertexOffset;
+        uint64_t rangeOffset;
+        uint64_t partOffset;
+        uint32_t vertexCount;
+        uint32_t rangeCount;
+        uint32_t partCount;
+        uint32_t reserved;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+    struct Added {
+        uint64_t key;
+        MeshVertices vertices;
+        std::vector<DrawRange> ranges;
+        std::vector<DetailPart> parts;
+        AABB bounds;
+    };
+    
+    std::string path = "cache/meshes.bin";
+    bool opened = false;
+    MappedFile file;   // Tetap ter-map: pointer vertex dipakai saat upload
+    std::map<uint64_t, const Entry*> table;
+    std::vector<Added> added;
+    std::unordered_map<uint64_t, std::shared_ptr<MappedVertices>> spans;   // Sudah dibagikan load()
+    
+    // Map ulang file cache (baru, atau lama jika rename gagal) dan geser
+    // setiap rentang vertex yang sudah dibagikan ke mapping tersebut
+    void remap() {
+        opened = false;
+        open();
+        const char* base = file.view().data();
+        for (auto& item : spans) {
+            MappedVertices& span = *item.second;
+            auto it = table.find(item.first);
+            if (it != table.end() && it->second->vertexCount == span.count) {
+                span.data = (const Vertex*)(base + it->second->vertexOffset);
+            } else {
+                std::cerr << "WARNING::MESH::CACHE_REMAP_FAILED " << path << std::endl;
+                span.data = nullptr;
+                span.count = 0;
+            }
+        }
+    }
+};
+
+MeshCache& meshCache() {
+    static MeshCache cache;
+    return cache;
+}
+
+// =====================================================================
+// GENERATOR GEDUNG (DENAH PROSEDURAL)
+// =====================================================================
+// Pernyataan scene `building` diperluas menjadi pernyataan biasa: N x M
+// ruangan per lantai, K lantai. Setiap dinding dimiliki tepat satu ruangan
+// (sisi barat dan utara, ditambah sisi timur/selatan di tepi gedung) dan
+// dibangun sebagai satu segmen, sehingga lubang pintu otomatis sejajar
+// untuk kedua tetangga; dinding luar diberi jendela. Pintu membentuk pohon
+// merentang per lantai (setiap ruangan tersambung ke barat atau utara)
+// ditambah pintu ekstra, jadi semua ruangan satu lantai bisa dicapai.
+// Semua keputusan berasal dari hash (seed, lantai, x, z): tiap ruangan
+// dibuat mandiri di thread pool dan hasilnya identik berapa pun threadnya.
+struct BuildingLayout {
+    int roomsX = 4;
+    int roomsZ = 3;
+    int floors = 1;
+    uint64_t seed = 1;
+    glm::vec3 origin = glm::vec3(0.0f);              // Pusat lantai ruangan (0, 0) lantai 0
+    glm::vec3 cellSize = glm::vec3(10.0f, 3.0f, 8.0f);
+    glm::vec3 floorColor = glm::vec3(0.6f, 0.5f, 0.4f);
+    glm::vec3 wallColor = glm::vec3(0.9f, 0.88f, 0.82f);
+    glm::vec3 ceilingColor = glm::vec3(0.95f);
+    
+    int roomCount() const { return roomsX * roomsZ * floors; }
+    
+    // Aturan perabot dan lubang jendela/pintu butuh ruangan minimal 6 x 2.6 x 6
+    bool isValid() const {
+        return roomsX >= 1 && roomsZ >= 1 && floors >= 1 &&
+               (int64_t)roomsX * roomsZ * floors <= 1000000 &&
+               cellSize.x >= 6.0f && cellSize.z >= 6.0f && cellSize.y >= 2.6f &&
+               glm::all(glm::lessThanEqual(cellSize, glm::vec3(100.0f)));
+    }
+};
+
+// splitmix64: urutan sama di semua platform (distribusi std:: tidak)
+struct LayoutRandom {
+    uint64_t state;
+    
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+    float uniform() { return (next() >> 40) * (1.0f / 16777216.0f); }
+    bool chance(float p) { return uniform() < p; }
+    int pick(int count) { return (int)(uniform() * count) % count; }
+};
+
+// Menulis satu pernyataan scene; float memakai representasi terpendek
+// yang kembali ke nilai yang sama (std::to_chars, tidak tergantung locale)
+class SceneTextWriter {
+public:
+    explicit SceneTextWriter(std::string& out) : out(out) {}
+    
+    SceneTextWriter& begin(const char* keyword, const char* name) {
+        out += keyword;
+        if (name) {
+            out += " name=\"";
+            out += name;
+            out += '"';
+        }
+        return *this;
+    }
+    SceneTextWriter& value(const char* key, glm::vec3 v, int count = 3) {
+        out += ' ';
+        out += key;
+        out += '=';
+        for (int i = 0; i < count; i++) {
+            if (i > 0) out += ',';
+            appendFloat(v[i]);
+        }
+        return *this;
+    }
+    SceneTextWriter& number(const char* key, float v) {
+        out += ' ';
+        out += key;
+        out += '=';
+        appendFloat(v);
+        return *this;
+    }
+    SceneTextWriter& yaw(float degrees) {
+        return degrees == 0.0f ? *this : value("rot", glm::vec3(0.0f, degrees, 0.0f));
+    }
+    SceneTextWriter& flag(const char* text) {
+        out += ' ';
+        out += text;
+        return *this;
+    }
+    void end() { out += '\n'; }
+    
+private:
+    std::string& out;
+    
+    void appendFloat(float v) {
+        char buffer[32];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), v);
+        out.append(buffer, result.ptr);
+    }
+};
+
+class BuildingGenerator {
+public:
+    BuildingLayout layout;
+    
+    // Teks scene seluruh gedung; blok per ruangan dibuat paralel lalu
+    // digabung berurutan (lantai, z, x)
+    std::string generate(ThreadPool& pool) const {
+        std::vector<std::string> blocks(layout.roomCount());
+        pool.parallelFor((int)blocks.size(), [&](int index) {
+            int x = index % layout.roomsX;
+            int z = (index / layout.roomsX) % layout.roomsZ;
+            int floor = index / (layout.roomsX * layout.roomsZ);
+            generateRoom(floor, x, z, blocks[index]);
+        });
+        
+        std::ostringstream header;
+        header << "# building rooms=" << layout.roomsX << "," << layout.roomsZ << " floors=" << layout.floors
+               << " seed=" << layout.seed << " (" << blocks.size() << " ruangan)\n";
+        std::string text = header.str();
+        size_t total = text.size();
+        for (const std::string& block : blocks) total += block.size();
+        text.reserve(total);
+        for (const std::string& block : blocks) text += block;
+        return text;
+    }
+    
+private:
+    static constexpr float SLAB_THICKNESS = 0.1f;     // Langit-langit di bawah lantai atas
+    static constexpr float DOOR_CLEARANCE = 1.0f;     // Setengah lebar jalur bebas di tengah dinding
+    static constexpr int EXTRA_DOOR_PERCENT = 25;     // Pintu di luar pohon merentang
+    
+    uint64_t hash(int floor, int x, int z, int salt) const {
+        SceneHasher hasher;
+        int32_t key[4] = {floor, x, z, salt};
+        hasher.mix(&layout.seed, sizeof(layout.seed));
+        hasher.mix(key, sizeof(key));
+        return LayoutRandom{hasher.value}.next();
+    }
+    
+    // Pohon merentang: ruangan (x, z) tersambung ke barat atau ke utara
+    bool treeWest(int floor, int x, int z) const {
+        if (x == 0) return false;
+        if (z == 0) return true;
+        return (hash(floor, x, z, 0) & 1) != 0;
+    }
+    bool doorWest(int floor, int x, int z) const {
+        if (x == 0) return false;
+        return treeWest(floor, x, z) || hash(floor, x, z, 1) % 100 < EXTRA_DOOR_PERCENT;
+    }
+    bool doorNorth(int floor, int x, int z) const {
+        if (z == 0) return false;
+        return !treeWest(floor, x, z) || hash(floor, x, z, 2) % 100 < EXTRA_DOOR_PERCENT;
+    }
+    
+    // Satu segmen dinding; along = arah dinding (X atau Z), inward = arah
+    // masuk ke ruangan pemilik (untuk jendela dan daun pintu)
+    void wall(SceneTextWriter& w, glm::vec3 center, bool alongX, float length, WallOpening opening,
+              glm::vec3 inward) const {
+        const char* builders[3] = {"wall", "wallwindow", "walldoor"};
+        w.begin(builders[opening], "Dinding").value("pos", center)
+            .value("size", glm::vec3(length, layout.cellSize.y, 0.0f), 2)
+            .value("color", layout.wallColor).yaw(alongX ? 0.0f : 90.0f).flag("collide=triangles").end();
+        
+        glm::vec3 inner = center + inward * (WALL_THICKNESS / 2.0f);
+        if (opening == OPENING_WINDOW) {
+            // createWindow menghadap +Z lokal: putar agar menghadap ke dalam
+            float yaw = glm::degrees(std::atan2(inward.x, inward.z));
+            w.begin("window", "Jendela").value("pos", inner + inward * 0.01f)
+                .value("color", glm::vec3(0.6f, 0.8f, 0.9f)).yaw(yaw).end();
+        } else if (opening == OPENING_DOOR) {
+            // Daun pintu terbuka 90 derajat ke ruangan pemilik, engsel di
+            // tepi lubang, tegak lurus dinding
+            glm::vec3 along = alongX ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 0.0f, 1.0f);
+            glm::vec3 pos = inner + inward * 0.5f - along * 0.475f;
+            w.begin("door", "Pintu").value("pos", pos).value("color", glm::vec3(0.5f, 0.35f, 0.2f))
+                .yaw(alongX ? 90.0f : 0.0f).flag("collide=box").end();
+        }
+    }
+    
+    // Titik-titik sepanjang dinding untuk perabot selebar `width`, dari
+    // sudut ke tengah, menghindari jalur pintu/jendela di tengah dinding
+    static std::vector<float> wallSlots(float wallLength, float width, float cornerGap) {
+        std::vector<float> slots;
+        float half = wallLength / 2.0f - WALL_THICKNESS / 2.0f - cornerGap;
+        for (float side : {-1.0f, 1.0f}) {
+            for (float edge = half; edge - width >= DOOR_CLEARANCE; edge -= width + 0.1f) {
+                slots.push_back(side * (edge - width / 2.0f));
+            }
+        }
+        return slots;
+    }
+    
+    void generateRoom(int floor, int x, int z, std::string& out) const {
+        const glm::vec3& cell = layout.cellSize;
+        glm::vec3 c = layout.origin + glm::vec3(x * cell.x, floor * cell.y, z * cell.z);
+        float hw = cell.x / 2.0f, hd = cell.z / 2.0f;
+        float ceilingHeight = cell.y - SLAB_THICKNESS;
+        bool lastX = x == layout.roomsX - 1, lastZ = z == layout.roomsZ - 1;
+        LayoutRandom rng{hash(floor, x, z, 3)};
+        SceneTextWriter w(out);
+        
+        out += "# Lantai ";
+        out += std::to_string(floor + 1);
+        out += ", ruangan ";
+        out += std::to_string(x + 1);
+        out += ",";
+        out += std::to_string(z + 1);
+        out += "\n";
+        
+        // Lantai, langit-langit, dan atap di lantai teratas
+        w.begin("floor", "Lantai").value("size", glm::vec3(cell.x, cell.z, 0.0f), 2).value("pos", c)
+            .value("color", layout.floorColor).flag("collide=triangles").end();
+        w.begin("ceiling", "Langit-langit").value("size", glm::vec3(cell.x, ceilingHeight, cell.z))
+            .value("pos", c).value("color", layout.ceilingColor).flag("collide=triangles").end();
+        if (floor == layout.floors - 1) {
+            w.begin("floor", "Atap").value("size", glm::vec3(cell.x, cell.z, 0.0f), 2)
+                .value("pos", c + glm::vec3(0.0f, cell.y, 0.0f)).value("color", layout.wallColor * 0.6f)
+                .flag("collide=triangles").end();
+        }
+        
+        // Kolom di titik temu dinding: dinding mengisi celah di antaranya
+        // tanpa tumpang tindih (tidak ada z-fighting di sudut)
+        auto column = [&](float dx, float dz) {
+            w.begin("cube", "Kolom").value("size", glm::vec3(WALL_THICKNESS, cell.y, WALL_THICKNESS))
+                .value("pos", c + glm::vec3(dx, cell.y / 2.0f, dz)).value("color", layout.wallColor)
+                .flag("collide=box").end();
+        };
+        column(-hw, -hd);
+        if (lastX) column(hw, -hd);
+        if (lastZ) column(-hw, hd);
+        if (lastX && lastZ) column(hw, hd);
+        
+        // Dinding milik ruangan ini: barat dan utara, plus timur/selatan di tepi
+        float lengthX = cell.x - WALL_THICKNESS, lengthZ = cell.z - WALL_THICKNESS;
+        auto exterior = [&]() { return rng.chance(0.85f) ? OPENING_WINDOW : OPENING_NONE; };
+        auto interior = [](bool door) { return door ? OPENING_DOOR : OPENING_NONE; };
+        wall(w, c + glm::vec3(0.0f, 0.0f, -hd), true, lengthX,
+             z == 0 ? exterior() : interior(doorNorth(floor, x, z)), glm::vec3(0.0f, 0.0f, 1.0f));
+        wall(w, c + glm::vec3(-hw, 0.0f, 0.0f), false, lengthZ,
+             x == 0 ? exterior() : interior(doorWest(floor, x, z)), glm::vec3(1.0f, 0.0f, 0.0f));
+        if (lastX) wall(w, c + glm::vec3(hw, 0.0f, 0.0f), false, lengthZ, exterior(), glm::vec3(-1.0f, 0.0f, 0.0f));
+        if (lastZ) wall(w, c + glm::vec3(0.0f, 0.0f, hd), true, lengthX, exterior(), glm::vec3(0.0f, 0.0f, -1.0f));
+        
+        // Lampu gantung dan cahaya ruangan
+        w.begin("lamp", "Lampu gantung").value("pos", c + glm::vec3(0.0f, ceilingHeight - 0.3f, 0.0f))
+            .value("color", glm::vec3(1.0f, 0.95f, 0.8f)).flag("collide=box noshadow").end();
+        w.begin("light", nullptr).value("pos", c + glm::vec3(0.0f, ceilingHeight - 0.5f, 0.0f))
+            .value("color", glm::vec3(1.0f, 0.9f, 0.7f))
+            .number("radius", 0.45f * std::max(cell.x, cell.z)).end();
+        
+        // Jenis ruangan: kantor 60%, rapat 25%, gudang 15%
+        float kind = rng.uniform();
+        if (kind < 0.6f) officeRoom(w, rng, c);
+        else if (kind < 0.85f) meetingRoom(w, rng, c);
+        else storageRoom(w, rng, c);
+    }
+    
+    // Kantor: deret meja kerja (meja, kursi, monitor, keyboard) menempel
+    // dinding utara, sebagian juga di dinding selatan menghadap sebaliknya
+    void officeRoom(SceneTextWriter& w, LayoutRandom& rng, glm::vec3 c) const {
+        const glm::vec3 deskColors[3] = {glm::vec3(0.55f, 0.4f, 0.25f), glm::vec3(0.7f, 0.6f, 0.45f),
+                                         glm::vec3(0.35f, 0.25f, 0.18f)};
+        const glm::vec3 chairColors[3] = {glm::vec3(0.15f), glm::vec3(0.2f, 0.25f, 0.4f),
+                                          glm::vec3(0.4f, 0.1f, 0.1f)};
+        const glm::vec3 bookColors[3] = {glm::vec3(0.8f, 0.2f, 0.2f), glm::vec3(0.2f, 0.4f, 0.8f),
+                                         glm::vec3(0.2f, 0.6f, 0.3f)};
+        glm::vec3 deskColor = deskColors[rng.pick(3)];
+        float hd = layout.cellSize.z / 2.0f;
+        
+        for (float side : {-1.0f, 1.0f}) {   // -1 = dinding utara, 1 = selatan
+            float fill = side < 0.0f ? 0.8f : 0.5f;
+            float yaw = side < 0.0f ? 0.0f : 180.0f;
+            glm::vec3 toward(0.0f, 0.0f, -side);   // Dari dinding ke tengah ruangan
+            float deskZ = side * (hd - WALL_THICKNESS / 2.0f - 0.42f);
+            for (float slot : wallSlots(layout.cellSize.x, 1.6f, 0.05f)) {
+                if (!rng.chance(fill)) continue;
+                glm::vec3 p = c + glm::vec3(slot, 0.0f, deskZ);
+                glm::vec3 top = p + glm::vec3(0.0f, 0.78f, 0.0f);
+                w.begin("desk", "Meja").value("pos", p).value("color", deskColor).yaw(yaw)
+                    .flag("collide=box").end();
+                w.begin("chair", "Kursi").value("pos", p + toward * 1.3f).value("color", chairColors[rng.pick(3)])
+                    .yaw(180.0f - yaw).flag("collide=box dynamic").end();
+                w.begin("monitor", "Monitor").value("pos", top - toward * 0.1f).value("color", glm::vec3(0.2f))
+                    .yaw(yaw).flag("collide=box").end();
+                w.begin("keyboard", "Keyboard").value("pos", top + toward * 0.2f).value("color", glm::vec3(0.15f))
+                    .yaw(yaw).end();
+                if (rng.chance(0.3f)) {
+                    w.begin("book", "Buku").value("pos", p + glm::vec3(-0.5f, 0.795f, 0.0f) + toward * 0.3f)
+                        .value("color", bookColors[rng.pick(3)])
+                        .value("rot", glm::vec3(90.0f, rng.uniform() * 40.0f - 20.0f, 0.0f)).end();
+                }
+            }
+        }
+        if (rng.chance(0.5f)) {
+            w.begin("rug", "Karpet").value("size", glm::vec3(3.0f, 2.0f, 0.0f), 2).value("pos", c)
+                .value("color", glm::vec3(0.5f, 0.2f, 0.2f)).end();
+        }
+    }
+    
+    // Ruang rapat: dua meja digabung di tengah di atas karpet, kursi mengelilingi
+    void meetingRoom(SceneTextWriter& w, LayoutRandom& rng, glm::vec3 c) const {
+        const glm::vec3 rugColors[3] = {glm::vec3(0.5f, 0.2f, 0.2f), glm::vec3(0.2f, 0.3f, 0.45f),
+                                        glm::vec3(0.35f, 0.4f, 0.3f)};
+        glm::vec3 tableColor = rng.chance(0.5f) ? glm::vec3(0.55f, 0.4f, 0.25f) : glm::vec3(0.35f, 0.25f, 0.18f);
+        glm::vec3 chairColor = rng.chance(0.5f) ? glm::vec3(0.15f) : glm::vec3(0.2f, 0.25f, 0.4f);
+        
+        w.begin("rug", "Karpet").value("size", glm::vec3(5.0f, 3.2f, 0.0f), 2).value("pos", c)
+            .value("color", rugColors[rng.pick(3)]).end();
+        for (float dx : {-0.8f, 0.8f}) {
+            w.begin("desk", "Meja rapat").value("pos", c + glm::vec3(dx, 0.0f, 0.0f)).value("color", tableColor)
+                .flag("collide=box").end();
+            // Kursi menghadap +Z lokal: sisi utara rot 0, sisi selatan rot 180
+            for (float side : {-1.0f, 1.0f}) {
+                if (!rng.chance(0.85f)) continue;
+                w.begin("chair", "Kursi").value("pos", c + glm::vec3(dx, 0.0f, side * 0.95f))
+                    .value("color", chairColor).yaw(side < 0.0f ? 0.0f : 180.0f).flag("collide=box dynamic").end();
+            }
+        }
+        for (float side : {-1.0f, 1.0f}) {
+            w.begin("chair", "Kursi").value("pos", c + glm::vec3(side * 2.1f, 0.0f, 0.0f))
+                .value("color", chairColor).yaw(side < 0.0f ? 90.0f : -90.0f).flag("collide=box dynamic").end();
+        }
+    }
+    
+    // Gudang: lemari sepanjang keempat dinding, kardus (dinamis) di tengah
+    void storageRoom(SceneTextWriter& w, LayoutRandom& rng, glm::vec3 c) const {
+        const glm::vec3& cell = layout.cellSize;
+        const glm::vec3 cabinetColors[3] = {glm::vec3(0.6f, 0.45f, 0.3f), glm::vec3(0.5f, 0.5f, 0.52f),
+                                            glm::vec3(0.7f, 0.62f, 0.5f)};
+        glm::vec3 cabinetColor = cabinetColors[rng.pick(3)];
+        float inset = WALL_THICKNESS / 2.0f + 0.25f;
+        
+        // Depan lemari di +Z lokal: putar agar menghadap ke tengah ruangan.
+        // Celah sudut 0.55 m menyisakan tempat untuk lemari dinding tegak lurus.
+        for (float side : {-1.0f, 1.0f}) {
+            for (float slot : wallSlots(cell.x, 0.8f, 0.55f)) {
+                if (!rng.chance(0.8f)) continue;
+                w.begin("cabinet", "Lemari").value("pos", c + glm::vec3(slot, 0.0f, side * (cell.z / 2.0f - inset)))
+                    .value("color", cabinetColor).yaw(side < 0.0f ? 0.0f : 180.0f).flag("collide=box").end();
+            }
+            for (float slot : wallSlots(cell.z, 0.8f, 0.55f)) {
+                if (!rng.chance(0.8f)) continue;
+                w.begin("cabinet", "Lemari").value("pos", c + glm::vec3(side * (cell.x / 2.0f - inset), 0.0f, slot))
+                    .value("color", cabinetColor).yaw(side < 0.0f ? 90.0f : -90.0f).flag("collide=box").end();
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            if (!rng.chance(0.6f)) continue;
+            glm::vec3 p = c + glm::vec3((i % 2) * 1.2f - 0.6f, 0.25f, (i / 2) * 1.2f - 0.6f);
+            w.begin("cube", "Kardus").value("size", glm::vec3(0.6f, 0.5f, 0.6f)).value("pos", p)
+                .value("color", glm::vec3(0.65f, 0.5f, 0.3f)).yaw(rng.uniform() * 90.0f - 45.0f)
+                .flag("collide=box dynamic").end();
+        }
+    }
+};
+
+// =====================================================================
+// FILE SCENE (TATA LETAK RUANGAN BERBASIS DATA)
+// =====================================================================
+// Ruangan, perabot, transform, dan lampu dibaca dari file teks (lihat
+// scenes/room.scene), satu pernyataan per baris:
+//   <jenis> [kunci=nilai ...] [flag ...]
+// File di-mmap dan diparse baris demi baris langsung dari memori (tanpa
+// salinan seluruh file atau daftar token). Mesh dibuat lewat builder
+// create* yang sudah ada, sekali per kombinasi builder + ukuran + warna
+// (prototype, lalu dipecah/divalidasi dan disimpan di cache mesh); setiap
+// instance hanya menyimpan indeks prototype dan transform, sehingga denah
+// kantor dengan puluhan ribu perabot tetap dimuat jauh di bawah satu detik.
+std::string sceneFilePath = "scenes/room.scene";   // --scene
+
+// Builder mesh yang bisa dipakai dari file scene. size: cube/walls = W,H,D,
+// floor/rug = W,D, ceiling = W,H,D (H = tinggi langit-langit),
+// wall/wallwindow/walldoor = panjang,tinggi (segmen dinding gedung)
+struct SceneBuilder {
+    const char* type;
+    int sizeComponents;   // 0 = builder tidak memakai ukuran
+    Object3D (*build)(const glm::vec3& size, const glm::vec3& color);
+};
+
+const SceneBuilder SCENE_BUILDERS[] = {
+    {"cube",     3, [](const glm::vec3& s, const glm::vec3& c) { return createCube(s.x, s.y, s.z, c); }},
+    {"floor",    2, [](const glm::vec3& s, const glm::vec3& c) { return createFloor(s.x, s.y, c); }},
+    {"walls",    3, [](const glm::vec3& s, const glm::vec3& c) { return createWalls(s.x, s.y, s.z, c); }},
+    {"ceiling",  3, [](const glm::vec3& s, const glm::vec3& c) { return createCeiling(s.x, s.z, s.y, c); }},
+    {"window",   0, [](const glm::vec3&, const glm::vec3& c) { return createWindow(c); }},
+    {"door",     0, [](const glm::vec3&, const glm::vec3& c) { return createDoor(c); }},
+    {"desk",     0, [](const glm::vec3&, const glm::vec3& c) { return createDesk(c); }},
+    {"chair",    0, [](const glm::vec3&, const glm::vec3& c) { return createChair(c); }},
+    {"monitor",  0, [](const glm::vec3&, const glm::vec3& c) { return createMonitor(c); }},
+    {"keyboard", 0, [](const glm::vec3&, const glm::vec3& c) { return createKeyboard(c); }},
+    {"cabinet",  0, [](const glm::vec3&, const glm::vec3& c) { return createCabinet(c); }},
+    {"lamp",     0, [](const glm::vec3&, const glm::vec3& c) { return createCeilingLamp(c); }},
+    {"book",     0, [](const glm::vec3&, const glm::vec3& c) { return createBook(c); }},
+    {"rug",      2, [](const glm::vec3& s, const glm::vec3& c) { return createRug(s.x, s.y, c); }},
+    {"wall",       2, [](const glm::vec3& s, const glm::vec3& c) { return createWallSegment(s.x, s.y, OPENING_NONE, c); }},
+    {"wallwindow", 2, [](const glm::vec3& s, const glm::vec3& c) { return createWallSegment(s.x, s.y, OPENING_WINDOW, c); }},
+    {"walldoor",   2, [](const glm::vec3& s, const glm::vec3& c) { return createWallSegment(s.x, s.y, OPENING_DOOR, c); }},
+};
+
+int findSceneBuilder(std::string_view type) {
+    for (int b = 0; b < (int)(sizeof(SCENE_BUILDERS) / sizeof(SCENE_BUILDERS[0])); b++) {
+        if (type == SCENE_BUILDERS[b].type) return b;
+    }
+    return -1;
+}
+
+struct SceneInstance {
+    int prototype;
+    std::string name;
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 rotation = glm::vec3(0.0f);
+    glm::vec3 scale = glm::vec3(1.0f);
+    ColliderMode collider = COLLIDE_NONE;
+    bool isDynamic = false;
+    bool castsShadow = true;
+};
+
+class SceneDescription {
+public:
+    glm::vec3 roomSize = glm::vec3(10.0f, 4.0f, 8.0f);   // Ruangan pertama
+    bool hasMainLight = false;
+    glm::vec3 mainLightPos = glm::vec3(0.0f);
+    glm::vec3 mainLightColor = glm::vec3(1.0f);
+    std::vector<PointLight> lights;
+    std::vector<Object3D> prototypes;
+    std::vector<SceneInstance> instances;
+    int rooms = 0;
+    int lineCount = 0;
+    int errors = 0;
+    bool subdivideStatic = false;   // Pecah permukaan besar objek statis (AO/bake)
+    int flippedTriangles = 0;       // Winding diperbaiki saat menyiapkan prototype
+    ThreadPool* pool = nullptr;     // Pool import model/generator gedung (null = workerPool())
+    std::string* expandInto = nullptr;   // Jika diisi: salinan scene dengan `building` diperluas
+    
+    bool loadFile(const std::string& path) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "ERROR: Cannot open scene file: " << path << std::endl;
+            return false;
+        }
+        parse(file.view(), path);
+        meshCache().save();
+        return true;
+    }
+    
+    void parse(std::string_view text, const std::string& sourceName) {
+        while (!text.empty()) {
+            size_t end = text.find('\n');
+            std::string_view line = text.substr(0, end);
+            text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+            lineCount++;
+            expandedStatement = false;
+            if (!parseLine(line)) {
+                errors++;
+                std::cerr << "ERROR: " << sourceName << ":" << lineCount << ": "
+                          << "Invalid scene statement: " << line << std::endl;
+            }
+            if (expandInto && !expandedStatement) expandInto->append(line).append("\n");
+        }
+    }
+    
+    // Lampu utama dari scene menggantikan posisi/warna bawaan
+    void applyMainLight() const {
+        if (!hasMainLight) return;
+        lightPos = mainLightPos;
+        lightColor = mainLightColor;
+    }
+    
+    // Salin mesh prototype ke objek mandiri per instance (untuk upload GPU)
+    std::vector<Object3D> instantiate() const {
+        std::vector<Object3D> objects;
+        objects.reserve(instances.size());
+        for (const SceneInstance& instance : instances) {
+            objects.push_back(prototypes[instance.prototype]);
+            Object3D& obj = objects.back();
+            obj.name = instance.name;
+            obj.position = instance.position;
+            obj.rotation = instance.rotation;
+            obj.scale = instance.scale;
+            obj.collider = instance.collider;
+            obj.isDynamic = instance.isDynamic;
+            obj.castsShadow = instance.castsShadow;
+        }
+        return objects;
+    }
+    
+private:
+    std::map<uint64_t, int> prototypeKeys;
+    bool expandedStatement = false;   // Baris terakhir diganti teks hasil generator
+    
+    // Token dipisah spasi; nilai dalam tanda kutip boleh berisi spasi
+    static bool nextToken(std::string_view& line, std::string_view& token) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string_view::npos || line[start] == '#') return false;
+        size_t end = start;
+        bool quoted = false;
+        while (end < line.size() && (quoted || (line[end] != ' ' && line[end] != '\t' && line[end] != '\r'))) {
+            if (line[end] == '"') quoted = !quoted;
+            end++;
+        }
+        token = line.substr(start, end - start);
+        line = line.substr(end);
+        return true;
+    }
+    
+    // "x,y,z" -> jumlah komponen yang terbaca (0 jika tidak valid)
+    static int parseFloats(std::string_view value, float* out, int maxCount) {
+        int count = 0;
+        const char* p = value.data();
+        const char* end = value.data() + value.size();
+        while (p < end && count < maxCount) {
+            std::from_chars_result result = std::from_chars(p, end, out[count]);
+            if (result.ec != std::errc()) return 0;
+            count++;
+            p = result.ptr;
+            if (p < end && *p != ',') return 0;
+            if (p < end) p++;
+        }
+        return p == end ? count : 0;
+    }
+    
+    static int parseInts(std::string_view value, int* out, int maxCount) {
+        float v[3];
+        int count = parseFloats(value, v, std::min(maxCount, 3));
+        for (int i = 0; i < count; i++) {
+            if (v[i] != std::floor(v[i]) || std::fabs(v[i]) > 1.0e6f) return 0;
+            out[i] = (int)v[i];
+        }
+        return count;
+    }
+    
+    static bool parseVec3(std::string_view value, glm::vec3& out) {
+        float v[3];
+        if (parseFloats(value, v, 3) != 3) return false;
+        out = glm::vec3(v[0], v[1], v[2]);
+        return true;
+    }
+    
+    // Mesh disiapkan sekali per builder + ukuran + warna + material: dari
+    // cache mesh, atau builder -> pecah permukaan besar -> validasi winding.
+    // material < 0: material bawaan builder per bagian.
+    int prototype(int builder, glm::vec3 size, const glm::vec3& color, int material, bool isDynamic) {
+        if (SCENE_BUILDERS[builder].sizeComponents == 0) size = glm::vec3(0.0f);
+        bool subdivide = subdivideStatic && !isDynamic;
+        SceneHasher hash;
+        hash.mix(&MESH_CACHE_VERSION, sizeof(MESH_CACHE_VERSION));
+        hash.mix(SCENE_BUILDERS[builder].type, std::strlen(SCENE_BUILDERS[builder].type));
+        hash.mix(&size, sizeof(size));
+        hash.mix(&color, sizeof(color));
+        hash.mix(&material, sizeof(material));
+        hash.mix(&subdivide, sizeof(subdivide));
+        return preparePrototype(hash.value, SCENE_BUILDERS[builder].type, subdivide, [&](Object3D& mesh) {
+            mesh = SCENE_BUILDERS[builder].build(size, color);
+            if (material >= 0) setMaterial(mesh, (MaterialId)material);
+            return true;
+        });
+    }
+    
+    // Model impor (OBJ/glTF). Kunci memuat ukuran dan waktu ubah file
+    // sehingga cache mesh basi sendiri saat model diekspor ulang.
+    int modelPrototype(const std::string& path, const glm::vec3& color, int material, NormalMode normals,
+                       bool isDynamic) {
+        std::error_code error;
+        uint64_t fileSize = std::filesystem::file_size(path, error);
+        if (error) {
+            std::cerr << "ERROR: Cannot open model file: " << path << std::endl;
+            return -1;
+        }
+        int64_t modified = (int64_t)std::filesystem::last_write_time(path, error).time_since_epoch().count();
+        bool subdivide = subdivideStatic && !isDynamic;
+        SceneHasher hash;
+        hash.mix(&MESH_CACHE_VERSION, sizeof(MESH_CACHE_VERSION));
+        hash.mix("model", 5);
+        hash.mix(path.data(), path.size());
+        hash.mix(&fileSize, sizeof(fileSize));
+        hash.mix(&modified, sizeof(modified));
+        hash.mix(&color, sizeof(color));
+        hash.mix(&material, sizeof(material));
+        hash.mix(&normals, sizeof(normals));
+        hash.mix(&subdivide, sizeof(subdivide));
+        return preparePrototype(hash.value, path.c_str(), subdivide, [&](Object3D& mesh) {
+            ModelImporter importer;
+            importer.normalMode = normals;
+            importer.defaultColor = color;
+            double start = monotonicTime();
+            if (!importer.load(path, mesh, pool ? *pool : workerPool())) return false;
+            if (material >= 0) setMaterial(mesh, (MaterialId)material);
+            std::cout << "Import model: " << path << " - " << importer.triangles << " segitiga, "
+                      << importer.generatedNormals << " normal dibuat, "
+                      << (monotonicTime() - start) * 1000.0 << " ms" << std::endl;
+            return true;
+        });
+    }
+    
+    // Dari cache mesh, atau build -> pecah permukaan besar -> validasi winding.
+    // BVH segitiga (picking) dibangun sekali di sini; instance menyalin
+    // shared_ptr-nya sehingga semua instance memakai BVH yang sama.
+    int preparePrototype(uint64_t key, const char* label, bool subdivide,
+                         const std::function<bool(Object3D&)>& build) {
+        auto it = prototypeKeys.find(key);
+        if (it != prototypeKeys.end()) return it->second;
+        
+        Object3D mesh;
+        if (!meshCacheEnabled || !meshCache().load(key, mesh)) {
+            if (!build(mesh)) return -1;
+            if (subdivide) subdivideLargeTriangles(mesh, 0.5f);
+            MeshValidationResult check = validateMesh(mesh);
+            if (check.flipped > 0) {
+                std::cout << "Validasi mesh: " << label << " - " << check.flipped
+                          << " segitiga winding diperbaiki" << std::endl;
+            }
+            flippedTriangles += check.flipped;
+            mesh.setLocalBounds(mesh.getLocalBounds());
+            if (meshCacheEnabled) meshCache().store(key, mesh);
+        }
+        mesh.bvh = std::make_shared<MeshBVH>();
+        mesh.bvh->build(mesh.vertices);
+        prototypes.push_back(std::move(mesh));
+        return prototypeKeys[key] = (int)prototypes.size() - 1;
+    }
+    
+    bool parseLine(std::string_view line) {
+        std::string_view keyword;
+        if (!nextToken(line, keyword)) return true;   // Baris kosong / komentar
+        
+        SceneInstance instance;
+        glm::vec3 size(1.0f), color(0.7f);
+        glm::vec3 floorColor(0.6f, 0.5f, 0.4f), wallColor(0.9f), ceilingColor(0.95f);
+        float radius = 1.0f;
+        int material = -1;
+        bool mainLight = false;
+        int sizeCount = 0;
+        std::string modelFile;
+        NormalMode normals = NORMALS_SMOOTH;
+        int buildingRooms[2] = {4, 3};
+        int buildingFloors = 1;
+        uint64_t buildingSeed = 1;
+        bool transformed = false;   // rot/scale ditulis (tidak berlaku untuk building)
+        
+        std::string_view token;
+        while (nextToken(line, token)) {
+            size_t equals = token.find('=');
+            std::string_view key = token.substr(0, equals);
+            std::string_view value = equals == std::string_view::npos ? std::string_view() : token.substr(equals + 1);
+            bool ok = true;
+            if (key == "name" && value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                instance.name.assign(value.substr(1, value.size() - 2));
+            } else if (key == "name") {
+                instance.name.assign(value);
+            } else if (key == "file" && value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+                modelFile.assign(value.substr(1, value.size() - 2));
+            } else if (key == "file") {
+                modelFile.assign(value);
+            } else if (key == "normals") {
+                if (value == "smooth") normals = NORMALS_SMOOTH;
+                else if (value == "flat") normals = NORMALS_FLAT;
+                else ok = false;
+            } else if (key == "pos") {
+                ok = parseVec3(value, instance.position);
+            } else if (key == "rot") {
+                ok = parseVec3(value, instance.rotation);
+                transformed = true;
+            } else if (key == "scale") {
+                ok = parseVec3(value, instance.scale);
+                transformed = true;
+            } else if (key == "color") {
+                ok = parseVec3(value, color);
+            } else if (key == "material") {
+                material = findMaterial(std::string(value));
+                ok = material >= 0;
+            } else if (key == "floor") {
+                ok = parseVec3(value, floorColor);
+            } else if (key == "wall") {
+                ok = parseVec3(value, wallColor);
+            } else if (key == "ceiling") {
+                ok = parseVec3(value, ceilingColor);
+            } else if (key == "size") {
+                sizeCount = parseFloats(value, &size.x, 3);
+                ok = sizeCount >= 2;
+            } else if (key == "radius") {
+                ok = parseFloats(value, &radius, 1) == 1;
+            } else if (key == "rooms") {
+                ok = parseInts(value, buildingRooms, 2) == 2;
+            } else if (key == "floors") {
+                ok = parseInts(value, &buildingFloors, 1) == 1;
+            } else if (key == "seed") {
+                std::from_chars_result result = std::from_chars(value.data(), value.data() + value.size(), buildingSeed);
+                ok = result.ec == std::errc() && result.ptr == value.data() + value.size();
+            } else if (key == "collide") {
+                if (value == "none") instance.collider = COLLIDE_NONE;
+                else if (value == "box") instance.collider = COLLIDE_BOX;
+                else if (value == "triangles") instance.collider = COLLIDE_TRIANGLES;
+                else ok = false;
+            } else if (key == "dynamic" && value.empty()) {
+                instance.isDynamic = true;
+            } else if (key == "noshadow" && value.empty()) {
+                instance.castsShadow = false;
+            } else if (key == "main" && value.empty()) {
+                mainLight = true;
+            } else {
+                ok = false;
+            }
+            if (!ok) return false;
+        }
+        
+        if (keyword == "light") {
+            if (mainLight) {
+                hasMainLight = true;
+                mainLightPos = instance.position;
+                mainLightColor = color;
+            } else {
+                lights.push_back({instance.position, color, radius});
+            }
+            return true;
+        }
+        
+        if (keyword == "room") {
+            if (sizeCount != 3) return false;
+            if (rooms++ == 0) roomSize = size;
+            // Lantai, dinding, dan langit-langit dengan kolisi per segitiga
+            const char* names[3] = {"Lantai", "Dinding", "Langit-langit"};
+            const char* builders[3] = {"floor", "walls", "ceiling"};
+            const glm::vec3 sizes[3] = {glm::vec3(size.x, size.z, 0.0f), size, size};
+            const glm::vec3 colors[3] = {floorColor, wallColor, ceilingColor};
+            for (int i = 0; i < 3; i++) {
+                SceneInstance part;
+                part.prototype = prototype(findSceneBuilder(builders[i]), sizes[i], colors[i], -1, false);
+                part.name = names[i];
+                part.position = instance.position;
+                part.collider = COLLIDE_TRIANGLES;
+                instances.push_back(part);
+            }
+            return true;
+        }
+        
+        if (keyword == "building") {
+            // Ukuran sel: default atau tiga komponen. Grid ruangan selalu
+            // sejajar sumbu, jadi rot/scale ditolak daripada diabaikan diam-diam.
+            if ((sizeCount != 0 && sizeCount != 3) || transformed) return false;
+            BuildingGenerator generator;
+            BuildingLayout& layout = generator.layout;
+            layout.roomsX = buildingRooms[0];
+            layout.roomsZ = buildingRooms[1];
+            layout.floors = buildingFloors;
+            layout.seed = buildingSeed;
+            layout.origin = instance.position;
+            if (sizeCount == 3) layout.cellSize = size;
+            layout.floorColor = floorColor;
+            layout.wallColor = wallColor;
+            layout.ceilingColor = ceilingColor;
+            if (!layout.isValid()) return false;
+            
+            std::string text = generator.generate(pool ? *pool : workerPool());
+            if (rooms == 0) roomSize = layout.cellSize;
+            rooms += layout.roomCount();
+            // Nomor baris pesan error tetap merujuk ke file asli
+            int line = lineCount;
+            parse(text, "building");
+            lineCount = line;
+            expandedStatement = true;
+            return true;
+        }
+        
+        if (keyword == "model") {
+            if (modelFile.empty()) return false;
+            instance.prototype = modelPrototype(modelFile, color, material, normals, instance.isDynamic);
+            if (instance.prototype < 0) return false;
+            if (instance.name.empty()) instance.name = std::filesystem::path(modelFile).stem().string();
+            instances.push_back(std::move(instance));
+            return true;
+        }
+        
+        int builder = findSceneBuilder(keyword);
+        if (builder < 0) return false;
+        int needed = SCENE_BUILDERS[builder].sizeComponents;
+        if (needed > 0 && sizeCount != needed) return false;
+        instance.prototype = prototype(builder, size, color, material, instance.isDynamic);
+        if (instance.name.empty()) instance.name.assign(keyword);
+        instances.push_back(std::move(instance));
+        return true;
+    }
+};
+
+// Objek scene (--scene) untuk benchmark yang berjalan tanpa window
+std::vector<Object3D> loadSceneObjects(bool subdivideStatic, glm::vec3* roomSize = nullptr) {
+    SceneDescription scene;
+    scene.subdivideStatic = subdivideStatic;
+    scene.loadFile(sceneFilePath);
+    scene.applyMainLight();
+    if (roomSize) *roomSize = scene.roomSize;
+    return scene.instantiate();
+}
+
+// =====================================================================
+// LOADING SCENE ASINKRON (UPLOAD GPU BERTAHAP)
+// =====================================================================
+// Window dan frame pertama tidak menunggu scene. Thread loader mem-parse
+// file scene dan membangun/mengimpor mesh dengan thread pool sendiri (agar
+// parallelFor milik render thread, misal cluster lampu, tidak ikut
+// menunggu), lalu menerbitkan objek per batch: penghalang AO dan cahaya
+// disiapkan sekali dari seluruh scene, setiap batch di-bake lalu langsung
+// masuk antrean objects[uploaded, published). Setiap frame render thread
+// mengambil objek dari antrean dan meng-upload-nya sampai batas byte
+// (--upload-budget MB); mesh yang lebih besar dari sisa budget dikirim per
+// potongan dengan glBufferSubData dan baru digambar setelah lengkap. Dunia
+// kolisi dan picking dibangun paling akhir, setelah semua objek terbit.
+// Fungsi di sini tidak memanggil GL dan tidak mengubah global lampu.
+size_t uploadBudgetBytes = 8u << 20;   // --upload-budget <MB>
+bool syncSceneLoad = false;            // --sync-load: tunggu scene sebelum frame pertama
+
+class SceneLoader {
+public:
+    // Boleh dibaca render thread setelah hasStarted(): ukuran objects tidak
+    // berubah lagi dan objek [0, publishedCount()) sudah final
+    SceneDescription scene;
+    std::vector<Object3D> objects;
+    AABB bounds;               // Bounds dunia semua objek (root loose octree)
+    double startMs = 0.0;      // Parse + instantiate (sebelum batch pertama)
+    
+    // Hasil akhir: hanya boleh disentuh render thread setelah isReady()
+    CollisionWorld collision;
+    PickScene pick;
+    bool succeeded = false;
+    double buildMs = 0.0;      // Waktu kerja thread loader
+    
+    // Statistik upload (render thread)
+    size_t uploaded = 0;       // Objek [0, uploaded) sudah lengkap di GPU
+    size_t uploadedBytes = 0;
+    int uploadFrames = 0;
+    
+    ~SceneLoader() { wait(); }
+    
+    void start(const std::string& path, bool subdivideStatic) {
+        scene.subdivideStatic = subdivideStatic;
+        worker = std::thread([this, path]() { run(path); });
+    }
+    
+    bool hasStarted() const { return started.load(std::memory_order_acquire); }
+    bool isReady() const { return ready.load(std::memory_order_acquire); }
+    size_t publishedCount() const { return published.load(std::memory_order_acquire); }
+    
+    void wait() {
+        if (worker.joinable()) worker.join();
+    }
+    
+    // Upload objek terbit berikutnya sampai budget byte. Kembalikan indeks
+    // awal; objek [awal, uploaded) baru saja siap digambar.
+    size_t upload(size_t budget) {
+        size_t first = uploaded, bytes = 0;
+        size_t available = publishedCount();
+        while (uploaded < available && bytes < budget) {
+            Object3D& obj = objects[uploaded];
+            size_t remaining = obj.vertices.size() - partialVertices;
+            size_t fit = std::max<size_t>((budget - bytes) / sizeof(Vertex), 1);
+            if (partialVertices == 0 && remaining <= fit) {
+                obj.setup();
+            } else {
+                // Mesh besar: alokasikan dulu, isi dikirim bertahap antar frame
+                if (partialVertices == 0) obj.setup(false);
+                size_t count = std::min(remaining, fit);
+                obj.uploadVertices(partialVertices, count);
+                partialVertices += count;
+                bytes += count * sizeof(Vertex);
+                if (partialVertices < obj.vertices.size()) break;
+                partialVertices = 0;
+                obj.gpuReady = true;
+                remaining = 0;
+            }
+            obj.setupBakedLight();
+            obj.setupBakedAO();
+            bytes += remaining * sizeof(Vertex);
+            if (obj.bakedVBO) bytes += obj.vertices.size() * 2 * sizeof(glm::vec4);
+            if (obj.aoVBO) bytes += obj.bakedAO.size() * sizeof(float);
+            uploaded++;
+        }
+        uploadedBytes += bytes;
+        if (bytes > 0) uploadFrames++;
+        return first;
+    }
+    
+private:
+    // Vertex statis per batch bake: cukup kecil agar objek pertama cepat
+    // tampil, cukup besar untuk membagi kerja ke semua worker
+    static constexpr size_t BAKE_BATCH_VERTICES = 16384;
+    
+    std::thread worker;
+    std::atomic<bool> started{false};
+    std::atomic<bool> ready{false};
+    std::atomic<size_t> published{0};
+    size_t partialVertices = 0;   // Progres upload objek objects[uploaded]
+    
+    void run(const std::string& path) {
+        double start = monotonicTime();
+        ThreadPool pool;
+        scene.pool = &pool;
+        bool loaded = scene.loadFile(path);
+        if (loaded) {
+            objects = scene.instantiate();
+            // Ruang untuk SceneEditor::addInstance tanpa realokasi vector
+            objects.reserve(objects.size() + objects.size() / 8 + 64);
+            for (const auto& obj : objects) {
+                AABB b = obj.getWorldBounds();
+                bounds.expand(b.min);
+                bounds.expand(b.max);
+            }
+        }
+        scene.pool = nullptr;
+        if (loaded) {
+            logValidation();
+            startMs = (monotonicTime() - start) * 1000.0;
+            started.store(true, std::memory_order_release);
+            
+            bakeAndPublish(pool);
+            for (auto& obj : objects) {
+                collision.addObject(obj, obj.collider);
+                pick.addObject(obj);
+            }
+            collision.build();
+            pick.build();
+            succeeded = true;
+        }
+        buildMs = (monotonicTime() - start) * 1000.0;
+        ready.store(true, std::memory_order_release);
+    }
+    
+    // Prototype sudah dipecah dan divalidasi (lihat SceneDescription::prototype).
+    // Instance berbagi vertex prototype, jadi memori vertex dihitung per blok.
+    void logValidation() const {
+        int culledTriangles = 0, totalTriangles = 0;
+        std::unordered_set<const Vertex*> blocks;
+        size_t vertexBytes = 0;
+        for (const auto& obj : objects) {
+            for (const DrawRange& range : obj.drawRanges) {
+                if (!range.twoSided) culledTriangles += range.count / 3;
+            }
+            totalTriangles += (int)obj.vertices.size() / 3;
+            if (blocks.insert(obj.vertices.data()).second) vertexBytes += obj.vertices.size() * sizeof(Vertex);
+        }
+        std::cout << "Validasi mesh: " << culledTriangles << " dari " << totalTriangles
+                  << " segitiga memakai back-face culling (" << scene.flippedTriangles
+                  << " diperbaiki, " << meshCache().hits << " mesh dari cache), vertex "
+                  << vertexBytes / 1024 << " KB untuk " << totalTriangles * 3 * sizeof(Vertex) / 1024
+                  << " KB instance" << std::endl;
+    }
+    
+    // Bake AO dan cahaya per batch objek, lalu terbitkan batch itu. Jika
+    // keduanya dari cache (atau nonaktif) semua objek terbit sekaligus.
+    void bakeAndPublish(ThreadPool& pool) {
+        AmbientOcclusionBaker aoBaker;
+        VertexLightBaker lightBaker;
+        double aoSeconds = 0.0, lightSeconds = 0.0;
+        bool bakeLight = false, bakeAO = false;
+        if (bakedLightingEnabled) {
+            if (scene.hasMainLight) lightBaker.color = scene.mainLightColor;
+            double begin = monotonicTime();
+            bakeLight = !lightBaker.begin(objects, scene.hasMainLight ? scene.mainLightPos : lightPos);
+            lightSeconds += monotonicTime() - begin;
+        }
+        if (aoEnabled) {
+            double begin = monotonicTime();
+            bakeAO = !aoBaker.begin(objects);
+            aoSeconds += monotonicTime() - begin;
+        }
+        
+        size_t next = 0;
+        while (next < objects.size()) {
+            size_t last = next, vertices = 0;
+            while (last < objects.size() && (vertices < BAKE_BATCH_VERTICES || (!bakeAO && !bakeLight))) {
+                if (!objects[last].isDynamic) vertices += objects[last].vertices.size();
+                last++;
+            }
+            double begin = monotonicTime();
+            if (bakeAO) aoBaker.bakeObjects(objects, next, last, pool);
+            double middle = monotonicTime();
+            if (bakeLight) lightBaker.bakeObjects(objects, next, last, pool);
+            aoSeconds += middle - begin;
+            lightSeconds += monotonicTime() - middle;
+            published.store(last, std::memory_order_release);
+            next = last;
+        }
+        
+        if (aoEnabled) {
+            double begin = monotonicTime();
+            aoBaker.finish(objects);
+            aoSeconds += monotonicTime() - begin;
+            if (aoBaker.skipped) {
+                std::cerr << "WARNING::AO::OVER_BUDGET bake dilewati, scene melebihi " << aoRayBudget
+                          << " ray dengan " << AmbientOcclusionBaker::MIN_SAMPLES
+                          << " sampel/vertex (--ao-budget)" << std::endl;
+            } else {
+                std::cout << "Bake AO: " << aoBaker.bakedVertices << " vertex x " << aoBaker.samples
+                          << " sampel, " << (aoBaker.loadedFromCache ? "dari cache" : "dihitung") << ", "
+                          << aoBaker.raysCast << " ray, " << aoSeconds * 1000.0 << " ms" << std::endl;
+            }
+        }
+        if (bakedLightingEnabled) {
+            double begin = monotonicTime();
+            lightBaker.finish(objects);
+            lightSeconds += monotonicTime() - begin;
+            std::cout << "Bake cahaya: " << lightBaker.bakedVertices << " vertex, "
+                      << (lightBaker.loadedFromCache ? "dari cache" : "dihitung") << ", "
+                      << lightBaker.raysCast << " ray, " << lightSeconds * 1000.0 << " ms" << std::endl;
+        }
+    }
+};
+
+// =====================================================================
+// EDIT SCENE INKREMENTAL (UPDATE SUB-RANGE BUFFER)
+// =====================================================================
+// Edit tata letak saat aplikasi berjalan: pindah, ganti warna, ganti
+// mesh, duplikasi, dan hapus objek. Setiap objek punya VBO sendiri, jadi
+// rentang kotor dicatat per VBO (Object3D::dirtyRanges) dan dikirim
+// sekali per frame lewat flush(). Pindah/rotasi cukup mengubah matriks
+// model (tanpa upload sama sekali); ganti warna hanya mengirim vertex
+// yang warnanya berubah. Struktur CPU (SceneIndex, kolisi, picking)
+// diperbarui per objek tanpa membangun ulang seluruh scene.
+class SceneEditor {
+public:
+    // Statistik (untuk log dan --bench-edit)
+    size_t uploadedBytes = 0;   // Byte yang benar-benar dikirim ke GPU
+    size_t bufferBytes = 0;     // Ukuran penuh buffer yang tersentuh (pembanding re-upload)
+    int flushes = 0;            // Frame dengan minimal satu upload
+    int edits = 0;
+    bool shadowsChanged = false;   // Shadow map perlu digambar ulang (direset pemanggil)
+    
+    // Tampilan objek: prototype mesh scene dan ganti warna berurutan sejak
+    // mesh terakhir dipasang. Cukup untuk membuat ulang vertex objek dari
+    // prototype (dipakai SceneSnapshot).
+    struct Recolor {
+        glm::vec3 from;
+        glm::vec3 to;
+    };
+    struct Appearance {
+        int32_t mesh = -1;   // Indeks SceneDescription::prototypes (-1: tidak diketahui)
+        std::vector<Recolor> recolors;
+        
+        bool operator==(const Appearance& other) const {
+            return mesh == other.mesh && recolors.size() == other.recolors.size() &&
+                   std::equal(recolors.begin(), recolors.end(), other.recolors.begin(),
+                              [](const Recolor& a, const Recolor& b) { return a.from == b.from && a.to == b.to; });
+        }
+    };
+    
+    // sceneDescription: prototype mesh dan prototype hasil load tiap objek
+    // (objek ke-i dibuat dari instance ke-i)
+    void attach(std::vector<Object3D>& sceneObjects, SceneIndex& sceneIndex,
+                CollisionWorld& collisionWorld, PickScene& pickScene,
+                const SceneDescription& sceneDescription) {
+        objects = &sceneObjects;
+        index = &sceneIndex;
+        collision = &collisionWorld;
+        pick = &pickScene;
+        scene = &sceneDescription;
+        pending.clear();
+        changed.clear();
+        changedFlags.assign(sceneObjects.size(), 0);
+        appearances.clear();
+    }
+    
+    bool isAttached() const { return objects != nullptr; }
+    
+    // Indeks objek yang pernah dipindah, diganti, diwarnai ulang, dibuat,
+    // atau dihapus sejak attach (objek lain masih persis seperti hasil
+    // load; lihat SceneSnapshot)
+    const std::vector<uint32_t>& changedObjects() const { return changed; }
+    
+    size_t prototypeCount() const { return scene->prototypes.size(); }
+    
+    const Object3D* prototype(int32_t mesh) const {
+        if (mesh < 0 || mesh >= (int32_t)scene->prototypes.size()) return nullptr;
+        return &scene->prototypes[mesh];
+    }
+    
+    // Tampilan hasil load objek ke-i (prototype instance-nya, tanpa edit warna)
+    Appearance loadedAppearance(size_t i) const {
+        Appearance appearance;
+        if (i < scene->instances.size()) appearance.mesh = scene->instances[i].prototype;
+        return appearance;
+    }
+    
+    Appearance appearanceOf(size_t i) const {
+        auto it = appearances.find((uint32_t)i);
+        return it != appearances.end() ? it->second : loadedAppearance(i);
+    }
+    
+    // Buat ulang vertex objek dari prototype lalu ulangi ganti warnanya.
+    // Return false jika prototype tidak ada di scene ini.
+    bool applyAppearance(Object3D& obj, const Appearance& appearance) {
+        if (!prototype(appearance.mesh)) return false;
+        replaceMesh(obj, appearance.mesh);
+        for (const Recolor& r : appearance.recolors) recolor(obj, r.from, r.to);
+        return true;
+    }
+    
+    // Transformasi baru: tidak ada data vertex yang dikirim
+    void move(Object3D& obj, const glm::vec3& position, const glm::vec3& rotation, const glm::vec3& scale) {
+        obj.position = position;
+        obj.rotation = rotation;
+        obj.scale = scale;
+        refresh(obj);
+    }
+    
+    // Vertex berwarna 'from' diganti 'to'. Hanya run vertex yang berubah
+    // yang ditandai kotor. Return jumlah vertex yang berubah.
+    size_t recolor(Object3D& obj, const glm::vec3& from, const glm::vec3& to) {
+        bool wasPending = !obj.dirtyRanges.empty();
+        size_t changed = 0, runStart = 0;
+        bool inRun = false;
+        std::vector<Vertex>* target = nullptr;   // Disalin dari blok bersama baru saat cocok pertama
+        for (size_t i = 0; i <= obj.vertices.size(); i++) {
+            bool match = i < obj.vertices.size() &&
+                         glm::all(glm::lessThan(glm::abs(obj.vertices[i].color - from), glm::vec3(COLOR_EPSILON)));
+            if (match) {
+                if (!target) target = &obj.vertices.edit();
+                (*target)[i].color = to;
+                changed++;
+                if (!inRun) runStart = i;
+            } else if (inRun) {
+                obj.markDirty(runStart, i - runStart);
+            }
+            inRun = match;
+        }
+        if (changed == 0) return 0;
+        if (!wasPending) queue(obj);
+        editAppearance(obj).recolors.push_back({from, to});
+        track(obj);
+        edits++;
+        return changed;
+    }
+    
+    // Ganti mesh dengan prototype lain dari file scene. VBO dipakai ulang
+    // selama muat; cahaya baked mesh lama dibuang (dihitung realtime),
+    // begitu juga AO baked. Vertex dipakai bersama prototype.
+    void replaceMesh(Object3D& obj, int32_t meshIndex) {
+        const Object3D& mesh = scene->prototypes[meshIndex];
+        Appearance& appearance = editAppearance(obj);
+        appearance.mesh = meshIndex;
+        appearance.recolors.clear();
+        bool wasPending = !obj.dirtyRanges.empty();
+        obj.vertices = mesh.vertices;
+        obj.drawRanges = mesh.drawRanges;
+        obj.detailParts = mesh.detailParts;
+        obj.setLocalBounds(mesh.getLocalBounds());
+        obj.dirtyRanges.clear();
+        obj.markDirty(0, obj.vertices.size());
+        obj.resetBakedAO();
+        if (obj.bakedVBO) obj.resetBakedLight(lightOn ? 1 : 0);
+        obj.bvh = mesh.bvh;   // BVH prototype dipakai bersama
+        refresh(obj);
+        if (!wasPending) queue(obj);
+    }
+    
+    // Salin objek ke posisi baru. VBO baru memang harus diisi penuh, tetapi
+    // objek lain tidak disentuh. Jika vector objek harus tumbuh (pointer
+    // lama tidak valid), struktur CPU dibangun ulang; GPU tetap utuh.
+    Object3D& addInstance(const Object3D& source, const glm::vec3& position, const glm::vec3& rotation) {
+        // Salin dulu: source bisa berada di vector yang akan tumbuh
+        size_t sourceIndex = &source - objects->data();
+        Appearance appearance = sourceIndex < objects->size() ? appearanceOf(sourceIndex) : Appearance();
+        Object3D copy;
+        copy.vertices = source.vertices;
+        copy.bakedAO = source.bakedAO;
+        copy.drawRanges = source.drawRanges;
+        copy.detailParts = source.detailParts;
+        copy.setLocalBounds(source.getLocalBounds());
+        copy.bvh = source.bvh;
+        copy.name = source.name;
+        copy.scale = source.scale;
+        copy.collider = source.collider;
+        copy.isDynamic = source.isDynamic;
+        copy.castsShadow = source.castsShadow;
+        copy.position = position;
+        copy.rotation = rotation;
+        bool baked = source.bakedVBO != 0;
+        bool grows = objects->size() == objects->capacity();
+        objects->push_back(std::move(copy));
+        Object3D& obj = objects->back();
+        appearances[(uint32_t)(objects->size() - 1)] = std::move(appearance);
+        
+        obj.setup();
+        obj.setupBakedAO();
+        if (baked) obj.resetBakedLight(lightOn ? 1 : 0);
+        size_t bytes = obj.vertices.size() * sizeof(Vertex) + obj.bakedAO.size() * sizeof(float);
+        uploadedBytes += bytes;
+        bufferBytes += bytes;
+        
+        if (grows) {
+            rebuildStructures();
+        } else {
+            index->addObject(obj);
+            collision->updateObject(obj, obj.collider);
+            pick->updateObject(obj);
+        }
+        track(obj);
+        if (obj.castsShadow) shadowsChanged = true;
+        edits++;
+        return obj;
+    }
+    
+    // Objek dikosongkan di tempat (indeks objek lain tetap berlaku)
+    void remove(Object3D& obj) {
+        index->removeObject(obj);
+        collision->removeObject(obj);
+        pick->removeObject(obj);
+        obj.cleanup();
+        obj.dirtyRanges.clear();
+        obj.vertices.clear();
+        obj.drawRanges.clear();
+        obj.detailParts.clear();
+        obj.bvh.reset();
+        track(obj);
+        if (obj.castsShadow) shadowsChanged = true;
+        edits++;
+    }
+    
+    // Sekali per frame sebelum menggambar: kirim rentang kotor semua VBO
+    // yang diedit sejak frame sebelumnya. Return byte yang dikirim.
+    size_t flush() {
+        size_t bytes = 0;
+        for (size_t i : pending) {
+            Object3D& obj = (*objects)[i];
+            if (!obj.VBO) continue;   // Dihapus setelah diedit
+            bufferBytes += obj.vertices.size() * sizeof(Vertex);
+            bytes += obj.flushDirty();
+        }
+        pending.clear();
+        if (bytes > 0) {
+            uploadedBytes += bytes;
+            flushes++;
+        }
+        return bytes;
+    }
+    
+private:
+    static constexpr float COLOR_EPSILON = 0.002f;
+    
+    std::vector<Object3D>* objects = nullptr;
+    SceneIndex* index = nullptr;
+    CollisionWorld* collision = nullptr;
+    PickScene* pick = nullptr;
+    const SceneDescription* scene = nullptr;
+    std::vector<size_t> pending;   // Indeks objek dengan rentang kotor (bukan pointer: vector bisa tumbuh)
+    std::vector<uint32_t> changed;
+    std::vector<uint8_t> changedFlags;
+    std::unordered_map<uint32_t, Appearance> appearances;   // Hanya objek yang tampilannya diedit
+    
+    Appearance& editAppearance(Object3D& obj) {
+        size_t i = &obj - objects->data();
+        auto it = appearances.find((uint32_t)i);
+        if (it == appearances.end()) it = appearances.emplace((uint32_t)i, loadedAppearance(i)).first;
+        return it->second;
+    }
+    
+    void queue(Object3D& obj) {
+        pending.push_back(&obj - objects->data());
+    }
+    
+    void track(Object3D& obj) {
+        size_t i = &obj - objects->data();
+        if (i >= changedFlags.size()) changedFlags.resize(objects->size(), 0);
+        if (changedFlags[i]) return;
+        changedFlags[i] = 1;
+        changed.push_back((uint32_t)i);
+    }
+    
+    // Bounds/transformasi berubah: perbarui semua struktur pencarian
+    void refresh(Object3D& obj) {
+        index->updateObject(obj);
+        collision->updateObject(obj, obj.collider);
+        pick->updateObject(obj);
+        track(obj);
+        if (obj.castsShadow) shadowsChanged = true;
+        edits++;
+    }
+    
+    void rebuildStructures() {
+        index->build(*objects);
+        collision->clear();
+        pick->clear();
+        for (auto& obj : *objects) {
+            if (obj.vertices.empty()) continue;
+            collision->addObject(obj, obj.collider);
+            pick->addObject(obj);
+        }
+        collision->build();
+        pick->build();
+    }
+};
+
+// =====================================================================
+// SNAPSHOT STATE SCENE (SIMPAN/PULIHKAN BINARY)
+// =====================================================================
+// State runtime (kamera, toggle lampu/kabut/kolisi, transformasi dan
+// tampilan objek) ditulis sebagai satu header + rekaman ukuran tetap +
+// daftar ganti warna. Objek yang tidak pernah disentuh SceneEditor masih
+// persis seperti hasil load, sehingga hanya objek di
+// SceneEditor::changedObjects() yang direkam. Simpan dan pulihkan
+// sebanding jumlah objek yang diedit, bukan ukuran scene: tetap orde
+// mikrodetik walau scene berisi 100 ribu objek. Pulihkan memakai mmap;
+// objek yang berbeda diteruskan ke SceneEditor (move/remove/ganti mesh),
+// objek yang diedit setelah snapshot dikembalikan ke state hasil load.
+//
+// Mesh dan warna tidak disimpan sebagai vertex: rekaman memuat indeks
+// prototype mesh dan urutan ganti warna (SceneEditor::Appearance), lalu
+// vertex dibuat ulang dari prototype. Objek yang tampilannya dipulihkan
+// kehilangan AO dan cahaya baked (dihitung realtime, sama seperti edit
+// ganti mesh). Snapshot terikat ke scene: sidik jari dari jumlah objek
+// hasil load, jumlah vertex masing-masing, dan jumlah prototype. Objek
+// duplikat yang sudah dihapus tidak bisa dibuat ulang.
+const uint32_t SNAPSHOT_VERSION = 2;
+std::string snapshotPath = "cache/snapshot.bin";   // --snapshot (F5/F9)
+
+// Permintaan snapshot dari keyboard (diproses render loop)
+enum SnapshotAction { SNAPSHOT_NONE, SNAPSHOT_SAVE, SNAPSHOT_RESTORE };
+SnapshotAction snapshotRequested = SNAPSHOT_NONE;
+
+class SceneSnapshot {
+public:
+    // Statistik operasi terakhir (untuk log dan --bench-snapshot)
+    double lastMicros = 0.0;
+    size_t lastBytes = 0;
+    int lastMoved = 0;
+    int lastRestyled = 0;  // Objek yang mesh/warnanya dibuat ulang
+    int lastRemoved = 0;
+    int lastMissing = 0;   // Objek di snapshot yang tidak ada lagi di scene
+    
+    // Dipanggil saat scene lengkap: sidik jari dan transformasi hasil load
+    void attach(std::vector<Object3D>& sceneObjects, SceneEditor& sceneEditor) {
+        objects = &sceneObjects;
+        editor = &sceneEditor;
+        SceneHasher hash;
+        uint32_t count = (uint32_t)sceneObjects.size();
+        hash.mix(&count, sizeof(count));
+        uint32_t prototypeCount = (uint32_t)sceneEditor.prototypeCount();
+        hash.mix(&prototypeCount, sizeof(prototypeCount));
+        loaded.resize(sceneObjects.size());
+        for (size_t i = 0; i < sceneObjects.size(); i++) {
+            const Object3D& obj = sceneObjects[i];
+            uint64_t vertexCount = obj.vertices.size();
+            hash.mix(&vertexCount, sizeof(vertexCount));
+            loaded[i] = stateOf(obj, (uint32_t)i);
+        }
+        sceneKey = hash.value;
+    }
+    
+    bool isAttached() const { return objects != nullptr; }
+    
+    bool save(const std::string& path) {
+        double start = monotonicTime();
+        Header header = {};
+        std::memcpy(header.magic, "SNAP", 4);
+        header.version = SNAPSHOT_VERSION;
+        header.recordSize = sizeof(ObjectState);
+        header.loadedCount = (uint32_t)loaded.size();
+        header.sceneKey = sceneKey;
+        header.flags = (lightOn ? FLAG_LIGHT_ON : 0) | (fogEnabled ? FLAG_FOG : 0) |
+                       (collisionEnabled ? FLAG_COLLISION : 0);
+        header.cameraPos = cameraPos;
+        header.yaw = yaw;
+        header.pitch = pitch;
+        header.fov = fov;
+        
+        // Rekaman urut indeks (dicari dengan binary search saat pulihkan),
+        // ganti warna setiap rekaman berurutan di recolors
+        std::vector<uint32_t> changed = editor->changedObjects();
+        std::sort(changed.begin(), changed.end());
+        records.clear();
+        recolors.clear();
+        for (uint32_t i : changed) {
+            ObjectState state = stateOf((*objects)[i], i);
+            SceneEditor::Appearance appearance = editor->appearanceOf(i);
+            state.mesh = appearance.mesh;
+            state.recolorFirst = (uint32_t)recolors.size();
+            state.recolorCount = (uint32_t)appearance.recolors.size();
+            recolors.insert(recolors.end(), appearance.recolors.begin(), appearance.recolors.end());
+            records.push_back(state);
+        }
+        header.recordCount = (uint32_t)records.size();
+        header.recolorCount = (uint32_t)recolors.size();
+        
+        // File sementara lalu rename: snapshot lama tetap utuh jika gagal.
+        // restore() melepas mapping-nya sebelum kembali, jadi file lama tidak
+        // pernah masih ter-map saat diganti (syarat rename di Windows).
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+        std::string tempPath = path + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary);
+            out.write((const char*)&header, sizeof(header));
+            out.write((const char*)records.data(), records.size() * sizeof(ObjectState));
+            out.write((const char*)recolors.data(), recolors.size() * sizeof(SceneEditor::Recolor));
+            if (!out) {
+                std::cerr << "ERROR: Cannot write snapshot: " << tempPath << std::endl;
+                return false;
+            }
+        }
+        std::filesystem::rename(tempPath, path, error);
+        if (error) {
+            std::cerr << "ERROR: Cannot write snapshot: " << path << std::endl;
+            std::filesystem::remove(tempPath, error);
+            return false;
+        }
+        lastBytes = sizeof(header) + records.size() * sizeof(ObjectState) +
+                    recolors.size() * sizeof(SceneEditor::Recolor);
+        lastMicros = (monotonicTime() - start) * 1e6;
+        return true;
+    }
+    
+    // Kamera dan toggle langsung diganti; objek hanya disentuh jika berbeda
+    bool restore(const std::string& path) {
+        double start = monotonicTime();
+        MappedFile file;
+        if (!file.open(path)) {
+            std::cerr << "ERROR: Cannot open snapshot: " << path << std::endl;
+            return false;
+        }
+        std::string_view data = file.view();
+        const Header* header = (const Header*)data.data();
+        if (data.size() < sizeof(Header) || std::memcmp(header->magic, "SNAP", 4) != 0 ||
+            header->version != SNAPSHOT_VERSION || header->recordSize != sizeof(ObjectState) ||
+            sizeof(Header) + (uint64_t)header->recordCount * sizeof(ObjectState) +
+            (uint64_t)header->recolorCount * sizeof(SceneEditor::Recolor) > data.size()) {
+            std::cerr << "ERROR: Invalid snapshot file: " << path << std::endl;
+            return false;
+        }
+        if (header->loadedCount != loaded.size() || header->sceneKey != sceneKey) {
+            std::cerr << "ERROR: Snapshot belongs to a different scene: " << path << std::endl;
+            return false;
+        }
+        const ObjectState* saved = (const ObjectState*)(data.data() + sizeof(Header));
+        const ObjectState* savedEnd = saved + header->recordCount;
+        const SceneEditor::Recolor* savedRecolors = (const SceneEditor::Recolor*)savedEnd;
+        for (const ObjectState* r = saved; r < savedEnd; r++) {
+            if ((r + 1 < savedEnd && r[0].index >= r[1].index) ||
+                (uint64_t)r->recolorFirst + r->recolorCount > header->recolorCount) {
+                std::cerr << "ERROR: Invalid snapshot file: " << path << std::endl;
+                return false;
+            }
+        }
+        
+        cameraPos = header->cameraPos;
+        yaw = header->yaw;
+        pitch = header->pitch;
+        fov = header->fov;
+        glm::vec3 front;
+        front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+        front.y = sin(glm::radians(pitch));
+        front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+        cameraFront = glm::normalize(front);
+        firstMouse = true;   // Gerakan mouse berikutnya tidak melompat
+        lightOn = (header->flags & FLAG_LIGHT_ON) != 0;
+        fogEnabled = (header->flags & FLAG_FOG) != 0;
+        collisionEnabled = (header->flags & FLAG_COLLISION) != 0;
+        
+        // Objek yang direkam snapshot ditambah objek yang diedit sejak
+        // attach; sisanya sudah sama dengan hasil load di kedua sisi
+        indices.assign(editor->changedObjects().begin(), editor->changedObjects().end());
+        for (const ObjectState* r = saved; r < savedEnd; r++) indices.push_back(r->index);
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        
+        lastMoved = lastRestyled = lastRemoved = lastMissing = 0;
+        for (uint32_t i : indices) {
+            const ObjectState* target = std::lower_bound(saved, savedEnd, i,
+                [](const ObjectState& r, uint32_t index) { return r.index < index; });
+            SceneEditor::Appearance appearance;
+            if (target != savedEnd && target->index == i) {
+                appearance.mesh = target->mesh;
+                appearance.recolors.assign(savedRecolors + target->recolorFirst,
+                                           savedRecolors + target->recolorFirst + target->recolorCount);
+            } else {
+                // Tidak direkam: state hasil load (objek baru tidak ada)
+                target = i < loaded.size() ? &loaded[i] : nullptr;
+                appearance = editor->loadedAppearance(i);
+            }
+            bool wanted = target && target->present;
+            if (i >= objects->size()) {
+                if (wanted) lastMissing++;
+                continue;
+            }
+            Object3D& obj = (*objects)[i];
+            bool present = !obj.vertices.empty();
+            if (!wanted) {
+                if (present) {
+                    editor->remove(obj);
+                    lastRemoved++;
+                }
+            } else if (!present) {
+                lastMissing++;
+            } else {
+                if (!(editor->appearanceOf(i) == appearance)) {
+                    if (editor->applyAppearance(obj, appearance)) lastRestyled++;
+                    else lastMissing++;
+                }
+                if (obj.position != target->position || obj.rotation != target->rotation ||
+                    obj.scale != target->scale) {
+                    editor->move(obj, target->position, target->rotation, target->scale);
+                    lastMoved++;
+                }
+            }
+        }
+        lastBytes = data.size();
+        lastMicros = (monotonicTime() - start) * 1e6;
+        return true;
+    }
+    
+private:
+    static constexpr uint32_t FLAG_LIGHT_ON = 1;
+    static constexpr uint32_t FLAG_FOG = 2;
+    static constexpr uint32_t FLAG_COLLISION = 4;
+    
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t recordSize;    // Ukuran rekaman harus sama dengan build ini
+        uint32_t recordCount;
+        uint32_t recolorCount;  // SceneEditor::Recolor setelah rekaman
+        uint32_t loadedCount;   // Objek hasil load scene
+        uint32_t flags;
+        uint64_t sceneKey;
+        glm::vec3 cameraPos;
+        float yaw;
+        float pitch;
+        float fov;
+    };
+    struct ObjectState {
+        uint32_t index;
+        uint32_t present;       // 0 = objek dihapus
+        glm::vec3 position;
+        glm::vec3 rotation;
+        glm::vec3 scale;
+        int32_t mesh;           // SceneEditor::Appearance
+        uint32_t recolorFirst;
+        uint32_t recolorCount;
+    };
+    
+    std::vector<Object3D>* objects = nullptr;
+    SceneEditor* editor = nullptr;
+    uint64_t sceneKey = 0;
+    std::vector<ObjectState> loaded;    // Per objek hasil load
+    std::vector<ObjectState> records;   // Dipakai ulang antar save
+    std::vector<SceneEditor::Recolor> recolors;
+    std::vector<uint32_t> indices;      // Dipakai ulang antar restore
+    
+    static ObjectState stateOf(const Object3D& obj, uint32_t index) {
+        return {index, obj.vertices.empty() ? 0u : 1u, obj.position, obj.rotation, obj.scale, -1, 0, 0};
+    }
+};
+
+// =====================================================================
+// BENCHMARK (dijalankan dari command line, tanpa window)
+// =====================================================================
+// Scene uji benchmark struktur scene (kolisi, picking, octree, snapshot,
+// lampu): gedung kantor dari BuildingGenerator dengan seed tetap, dimuat
+// lewat SceneDescription seperti file scene (jalur yang sama dengan app,
+// termasuk BVH segitiga per prototype).
+const uint64_t BENCHMARK_BUILDING_SEED = 2024;
+
+void loadBenchmarkBuilding(SceneDescription& scene, int roomsX, int roomsZ, int floors) {
+    std::ostringstream text;
+    text << "building rooms=" << roomsX << "," << roomsZ << " floors=" << floors
+         << " seed=" << BENCHMARK_BUILDING_SEED << "\n";
+    scene.parse(text.str(), "benchmark");
+}
+
+// Mengukur waktu satu langkah kolisi kamera di gedung kantor 20 x 20
+// ruangan (ribuan perabot) untuk memastikan tetap jauh di bawah 0.1 ms.
+int runCollisionBenchmark() {
+    const int roomsX = 20, roomsZ = 20;
+    SceneDescription scene;
+    loadBenchmarkBuilding(scene, roomsX, roomsZ, 1);
+    std::vector<Object3D> objects = scene.instantiate();
+    const glm::vec3 cell = BuildingLayout().cellSize;
+    
+    CollisionWorld world;
+    int furniture = 0;
+    double t0 = monotonicTime();
+    for (const auto& obj : objects) {
+        world.addObject(obj, obj.collider);
+        if (obj.collider == COLLIDE_BOX) furniture++;
+    }
+    world.build();
+    double buildMs = (monotonicTime() - t0) * 1000.0;
+    
+    // Jalan acak deterministik setinggi mata duduk di lantai dasar
+    // (menabrak perabot dan dinding, lewat pintu antar ruangan)
+    const int stepCount = 200000;
+    const glm::vec3 low(-0.5f * cell.x + 0.5f, 1.0f, -0.5f * cell.z + 0.5f);
+    const glm::vec3 high((roomsX - 0.5f) * cell.x - 0.5f, 1.0f, (roomsZ - 0.5f) * cell.z - 0.5f);
+    glm::vec3 pos(1.5f, 1.0f, 1.5f);
+    unsigned int rng = 12345u;
+    long long totalCandidates = 0;
+    t0 = monotonicTime();
+    for (int s = 0; s < stepCount; s++) {
+        rng = rng * 1664525u + 1013904223u;
+        float angle = (rng >> 8) * (6.2831853f / 16777216.0f);
+        glm::vec3 target = pos + glm::vec3(std::cos(angle), 0.0f, std::sin(angle)) * 0.05f;
+        target = glm::clamp(target, low, high);
+        pos = world.moveCapsule(pos, target);
+        totalCandidates += world.lastCandidateCount;
+    }
+    double stepUs = (monotonicTime() - t0) * 1e6 / stepCount;
+    
+    std::cout << "BENCHMARK KOLISI KAMERA (" << scene.rooms << " ruangan, seed "
+              << BENCHMARK_BUILDING_SEED << ")" << std::endl;
+    std::cout << "  Perabot        : " << furniture << std::endl;
+    std::cout << "  Collider       : " << world.colliderCount() << std::endl;
+    std::cout << "  Cell grid      : " << world.cellCount() << std::endl;
+    std::cout << "  Waktu build    : " << buildMs << " ms" << std::endl;
+    std::cout << "  Waktu per step : " << stepUs << " us" << std::endl;
+    std::cout << "  Kandidat/step  : " << (double)totalCandidates / stepCount << std::endl;
+    return 0;
+}
+
+// Mengukur throughput picking (ray/detik) pada satu ruangan dan pada
+// gedung 10 x 10 ruangan x 10 lantai (1000 ruangan, mesh dipakai bersama).
+double measurePickRate(const PickScene& scene, glm::vec3 roomSize, glm::ivec3 rooms,
+                       glm::vec3 spacing, int rayCount, double& hitRate) {
+    unsigned int rng = 987654321u;
+    auto nextFloat = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return (rng >> 8) * (1.0f / 16777216.0f);
+    };
+    
+    std::vector<Ray> rays(rayCount);
+    for (auto& ray : rays) {
+        glm::ivec3 room((int)(nextFloat() * rooms.x), (int)(nextFloat() * rooms.y),
+                        (int)(nextFloat() * rooms.z));
+        room = glm::min(room, rooms - 1);
+        glm::vec3 local((nextFloat() - 0.5f) * (roomSize.x - 1.0f),
+                        0.3f + nextFloat() * (roomSize.y - 0.6f),
+                        (nextFloat() - 0.5f) * (roomSize.z - 1.0f));
+        ray.origin = glm::vec3(room) * spacing + local;
+        
+        float z = nextFloat() * 2.0f - 1.0f;
+        float a = nextFloat() * 6.2831853f;
+        float r = std::sqrt(1.0f - z * z);
+        ray.direction = glm::vec3(r * std::cos(a), z, r * std::sin(a));
+    }
+    
+    int hits = 0;
+    double t0 = monotonicTime();
+    for (const auto& ray : rays) {
+        PickHit hit;
+        if (scene.raycast(ray, hit)) hits++;
+    }
+    double seconds = monotonicTime() - t0;
+    hitRate = (double)hits / rayCount;
+    return rayCount / seconds;
+}
+
+int runPickBenchmark() {
+    glm::vec3 roomSize;
+    std::vector<Object3D> objects = loadSceneObjects(false, &roomSize);
+    const int rayCount = 1000000;
+    double hitRate;
+    
+    // Satu ruangan
+    double t0 = monotonicTime();
+    PickScene room;
+    for (auto& obj : objects) room.addObject(obj);
+    room.build();
+    double roomBuildMs = (monotonicTime() - t0) * 1000.0;
+    double roomRate = measurePickRate(room, roomSize, glm::ivec3(1), roomSize, rayCount, hitRate);
+    double roomHit = hitRate;
+    
+    // 1000 ruangan: instance gedung berbagi mesh (dan BVH mesh) prototype
+    const glm::ivec3 grid(10, 10, 10);
+    const glm::vec3 cell = BuildingLayout().cellSize;
+    SceneDescription scene;
+    loadBenchmarkBuilding(scene, grid.x, grid.z, grid.y);
+    std::vector<Object3D> buildingObjects = scene.instantiate();
+    t0 = monotonicTime();
+    PickScene building;
+    for (auto& obj : buildingObjects) building.addInstance(&obj, obj.getModelMatrix());
+    building.build();
+    double buildingBuildMs = (monotonicTime() - t0) * 1000.0;
+    double buildingRate = measurePickRate(building, cell, grid, cell, rayCount, hitRate);
+    
+    std::cout << "BENCHMARK PICKING (RAY-CAST)" << std::endl;
+    std::cout << "  1 ruangan    : " << room.instanceCount() << " instance, build "
+              << roomBuildMs << " ms, " << roomRate / 1e6 << " juta ray/detik (hit "
+              << roomHit * 100.0 << "%)" << std::endl;
+    std::cout << "  " << scene.rooms << " ruangan : " << building.instanceCount() << " instance, build "
+              << buildingBuildMs << " ms, " << buildingRate / 1e6 << " juta ray/detik (hit "
+              << hitRate * 100.0 << "%)" << std::endl;
+    return 0;
+}
+
+// Mengukur update inkremental loose octree untuk semua kursi (objek
+// dinamis) gedung 64 x 64 ruangan yang bergerak, dibandingkan dengan
+// membangun ulang BVH setiap frame.
+int runOctreeBenchmark() {
+    const int roomsX = 64, roomsZ = 64;
+    SceneDescription scene;
+    loadBenchmarkBuilding(scene, roomsX, roomsZ, 1);
+    std::vector<Object3D> objects = scene.instantiate();
+    const glm::vec3 cell = BuildingLayout().cellSize;
+    const glm::vec3 center((roomsX - 1) * 0.5f * cell.x, 0.0f, (roomsZ - 1) * 0.5f * cell.z);
+    const int frames = 200;
+    
+    std::vector<Object3D*> chairs;
+    for (auto& obj : objects) {
+        if (obj.isDynamic) chairs.push_back(&obj);
+    }
+    const int chairCount = (int)chairs.size();
+    unsigned int rng = 24680u;
+    auto nextFloat = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return (rng >> 8) * (1.0f / 16777216.0f);
+    };
+    
+    SceneIndex index;
+    index.build(objects);
+    
+    // Setiap frame kursi bergeser sedikit (kecepatan jalan) dan berputar
+    double updateSeconds = 0.0, rebuildSeconds = 0.0;
+    std::vector<AABB> bounds(chairCount), chairBounds(chairCount);
+    for (int i = 0; i < chairCount; i++) chairBounds[i] = chairs[i]->getLocalBounds();
+    BVH rebuilt;
+    for (int f = 0; f < frames; f++) {
+        for (Object3D* c : chairs) {
+            c->position += glm::vec3(nextFloat() - 0.5f, 0.0f, nextFloat() - 0.5f) * 0.05f;
+            c->rotation.y += 1.0f;
+        }
+        double t0 = monotonicTime();
+        index.updateDynamic();
+        updateSeconds += monotonicTime() - t0;
+        
+        t0 = monotonicTime();
+        for (int i = 0; i < chairCount; i++) bounds[i] = chairBounds[i].transformed(chairs[i]->getModelMatrix());
+        rebuilt.build(bounds, 2);
+        rebuildSeconds += monotonicTime() - t0;
+    }
+    
+    // Query frustum dari tengah gedung, radius, dan AABB
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    glm::vec3 eye = center + glm::vec3(0.0f, 1.7f, 0.0f);
+    glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum;
+    frustum.extract(projection * view);
+    std::vector<Object3D*> result;
+    index.queryFrustum(frustum, result);
+    CullStats frustumStats = index.lastStats;
+    
+    CullStats radiusStats;
+    std::vector<Object3D*> radiusResult;
+    index.dynamicTree.queryRadius(center, 10.0f, radiusResult, radiusStats);
+    
+    CullStats boxStats;
+    std::vector<Object3D*> boxResult;
+    index.dynamicTree.queryAABB(AABB(glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(50.0f, 2.0f, 50.0f)),
+                                boxResult, boxStats);
+    
+    std::cout << "BENCHMARK LOOSE OCTREE (OBJEK DINAMIS, " << scene.rooms << " ruangan, "
+              << objects.size() << " objek)" << std::endl;
+    std::cout << "  Kursi bergerak     : " << chairCount << ", " << frames << " frame" << std::endl;
+    std::cout << "  Node octree        : " << index.dynamicTree.nodeCount() << std::endl;
+    std::cout << "  Update inkremental : " << updateSeconds * 1000.0 / frames << " ms/frame" << std::endl;
+    std::cout << "  Rebuild BVH        : " << rebuildSeconds * 1000.0 / frames << " ms/frame" << std::endl;
+    std::cout << "  Pindah di tempat   : " << index.dynamicTree.movesInPlace
+              << ", reinsert: " << index.dynamicTree.reinsertions << std::endl;
+    std::cout << "  Query frustum      : " << result.size() << " terlihat, node dikunjungi "
+              << frustumStats.nodesVisited << ", dibuang " << frustumStats.nodesCulled
+              << ", diterima utuh " << frustumStats.nodesFullyInside
+              << ", objek dites " << frustumStats.objectsTested << std::endl;
+    std::cout << "  Query radius 10 m  : " << radiusResult.size() << " objek, node dibuang "
+              << radiusStats.nodesCulled << std::endl;
+    std::cout << "  Query AABB 50x50 m : " << boxResult.size() << " objek, node dibuang "
+              << boxStats.nodesCulled << std::endl;
+    return 0;
+}
+
+// Simpan/pulihkan snapshot gedung 44 x 44 ruangan x 2 lantai (~100 ribu
+// objek) setelah 0.1% objek dipindah (lewat SceneEditor) dan sebagian di
+// antaranya diwarnai ulang atau diganti mesh prototype lain: simpan,
+// pulihkan tanpa perubahan, lalu pulihkan setelah objek yang sama digeser
+// dan diganti mesh lagi. Waktu pulihkan termasuk update SceneEditor (dan
+// rebuild BVH/grid yang tertunda).
+int runSnapshotBenchmark() {
+    SceneDescription scene;
+    loadBenchmarkBuilding(scene, 44, 44, 2);
+    std::vector<Object3D> objects = scene.instantiate();
+    const int objectCount = (int)objects.size();
+    const int prototypeCount = (int)scene.prototypes.size();
+    const int movedCount = objectCount / 1000;
+    
+    SceneIndex index;
+    index.build(objects);
+    CollisionWorld collision;
+    PickScene pick;
+    for (auto& obj : objects) {
+        collision.addObject(obj, obj.collider);
+        pick.addObject(obj);
+    }
+    collision.build();
+    pick.build();
+    SceneEditor editor;
+    editor.attach(objects, index, collision, pick, scene);
+    SceneSnapshot snapshot;
+    snapshot.attach(objects, editor);
+    
+    // Setiap objek ke-4 juga diwarnai ulang, setiap objek ke-8 diganti mesh
+    LayoutRandom random{BENCHMARK_BUILDING_SEED};
+    std::vector<Object3D*> edited;
+    for (int i = 0; i < movedCount; i++) {
+        Object3D& obj = objects[random.pick(objectCount)];
+        editor.move(obj, obj.position + glm::vec3(1.0f, 0.0f, 0.0f), obj.rotation, obj.scale);
+        if (i % 4 == 0 && !obj.vertices.empty())
+            editor.recolor(obj, obj.vertices[0].color, glm::vec3(0.8f, 0.2f, 0.2f));
+        if (i % 8 == 0) editor.replaceMesh(obj, random.pick(prototypeCount));
+        edited.push_back(&obj);
+    }
+    
+    const std::string path = "cache/snapshot_bench.bin";
+    if (!snapshot.save(path)) return 1;
+    double saveUs = snapshot.lastMicros;
+    size_t bytes = snapshot.lastBytes;
+    
+    snapshot.restore(path);
+    double unchangedUs = snapshot.lastMicros;
+    
+    double t0 = monotonicTime();
+    for (size_t i = 0; i < edited.size(); i++) {
+        Object3D* obj = edited[i];
+        editor.move(*obj, obj->position + glm::vec3(0.0f, 0.0f, 1.0f), obj->rotation, obj->scale);
+        if (i % 4 == 0) editor.replaceMesh(*obj, random.pick(prototypeCount));
+    }
+    double editUs = (monotonicTime() - t0) * 1e6;
+    snapshot.restore(path);
+    double movedUs = snapshot.lastMicros;
+    int restored = snapshot.lastMoved;
+    int restyled = snapshot.lastRestyled;
+    
+    std::cout << "BENCHMARK SNAPSHOT STATE (" << scene.rooms << " ruangan, seed "
+              << BENCHMARK_BUILDING_SEED << ")" << std::endl;
+    std::cout << "  Objek               : " << objectCount << ", " << editor.changedObjects().size()
+              << " diedit (" << bytes << " byte)" << std::endl;
+    std::cout << "  Simpan              : " << saveUs << " us" << std::endl;
+    std::cout << "  Pulihkan (sama)     : " << unchangedUs << " us" << std::endl;
+    std::cout << "  Pulihkan (digeser)  : " << movedUs << " us (" << restored
+              << " objek dikembalikan, " << restyled << " mesh/warna dibuat ulang lewat SceneEditor)" << std::endl;
+    std::cout << "  Pembanding: geser " << edited.size() << " objek yang sama (dan ganti mesh "
+              << (edited.size() + 3) / 4 << ") lewat SceneEditor: " << editUs << " us" << std::endl;
+    return 0;
+}
+
+// Mengukur build cluster lampu di CPU pada gedung 4 lantai dengan satu
+// lampu per ruangan: jumlah ruangan bertambah seiring jumlah lampu,
+// sehingga lampu per cluster (biaya fragment shader) seharusnya tetap sama.
+int runLightBenchmark() {
+    const int lightCounts[] = {256, 1024, 4096, 16384};
+    const int floors = 4;
+    const int frames = 50;
+    const glm::vec3 cell = BuildingLayout().cellSize;
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    
+    ThreadPool singleThread(1);
+    ThreadPool& pool = workerPool();
+    
+    std::cout << "BENCHMARK CLUSTERED LIGHTING (" << LightClusters::GRID_X << "x"
+              << LightClusters::GRID_Y << "x" << LightClusters::GRID_Z << " cluster, "
+              << pool.size() << " thread)" << std::endl;
+    for (int lightCount : lightCounts) {
+        int side = (int)std::lround(std::sqrt((double)lightCount / floors));
+        SceneDescription scene;
+        loadBenchmarkBuilding(scene, side, side, floors);
+        const std::vector<PointLight>& lights = scene.lights;
+        
+        // Kamera di tengah lantai kedua, menghadap sepanjang lantai
+        glm::vec3 eye((side - 1) * 0.5f * cell.x, cell.y + 1.7f, (side - 1) * 0.5f * cell.z);
+        glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(0.0f, -0.1f, -1.0f),
+                                     glm::vec3(0.0f, 1.0f, 0.0f));
+        
+        LightClusters clusters;
+        double t0 = monotonicTime();
+        for (int f = 0; f < frames; f++) clusters.build(lights, view, projection, singleThread);
+        double singleMs = (monotonicTime() - t0) * 1000.0 / frames;
+        t0 = monotonicTime();
+        for (int f = 0; f < frames; f++) clusters.build(lights, view, projection, pool);
+        double pooledMs = (monotonicTime() - t0) * 1000.0 / frames;
+        
+        float average = clusters.activeClusters > 0
+            ? (float)clusters.references / clusters.activeClusters : 0.0f;
+        std::cout << "  " << lights.size() << " lampu (" << side << "x" << side << " ruangan x "
+                  << floors << " lantai): " << clusters.visibleLights << " di frustum, rata-rata "
+                  << average << " lampu/cluster (maks " << clusters.maxPerCluster
+                  << "), build " << singleMs << " ms (1 thread) / " << pooledMs
+                  << " ms (" << pool.size() << " thread)" << std::endl;
+    }
+    return 0;
+}
+
+// Mengukur bake cahaya per vertex ruangan (tanpa cache), satu thread
+// dibandingkan semua thread pool.
+int runBakeBenchmark() {
+    std::vector<Object3D> objects = loadSceneObjects(true);
+    
+    ThreadPool singleThread(1);
+    ThreadPool& pool = workerPool();
+    VertexLightBaker baker;
+    
+    double t0 = monotonicTime();
+    baker.bakeAll(objects, lightPos, singleThread);
+    double singleSeconds = monotonicTime() - t0;
+    t0 = monotonicTime();
+    baker.bakeAll(objects, lightPos, pool);
+    double pooledSeconds = monotonicTime() - t0;
+    
+    std::cout << "BENCHMARK BAKE CAHAYA PER VERTEX" << std::endl;
+    std::cout << "  Vertex statis : " << baker.bakedVertices << " (" << baker.indirectSamples
+              << " sampel indirect/vertex)" << std::endl;
+    std::cout << "  Ray           : " << baker.raysCast << std::endl;
+    std::cout << "  1 thread      : " << singleSeconds * 1000.0 << " ms ("
+              << baker.raysCast / singleSeconds / 1e6 << " juta ray/detik)" << std::endl;
+    std::cout << "  " << pool.size() << " thread      : " << pooledSeconds * 1000.0 << " ms ("
+              << baker.raysCast / pooledSeconds / 1e6 << " juta ray/detik)" << std::endl;
+    return 0;
+}
+
+int runAOBenchmark() {
+    std::vector<Object3D> objects = loadSceneObjects(true);
+    
+    ThreadPool singleThread(1);
+    ThreadPool& pool = workerPool();
+    AmbientOcclusionBaker baker;
+    
+    double t0 = monotonicTime();
+    baker.bakeAll(objects, singleThread);
+    double singleSeconds = monotonicTime() - t0;
+    t0 = monotonicTime();
+    baker.bakeAll(objects, pool);
+    double pooledSeconds = monotonicTime() - t0;
+    
+    std::cout << "BENCHMARK BAKE AMBIENT OCCLUSION" << std::endl;
+#ifdef ROOM_SIMD_SSE
+    std::cout << "  Uji ray/box   : SSE (paket 4 ray)" << std::endl;
+#else
+    std::cout << "  Uji ray/box   : skalar (paket 4 ray)" << std::endl;
+#endif
+    std::cout << "  Vertex statis : " << baker.bakedVertices << " (" << baker.samples
+              << " sampel/vertex, radius " << baker.aoRadius << " m)" << std::endl;
+    std::cout << "  Ray           : " << baker.raysCast << std::endl;
+    std::cout << "  1 thread      : " << singleSeconds * 1000.0 << " ms ("
+              << baker.raysCast / singleSeconds / 1e6 << " juta ray/detik)" << std::endl;
+    std::cout << "  " << pool.size() << " thread      : " << pooledSeconds * 1000.0 << " ms ("
+              << baker.raysCast / pooledSeconds / 1e6 << " juta ray/detik)" << std::endl;
+    return 0;
+}
+
+// Gedung kantor dari generator (20 x 20 ruangan x 4 lantai): teks dibuat
+// dengan satu thread lalu dengan pool penuh (harus identik), kemudian file
+// scene berisi pernyataan `building` tersebut dimuat seperti biasa
+int runSceneBenchmark() {
+    BuildingGenerator generator;
+    generator.layout.roomsX = 20;
+    generator.layout.roomsZ = 20;
+    generator.layout.floors = 4;
+    generator.layout.seed = 2024;
+    
+    std::cout << "BENCHMARK GENERATOR GEDUNG (" << generator.layout.roomsX << " x " << generator.layout.roomsZ
+              << " ruangan x " << generator.layout.floors << " lantai, seed " << generator.layout.seed << ")" << std::endl;
+    ThreadPool single(1);
+    ThreadPool* pools[2] = {&single, &workerPool()};
+    std::string texts[2];
+    for (int i = 0; i < 2; i++) {
+        double t0 = monotonicTime();
+        texts[i] = generator.generate(*pools[i]);
+        double ms = (monotonicTime() - t0) * 1000.0;
+        std::cout << "  " << pools[i]->size() << " thread: " << ms << " ms, "
+                  << texts[i].size() / 1024 << " KB teks scene" << std::endl;
+    }
+    SceneHasher hash;
+    hash.mix(texts[1].data(), texts[1].size());
+    std::cout << "  Deterministik: " << (texts[0] == texts[1] ? "ya" : "TIDAK") << " (hash "
+              << std::hex << hash.value << std::dec << ")" << std::endl;
+    
+    std::string path = "cache/bench_office.scene";
+    std::filesystem::create_directories("cache");
+    std::ostringstream text;
+    text << "# Gedung kantor (dibuat --bench-scene)\n";
+    text << "light main pos=0,2.4,0 color=1,0.95,0.8\n";
+    text << "building rooms=" << generator.layout.roomsX << "," << generator.layout.roomsZ
+         << " floors=" << generator.layout.floors << " seed=" << generator.layout.seed << "\n";
+    std::string contents = text.str();
+    std::ofstream(path, std::ios::binary).write(contents.data(), contents.size());
+    
+    // Muat = parse (termasuk generator dan mesh prototype) + instantiate objek
+    double t0 = monotonicTime();
+    SceneDescription office;
+    office.loadFile(path);
+    double parseMs = (monotonicTime() - t0) * 1000.0;
+    t0 = monotonicTime();
+    std::vector<Object3D> objects = office.instantiate();
+    double instantiateMs = (monotonicTime() - t0) * 1000.0;
+    double loadMs = parseMs + instantiateMs;
+    
+    std::cout << "BENCHMARK FILE SCENE (" << path << ")" << std::endl;
+    std::cout << "  Isi         : " << office.rooms << " ruangan, " << objects.size()
+              << " objek, " << office.lights.size() << " lampu, " << office.prototypes.size()
+              << " mesh prototype (" << meshCache().hits << " dari cache mesh)" << std::endl;
+    std::cout << "  Parse       : " << parseMs << " ms termasuk generator (" << office.errors << " error)" << std::endl;
+    std::cout << "  Instantiate : " << instantiateMs << " ms" << std::endl;
+    std::cout << "  Waktu muat  : " << loadMs << " ms (" << objects.size() / loadMs * 1000.0
+              << " objek/detik)" << std::endl;
+    return texts[0] == texts[1] && office.errors == 0 ? 0 : 1;
+}
+
+// Tulis ulang --scene dengan setiap pernyataan `building` diganti teks hasil
+// generatornya: denah produksi yang bisa disunting tangan
+int runSceneExpand(const std::string& outPath) {
+    std::string expanded;
+    SceneDescription scene;
+    scene.expandInto = &expanded;
+    if (!scene.loadFile(sceneFilePath)) return 1;
+    std::ofstream out(outPath, std::ios::binary);
+    out.write(expanded.data(), expanded.size());
+    if (!out) {
+        std::cerr << "ERROR: Cannot write scene file: " << outPath << std::endl;
+        return 1;
+    }
+    std::cout << "Scene diperluas: " << sceneFilePath << " -> " << outPath << " (" << scene.rooms
+              << " ruangan, " << scene.instances.size() << " instance, " << expanded.size() / 1024
+              << " KB)" << std::endl;
+    return scene.errors > 0 ? 1 : 0;
+}
+
+// Import satu model (OBJ/glTF) dengan satu thread lalu dengan pool penuh
+int runImportBenchmark(const std::string& path) {
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(path, error);
+    if (error) {
+        std::cerr << "ERROR: Cannot open model file: " << path << std::endl;
+        return 1;
+    }
+    std::cout << "BENCHMARK IMPORT MODEL (" << path << ", " << fileSize / (1024 * 1024) << " MB)" << std::endl;
+    
+    ThreadPool single(1);
+    ThreadPool* pools[2] = {&single, &workerPool()};
+    for (ThreadPool* pool : pools) {
+        ModelImporter importer;
+        Object3D mesh;
+        double t0 = monotonicTime();
+        if (!importer.load(path, mesh, *pool)) return 1;
+        double ms = (monotonicTime() - t0) * 1000.0;
+        AABB bounds = mesh.getLocalBounds();
+        std::cout << "  " << pool->size() << " thread: " << ms << " ms, " << importer.triangles
+                  << " segitiga (" << importer.triangles / ms / 1000.0 << " juta/detik), "
+                  << importer.generatedNormals << " normal dibuat, "
+                  << mesh.vertices.size() * sizeof(Vertex) / (1024 * 1024) << " MB vertex" << std::endl;
+        std::cout << "    bounds: (" << bounds.min.x << ", " << bounds.min.y << ", " << bounds.min.z << ") - ("
+                  << bounds.max.x << ", " << bounds.max.y << ", " << bounds.max.z << ")" << std::endl;
+    }
+    return 0;
+}
+
+// Butuh context GL: dipanggil dari main setelah glad dimuat
+int runShaderCompileBenchmark() {
+    shaderCacheEnabled = false;   // Ukur compile sebenarnya, bukan load binary
+    programBinaryCache().init();
+    shaderCompiler().init();
+    
+    const char* paths[2][2] = {{"shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl"},
+                               {"shaders/deferred_vertex.glsl", "shaders/deferred_fragment.glsl"}};
+    const uint32_t combinations = 1u << SHADER_FEATURE_COUNT;
+    std::vector<unsigned int> programs;
+    
+    // Serial: compile, cek status, link, cek status per program
+    double t0 = monotonicTime();
+    for (int p = 0; p < 2; p++) {
+        for (uint32_t features = 0; features < combinations; features++) {
+            programs.push_back(loadShader(paths[p][0], paths[p][1], nullptr, shaderDefines(features)));
+        }
+    }
+    double serialSeconds = monotonicTime() - t0;
+    for (unsigned int program : programs) glDeleteProgram(program);
+    programs.clear();
+    
+    // Batch: kirim semua dulu, status diperiksa setelahnya. Define tambahan
+    // membuat source berbeda agar driver tidak memakai cache internalnya.
+    t0 = monotonicTime();
+    for (int p = 0; p < 2; p++) {
+        for (uint32_t features = 0; features < combinations; features++) {
+            programs.push_back(submitShader(paths[p][0], paths[p][1], nullptr,
+                                            shaderDefines(features) + "#define BENCH_BATCH\n"));
+        }
+    }
+    double submitSeconds = monotonicTime() - t0;
+    shaderCompiler().finishAll();
+    double batchSeconds = monotonicTime() - t0;
+    for (unsigned int program : programs) glDeleteProgram(program);
+    
+    std::cout << "BENCHMARK COMPILE SHADER (" << programs.size() << " varian forward + deferred)" << std::endl;
+    std::cout << "  Compile paralel driver : " << (shaderCompiler().isParallel() ? "ya" : "tidak") << std::endl;
+    std::cout << "  Serial                 : " << serialSeconds * 1000.0 << " ms" << std::endl;
+    std::cout << "  Batch                  : " << batchSeconds * 1000.0 << " ms (kirim "
+              << submitSeconds * 1000.0 << " ms)" << std::endl;
+    std::cout << "  Ekspansi #include      : " << shaderPreprocessor().expansions << " file, "
+              << shaderPreprocessor().cacheHits << " hit cache" << std::endl;
+    return 0;
+}
+
+// =====================================================================
+// MAIN FUNCTION
+// =====================================================================
+int main(int argc, char** argv) {
+    // Benchmark jalur render butuh window dan konteks GL, dijalankan setelah setup
+    bool renderBenchmark = false;
+    bool shaderBenchmark = false;
+    bool editBenchmark = false;
+    std::string restoreSnapshotPath;   // Dipulihkan saat scene lengkap
+    
+    // Opsi dibaca semua lebih dulu, baru mode benchmark/alat dijalankan,
+    // sehingga urutan flag bebas (misal --bench-pick --scene file)
+    std::string commandLineMode, commandLineArgument;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--bench-collision") == 0) commandLineMode = argv[i];
+        if (std::strcmp(argv[i], "--bench-pick") == 0) commandLineMode = argv[i];
+        if (std::strcmp(argv[i], "--bench-octree") == 0) commandLineMode = argv[i];
+        if (std::strcmp(argv[i], "--bench-snapshot") == 0) commandLineMode = argv[i];
+        if (std::strcmp(argv[i], "--bench-lights") == 0) commandLineMode = argv[i];
+        if (std::strcmp(argv[i], "--bench-bake") == 0) commandLineMode = argv[i];
+        if (std::strcmp(argv[i], "--bench-ao") == 0) commandLineMode = argv[i];
+        if (std::strcmp(argv[i], "--bench-scene") == 0) commandLineMode = argv[i];
+        if ((std::strcmp(argv[i], "--bench-import") == 0 || std::strcmp(argv[i], "--expand-scene") == 0) &&
+            i + 1 < argc) {
+            commandLineMode = argv[i];
+            commandLineArgument = argv[++i];
+        }
+        if (std::strcmp(argv[i], "--scene") == 0 && i + 1 < argc) sceneFilePath = argv[++i];
+        if (std::strcmp(argv[i], "--detail-px") == 0 && i + 1 < argc)
+            detailPixelThreshold = (float)std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--no-shadows") == 0) shadowsEnabled = false;
+        if (std::strcmp(argv[i], "--lights") == 0 && i + 1 < argc)
+            extraLightCount = std::max(std::atoi(argv[++i]), 0);
+        if (std::strcmp(argv[i], "--deferred") == 0) renderPath = PATH_DEFERRED;
+        if (std::strcmp(argv[i], "--baked") == 0) bakedLightingEnabled = true;
+        if (std::strcmp(argv[i], "--no-ao") == 0) aoEnabled = false;
+        if (std::strcmp(argv[i], "--ao-budget") == 0 && i + 1 < argc)
+            aoRayBudget = std::max(std::atoll(argv[++i]), 0ll) * 1000000;
+        if (std::strcmp(argv[i], "--no-post") == 0) postProcessEnabled = false;
+        if (std::strcmp(argv[i], "--no-materials") == 0) materialsEnabled = false;
+        if (std::strcmp(argv[i], "--fixed-res") == 0) dynamicResolutionEnabled = false;
+        if (std::strcmp(argv[i], "--no-shader-cache") == 0) shaderCacheEnabled = false;
+        if (std::strcmp(argv[i], "--no-mesh-cache") == 0) meshCacheEnabled = false;
+        if (std::strcmp(argv[i], "--sync-load") == 0) syncSceneLoad = true;
+        if (std::strcmp(argv[i], "--upload-budget") == 0 && i + 1 < argc)
+            uploadBudgetBytes = std::max((size_t)(std::atof(argv[++i]) * 1024.0 * 1024.0), (size_t)65536);
+        if (std::strcmp(argv[i], "--shader-dir") == 0 && i + 1 < argc) shaderOverrideDir = argv[++i];
+        if (std::strcmp(argv[i], "--target-ms") == 0 && i + 1 < argc)
+            targetFrameMs = std::max((float)std::atof(argv[++i]), 1.0f);
+        if (std::strcmp(argv[i], "--render-scale") == 0 && i + 1 < argc)
+            fixedRenderScale = (float)std::atof(argv[++i]);
+        if (std::strcmp(argv[i], "--fog") == 0) fogEnabled = true;
+        if (std::strcmp(argv[i], "--bench-render") == 0) renderBenchmark = true;
+        if (std::strcmp(argv[i], "--bench-shaders") == 0) shaderBenchmark = true;
+        if (std::strcmp(argv[i], "--bench-edit") == 0) editBenchmark = true;
+        if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) snapshotPath = argv[++i];
+        if (std::strcmp(argv[i], "--restore-snapshot") == 0 && i + 1 < argc)
+            snapshotPath = restoreSnapshotPath = argv[++i];
+    }
+    
+    // Mode benchmark dari command line
+    if (commandLineMode == "--bench-collision") return runCollisionBenchmark();
+    if (commandLineMode == "--bench-pick") return runPickBenchmark();
+    if (commandLineMode == "--bench-octree") return runOctreeBenchmark();
+    if (commandLineMode == "--bench-snapshot") return runSnapshotBenchmark();
+    if (commandLineMode == "--bench-lights") return runLightBenchmark();
+    if (commandLineMode == "--bench-bake") return runBakeBenchmark();
+    if (commandLineMode == "--bench-ao") return runAOBenchmark();
+    if (commandLineMode == "--bench-scene") return runSceneBenchmark();
+    if (commandLineMode == "--bench-import") return runImportBenchmark(commandLineArgument);
+    if (commandLineMode == "--expand-scene") return runSceneExpand(commandLineArgument);
+    
+    // Inisialisasi GLFW
+    if (!glfwInit()) {
+        std::cerr << "Failed to initialize GLFW" << std::endl;
+        return -1;
+    }
+    
+    // Konfigurasi GLFW
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    
+    // Buat window
+    GLFWwindow* window = glfwCreateWindow(SCR_WIDTH, SCR_HEIGHT, 
+        "Simulasi Ruang Kerja 3D - Grafika Komputer", NULL, NULL);
+    if (window == NULL) {
+        std::cerr << "Failed to create GLFW window" << std::endl;
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    
+    // Set callbacks
+    glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+    glfwSetCursorPosCallback(window, mouse_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    
+    // Capture mouse
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    
+    // Inisialisasi GLAD
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cerr << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+    if (shaderBenchmark) {
+        int result = runShaderCompileBenchmark();
+        glfwTerminate();
+        return result;
+    }
+    
+    // Enable depth testing
+    glEnable(GL_DEPTH_TEST);
+    
+    // Back-face culling (diaktifkan per draw range mesh tertutup)
+    glCullFace(GL_BACK);
+    glFrontFace(GL_CCW);
+    
+    // Tata letak ruangan, perabot, dan lampu dari file scene (--scene),
+    // dimuat di thread loader selagi shader dikompilasi dan frame pertama
+    // digambar. Mesh prototype diambil dari cache/meshes.bin jika ada.
+    double startupStart = monotonicTime();
+    SceneLoader loader;
+    loader.start(sceneFilePath, aoEnabled || bakedLightingEnabled);
+    
+    // Load shaders: semua compile + link dikirim dulu (paralel di driver jika
+    // didukung), status diperiksa saat program pertama kali dipakai. Binary
+    // program diambil dari cache/shaders jika driver mendukung.
+    programBinaryCache().init();
+    shaderCompiler().init();
+    
+    ShaderVariants forwardShaders("shaders/vertex_shader.glsl", "shaders/fragment_shader.glsl");
+    ShaderVariants deferredShaders("shaders/deferred_vertex.glsl", "shaders/deferred_fragment.glsl");
+    unsigned int lightShader = submitShader("shaders/light_vertex.glsl", 
+                                            "shaders/light_fragment.glsl");
+    unsigned int shadowShader = submitShader("shaders/shadow_vertex.glsl",
+                                             "shaders/shadow_fragment.glsl",
+                                             "shaders/shadow_geometry.glsl");
+    unsigned int gbufferShader = submitShader("shaders/vertex_shader.glsl",
+                                              "shaders/gbuffer_fragment.glsl", nullptr, shaderConstants());
+    
+    // Lampu titik lokal untuk clustered forward shading (diisi saat scene masuk)
+    std::vector<PointLight> roomLights;
+    
+    // Varian jalur aktif yang bisa dicapai lewat toggle lampu/kabut. Selama
+    // loading dipakai varian clustered dengan daftar lampu kosong, sehingga
+    // scene yang punya lampu lokal tidak perlu varian tambahan.
+    ShaderVariants& activeVariants = renderPath == PATH_FORWARD ? forwardShaders : deferredShaders;
+    activeVariants.prewarm(reachableShaderFeatures(true));
+    
+    // Post-process: scene HDR -> bloom, tone mapping, color grading, FXAA
+    PostProcessGraph postGraph;
+    if (postProcessEnabled) {
+        postGraph.init();
+        addRoomPostPasses(postGraph);
+        postGraph.compile();
+    }
+    
+    unsigned int startupPrograms[3] = {lightShader, shadowShader, gbufferShader};
+    for (unsigned int program : startupPrograms) shaderCompiler().finish(program);
+    std::cout << "Startup: " << shaderCompiler().submitted << " program shader siap dalam "
+              << (monotonicTime() - startupStart) * 1000.0 << " ms (" << programBinaryCache().hits
+              << " dari cache binary" << (programBinaryCache().isAvailable() ? "" : " [tidak didukung]")
+              << ", " << shaderCompiler().compiled << " dikompilasi "
+              << (shaderCompiler().isParallel() ? "paralel" : "serial") << ")" << std::endl;
+    
+    // Atribut baked default (w = 0) untuk objek tanpa data baked
+    glVertexAttrib4f(3, 0.0f, 0.0f, 0.0f, 0.0f);
+    // Material default (tanpa layer) untuk VAO tanpa atribut material
+    glVertexAttribI4i(5, 0, 0, 0, 0);
+    
+    // Light source visualization
+    Object3D lightCube = createLightCube();
+    lightCube.position = lightPos;
+    validateMesh(lightCube);
+    lightCube.setup();
+    
+    // =====================================================================
+    // OBJEK RUANGAN, KOLISI, DAN PICKING (DIISI BERTAHAP OLEH LOADER)
+    // =====================================================================
+    // sceneObjects kosong sampai loader selesai, lalu mengambil alih vector
+    // milik loader (alamat objek tetap, sehingga pointer di dunia kolisi dan
+    // picking yang dibangun loader tetap valid)
+    std::vector<Object3D> sceneObjects;
+    
+    // Indeks scene untuk frustum culling (statis + dinamis)
+    SceneIndex sceneIndex;
+    sceneIndex.build(sceneObjects);
+    std::vector<Object3D*> visibleObjects;
+    DrawList drawList;
+    
+    // Edit tata letak (aktif setelah scene lengkap). Objek terpilih disimpan
+    // sebagai indeks karena duplikasi bisa memindahkan isi vector.
+    SceneEditor editor;
+    int selectedIndex = -1;
+    glm::vec3 selectedColor(0.0f);   // Warna segitiga yang diklik (sumber recolor)
+    SceneSnapshot snapshot;          // F5/F9 dan --restore-snapshot
+    
+    // Shadow map lampu (layer statis di-cache, layer dinamis kecil)
+    PointShadowMap shadowMap;
+    shadowMap.init();
+    
+    LightClusters lightClusters;
+    lightClusters.init();
+    
+    // Texture array material (dibind sekali per frame)
+    MaterialLibrary materials;
+    materials.init(materialsEnabled);
+    
+    // G-buffer untuk jalur deferred (ukuran mengikuti framebuffer)
+    GBuffer gbuffer;
+    int initialWidth, initialHeight;
+    glfwGetFramebufferSize(window, &initialWidth, &initialHeight);
+    gbuffer.init(initialWidth, initialHeight);
+    DynamicResolution dynamicResolution;
+    dynamicResolution.init();
+    
+    // Log hasil pulihkan snapshot (hotkey F9 dan --restore-snapshot)
+    auto restoreSnapshot = [&]() {
+        if (!snapshot.restore(snapshotPath)) return;
+        selectedIndex = -1;
+        std::cout << "Snapshot dipulihkan: " << snapshotPath << " - " << snapshot.lastMoved << " objek dipindah, "
+                  << snapshot.lastRestyled << " mesh/warna dibuat ulang, " << snapshot.lastRemoved << " dihapus, " << snapshot.lastMissing << " tidak bisa dibuat ulang ("
+                  << snapshot.lastMicros << " us)" << std::endl;
+    };
+    
+    // =====================================================================
+    // MASUKKAN SCENE DARI LOADER (SEKALI PER FRAME)
+    // =====================================================================
+    // Setelah loader selesai instantiate, objek yang sudah terbit di-upload
+    // sampai budget byte. Objek baru langsung masuk loose octree dan shadow
+    // map digambar ulang. Selama loading yang digambar adalah vector milik
+    // loader (liveObjects); setelah semua objek ter-upload dan kolisi/
+    // picking jadi, sceneObjects mengambil alih vector itu (alamat objek
+    // tetap) dan objek statis pindah ke BVH. Return true jika scene lengkap.
+    bool sceneAdopted = false, sceneComplete = false, sceneFailed = false;
+    std::vector<Object3D>* liveObjects = &sceneObjects;
+    auto streamScene = [&](size_t budget) {
+        if (sceneComplete) return true;
+        if (!sceneAdopted) {
+            if (!loader.hasStarted()) {
+                if (!loader.isReady()) return false;
+                loader.wait();
+                sceneFailed = sceneComplete = true;
+                glfwSetWindowShouldClose(window, GLFW_TRUE);
+                return true;
+            }
+            sceneAdopted = true;
+            liveObjects = &loader.objects;
+            loader.scene.applyMainLight();
+            lightCube.position = lightPos;
+            const glm::vec3& room = loader.scene.roomSize;
+            roomLights = createRoomLights(loader.scene.lights, room.x, room.y, room.z, extraLightCount);
+            if (roomLights.empty()) activeVariants.prewarm(reachableShaderFeatures(false));
+            sceneIndex.beginStreaming(loader.bounds);
+            std::cout << "Scene: " << sceneFilePath << " - " << loader.objects.size() << " objek, "
+                      << loader.scene.lights.size() << " lampu lokal, mesh siap di-bake dalam "
+                      << loader.startMs << " ms" << std::endl;
+        }
+        
+        size_t first = loader.upload(budget);
+        for (size_t i = first; i < loader.uploaded; i++) {
+            loader.objects[i].selectBakedState(lightOn ? 1 : 0);
+            sceneIndex.addStreamed(loader.objects[i]);
+        }
+        if (loader.uploaded > first) shadowMap.invalidate();
+        if (loader.uploaded < loader.objects.size() || !loader.isReady()) return false;
+        
+        loader.wait();
+        sceneObjects = std::move(loader.objects);
+        liveObjects = &sceneObjects;
+        collisionWorld = &loader.collision;
+        pickScene = &loader.pick;
+        sceneIndex.build(sceneObjects);
+        editor.attach(sceneObjects, sceneIndex, loader.collision, loader.pick, loader.scene);
+        snapshot.attach(sceneObjects, editor);
+        sceneComplete = true;
+        std::cout << "Scene lengkap: " << loader.uploadedBytes / (1024 * 1024) << " MB di-upload dalam "
+                  << loader.uploadFrames << " frame, loader " << loader.buildMs << " ms, "
+                  << (monotonicTime() - startupStart) * 1000.0 << " ms sejak start" << std::endl;
+        if (!restoreSnapshotPath.empty()) restoreSnapshot();
+        return true;
+    };
+    
+    // --sync-load (dan benchmark): seluruh scene sebelum frame pertama
+    if (syncSceneLoad || renderBenchmark || editBenchmark) {
+        loader.wait();
+        streamScene(SIZE_MAX);
+    }
+    
+    // Print kontrol
+    std::cout << "========================================" << std::endl;
+    std::cout << "  SIMULASI RUANG KERJA 3D" << std::endl;
+    std::cout << "  Grafika Komputer" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "\nKONTROL:" << std::endl;
+    std::cout << "  WASD      - Gerak kamera" << std::endl;
+    std::cout << "  Mouse     - Rotasi pandangan" << std::endl;
+    std::cout << "  Scroll    - Zoom in/out" << std::endl;
+    std::cout << "  1         - View depan" << std::endl;
+    std::cout << "  2         - View atas" << std::endl;
+    std::cout << "  3         - View samping" << std::endl;
+    std::cout << "  4         - View sudut" << std::endl;
+    std::cout << "  L         - Toggle lampu" << std::endl;
+    std::cout << "  C         - Toggle kolisi kamera" << std::endl;
+    std::cout << "  F         - Toggle kabut" << std::endl;
+    std::cout << "  Klik kiri - Pilih objek di tengah layar" << std::endl;
+    std::cout << "  Panah     - Geser objek terpilih 0.1 m" << std::endl;
+    std::cout << "  R         - Putar objek terpilih 15 derajat" << std::endl;
+    std::cout << "  K         - Ganti warna bagian yang diklik" << std::endl;
+    std::cout << "  M         - Ganti mesh (prototype berikutnya)" << std::endl;
+    std::cout << "  N         - Duplikasi objek terpilih" << std::endl;
+    std::cout << "  Delete    - Hapus objek terpilih" << std::endl;
+    std::cout << "  F5        - Simpan snapshot state" << std::endl;
+    std::cout << "  F9        - Pulihkan snapshot state" << std::endl;
+    std::cout << "  ESC       - Keluar" << std::endl;
+    std::cout << "========================================" << std::endl;
+    
+    // =====================================================================
+    // RENDER SATU FRAME (FORWARD ATAU DEFERRED)
+    // =====================================================================
+    // Dipakai render loop dan benchmark jalur render, sehingga keduanya
+    // menggambar scene yang persis sama dari kamera yang sama.
+    auto renderFrame = [&](RenderPath path, const glm::mat4& projection, const glm::mat4& view) {
+        int framebufferWidth, framebufferHeight;
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        if (framebufferWidth <= 0 || framebufferHeight <= 0) return;   // Window diminimalkan
+        
+        // Resolusi scene: mengikuti skala dinamis, di-upscale post-process
+        int renderWidth = framebufferWidth, renderHeight = framebufferHeight;
+        bool scaledRendering = postProcessEnabled && dynamicResolutionEnabled;
+        if (scaledRendering) {
+            dynamicResolution.beginFrame();
+            dynamicResolution.renderSize(framebufferWidth, framebufferHeight, renderWidth, renderHeight);
+        }
+        
+        // Perbarui shadow map hanya jika lampu atau objek dinamis bergerak
+        sceneIndex.updateDynamic();
+        if (shadowsEnabled) {
+            shadowMap.update(lightPos, *liveObjects, sceneIndex.dynamicTree.moveCount(),
+                             shadowShader);
+        }
+        
+        // Daftar lampu lokal per cluster (dibangun paralel di CPU)
+        lightClusters.build(roomLights, view, projection, workerPool());
+        lightClusters.upload();
+        
+        // Frustum culling (BVH statis + loose octree) dan culling layer
+        // detail dalam satu pass, menghasilkan draw list
+        buildDrawList(sceneIndex, projection, view, cameraPos, fov, (float)framebufferHeight,
+                      visibleObjects, drawList);
+        
+        // Varian shader sesuai fitur aktif frame ini (dikompilasi saat pertama dipakai)
+        uint32_t features = activeShaderFeatures(!roomLights.empty() || !sceneAdopted);
+        
+        // Forward: objek langsung di-shade. Deferred: objek hanya menulis
+        // G-buffer, shading dilakukan pass layar penuh setelahnya.
+        unsigned int shaderProgram = path == PATH_FORWARD ? forwardShaders.get(features) : 0;
+        unsigned int geometryProgram = path == PATH_DEFERRED ? gbufferShader : shaderProgram;
+        if (path == PATH_DEFERRED) gbuffer.resize(renderWidth, renderHeight);
+        
+        // Target scene: HDR offscreen jika post-process aktif
+        unsigned int sceneTarget = 0;
+        if (postProcessEnabled) {
+            postGraph.beginScene(renderWidth, renderHeight);
+            sceneTarget = postGraph.sceneFramebuffer();
+        } else {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glViewport(0, 0, framebufferWidth, framebufferHeight);
+        }
+        glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (path == PATH_DEFERRED) gbuffer.beginGeometryPass();
+        
+        glUseProgram(geometryProgram);
+        glUniformMatrix4fv(glGetUniformLocation(geometryProgram, "projection"),
+                          1, GL_FALSE, glm::value_ptr(projection));
+        glUniformMatrix4fv(glGetUniformLocation(geometryProgram, "view"),
+                          1, GL_FALSE, glm::value_ptr(view));
+        materials.bind(geometryProgram, MATERIAL_TEXTURE_UNIT);
+        if (path == PATH_FORWARD) {
+            shadowMap.bind(shaderProgram, 0, 1);
+            lightClusters.bind(shaderProgram, 2, glm::vec2(renderWidth, renderHeight));
+            setLightingUniforms(shaderProgram);
+        }
+        
+        // Bagian tertutup dengan back-face culling, lalu bagian dua sisi
+        // (bidang tunggal) tanpa culling
+        int modelLocation = glGetUniformLocation(geometryProgram, "model");
+        glEnable(GL_CULL_FACE);
+        drawItems(drawList.culled, modelLocation);
+        glDisable(GL_CULL_FACE);
+        drawItems(drawList.twoSided, modelLocation);
+        
+        if (path == PATH_DEFERRED) {
+            unsigned int deferredShader = deferredShaders.get(features);
+            glUseProgram(deferredShader);
+            glUniformMatrix4fv(glGetUniformLocation(deferredShader, "view"),
+                              1, GL_FALSE, glm::value_ptr(view));
+            glUniformMatrix4fv(glGetUniformLocation(deferredShader, "invViewProjection"),
+                              1, GL_FALSE, glm::value_ptr(glm::inverse(projection * view)));
+            shadowMap.bind(deferredShader, 0, 1);
+            lightClusters.bind(deferredShader, 2, glm::vec2(renderWidth, renderHeight));
+            setLightingUniforms(deferredShader);
+            gbuffer.lightingPass(deferredShader, 5, sceneTarget);
+        }
+        
+        // Render light source cube
+        if (lightOn) {
+            glUseProgram(lightShader);
             glUniformMatrix4fv(glGetUniformLocation(lightShader, "projection"), 
                               1, GL_FALSE, glm::value_ptr(projection));
             glUniformMatrix4fv(glGetUniformLocation(lightShader, "view"), 
                               1, GL_FALSE, glm::value_ptr(view));
             glUniformMatrix4fv(glGetUniformLocation(lightShader, "model"), 
                               1, GL_FALSE, glm::value_ptr(lightCube.getModelMatrix()));
+            glm::vec3 bulbColor = lightColor * (postProcessEnabled ? LAMP_EMISSIVE_HDR : 1.0f);
             glUniform3fv(glGetUniformLocation(lightShader, "lightColor"), 
-                        1, glm::value_ptr(lightColor));
+                        1, glm::value_ptr(bulbColor));
             lightCube.draw();
         }
         
+        // Post-process dari target HDR ke layar
+        if (postProcessEnabled) postGraph.execute(framebufferWidth, framebufferHeight);
+        if (scaledRendering) dynamicResolution.endFrame();
+    };
+    
+    // Benchmark jalur render: jalur kamera yang sama untuk forward dan deferred
+    if (renderBenchmark) {
+        glfwSwapInterval(0);
+        const int frames = 300;
+        std::cout << "BENCHMARK JALUR RENDER (" << roomLights.size() << " lampu lokal, "
+                  << frames << " frame per jalur)" << std::endl;
+        RenderPath paths[2] = {PATH_FORWARD, PATH_DEFERRED};
+        const char* pathNames[2] = {"Forward ", "Deferred"};
+        for (int p = 0; p < 2; p++) {
+            // Satu frame pemanasan (kompilasi shader/alokasi G-buffer di driver)
+            double total = 0.0, worst = 0.0;
+            for (int f = -1; f < frames; f++) {
+                // Kamera mengelilingi ruangan sambil menghadap ke tengah
+                float t = glm::two_pi<float>() * (float)std::max(f, 0) / frames;
+                cameraPos = glm::vec3(3.5f * std::cos(t), 1.7f + 0.5f * std::sin(2.0f * t),
+                                      2.5f * std::sin(t));
+                glm::mat4 projection = glm::perspective(glm::radians(fov),
+                    framebufferAspect(window), 0.1f, 100.0f);
+                glm::mat4 view = glm::lookAt(cameraPos, glm::vec3(0.0f, 1.2f, 0.0f), cameraUp);
+                
+                double t0 = monotonicTime();
+                renderFrame(paths[p], projection, view);
+                glFinish();
+                double ms = (monotonicTime() - t0) * 1000.0;
+                glfwSwapBuffers(window);
+                glfwPollEvents();
+                if (f < 0) continue;
+                total += ms;
+                worst = std::max(worst, ms);
+            }
+            std::cout << "  " << pathNames[p] << " : " << total / frames << " ms/frame rata-rata, "
+                      << worst << " ms terburuk";
+            if (postProcessEnabled) std::cout << " (" << postGraph.roundTrips() << " round trip post-process)";
+            std::cout << std::endl;
+        }
+        glfwTerminate();
+        return 0;
+    }
+    
+    // Benchmark edit inkremental: edit acak per frame (pindah, warna, mesh,
+    // duplikasi, hapus) lalu satu flush, dibandingkan dengan upload ulang
+    if (editBenchmark) {
+        const int frames = 200, editsPerFrame = 20;
+        const auto& prototypes = loader.scene.prototypes;
+        size_t sceneBytes = 0;
+        for (const auto& obj : sceneObjects) sceneBytes += obj.vertices.size() * sizeof(Vertex);
+        std::cout << "BENCHMARK EDIT INKREMENTAL (" << sceneObjects.size() << " objek, " << frames
+                  << " frame x " << editsPerFrame << " edit)" << std::endl;
+        
+        LayoutRandom random{2024};
+        double editSeconds = 0.0, flushSeconds = 0.0, worst = 0.0;
+        for (int f = 0; f < frames; f++) {
+            double t0 = monotonicTime();
+            for (int e = 0; e < editsPerFrame; e++) {
+                Object3D& obj = sceneObjects[random.pick((int)sceneObjects.size())];
+                if (obj.vertices.size() < 3) continue;
+                float roll = random.uniform();
+                if (roll < 0.5f) {
+                    glm::vec3 offset(random.uniform() - 0.5f, 0.0f, random.uniform() - 0.5f);
+                    editor.move(obj, obj.position + offset * 0.2f, obj.rotation, obj.scale);
+                } else if (roll < 0.8f) {
+                    glm::vec3 from = obj.vertices[random.pick((int)obj.vertices.size() / 3) * 3].color;
+                    editor.recolor(obj, from, glm::vec3(random.uniform(), random.uniform(), random.uniform()));
+                } else if (roll < 0.9f && !prototypes.empty()) {
+                    editor.replaceMesh(obj, random.pick((int)prototypes.size()));
+                } else if (roll < 0.95f) {
+                    editor.addInstance(obj, obj.position + glm::vec3(0.5f, 0.0f, 0.5f), obj.rotation);
+                } else {
+                    editor.remove(obj);
+                }
+            }
+            double t1 = monotonicTime();
+            editor.flush();
+            glFinish();
+            double t2 = monotonicTime();
+            editSeconds += t1 - t0;
+            flushSeconds += t2 - t1;
+            worst = std::max(worst, (t2 - t0) * 1000.0);
+        }
+        
+        std::cout << "  Edit (CPU + objek baru)  : " << editSeconds * 1000.0 / frames << " ms/frame rata-rata" << std::endl;
+        std::cout << "  Flush + glFinish         : " << flushSeconds * 1000.0 / frames << " ms/frame rata-rata, "
+                  << worst << " ms frame terburuk" << std::endl;
+        std::cout << "  Upload inkremental       : " << editor.uploadedBytes / 1024 << " KB ("
+                  << editor.edits << " edit, " << editor.flushes << " flush)" << std::endl;
+        std::cout << "  Re-upload buffer diedit  : " << editor.bufferBytes / 1024 << " KB" << std::endl;
+        std::cout << "  Re-upload scene per frame: " << sceneBytes * frames / (1024 * 1024) << " MB" << std::endl;
+        glfwTerminate();
+        return 0;
+    }
+    
+    // =====================================================================
+    // EDIT TATA LETAK DARI KEYBOARD
+    // =====================================================================
+    // Objek terpilih (klik kiri) diedit lewat SceneEditor; warna baru
+    // diambil bergiliran dari palet, mesh dari prototype file scene.
+    const glm::vec3 editPalette[4] = {
+        glm::vec3(0.75f, 0.2f, 0.2f), glm::vec3(0.2f, 0.45f, 0.75f),
+        glm::vec3(0.3f, 0.65f, 0.3f), glm::vec3(0.9f, 0.8f, 0.3f)
+    };
+    int paletteStep = 0, prototypeStep = -1;
+    auto applyEdit = [&](EditAction action) {
+        Object3D& obj = sceneObjects[selectedIndex];
+        switch (action) {
+        case EDIT_MOVE:
+            editor.move(obj, obj.position + editOffset, obj.rotation, obj.scale);
+            std::cout << "Edit: " << obj.name << " dipindah ke (" << obj.position.x << ", "
+                      << obj.position.z << ")" << std::endl;
+            break;
+        case EDIT_ROTATE:
+            editor.move(obj, obj.position, obj.rotation + glm::vec3(0.0f, 15.0f, 0.0f), obj.scale);
+            std::cout << "Edit: " << obj.name << " diputar ke " << obj.rotation.y << " derajat" << std::endl;
+            break;
+        case EDIT_RECOLOR: {
+            glm::vec3 color = editPalette[paletteStep++ % 4];
+            size_t changed = editor.recolor(obj, selectedColor, color);
+            if (changed > 0) selectedColor = color;
+            std::cout << "Edit: " << obj.name << " ganti warna (" << changed << " dari "
+                      << obj.vertices.size() << " vertex)" << std::endl;
+            break;
+        }
+        case EDIT_REPLACE: {
+            const auto& prototypes = loader.scene.prototypes;
+            if (prototypes.empty()) {
+                std::cout << "Edit: scene tidak punya prototype mesh" << std::endl;
+                break;
+            }
+            prototypeStep = (prototypeStep + 1) % (int)prototypes.size();
+            editor.replaceMesh(obj, prototypeStep);
+            if (!obj.vertices.empty()) selectedColor = obj.vertices[0].color;
+            std::cout << "Edit: " << obj.name << " memakai mesh prototype #" << prototypeStep << " ("
+                      << obj.vertices.size() << " vertex)" << std::endl;
+            break;
+        }
+        case EDIT_DUPLICATE: {
+            // obj tidak dipakai lagi setelah ini (vector bisa tumbuh)
+            Object3D& copy = editor.addInstance(obj, obj.position + glm::vec3(0.5f, 0.0f, 0.5f), obj.rotation);
+            selectedIndex = (int)sceneObjects.size() - 1;
+            std::cout << "Edit: " << copy.name << " diduplikasi (" << sceneObjects.size() << " objek)" << std::endl;
+            break;
+        }
+        case EDIT_DELETE:
+            std::cout << "Edit: " << obj.name << " dihapus" << std::endl;
+            editor.remove(obj);
+            selectedIndex = -1;
+            break;
+        default:
+            break;
+        }
+    };
+    
+    // =====================================================================
+    // RENDER LOOP
+    // =====================================================================
+    bool bakedStateOn = true;
+    bool firstFrame = true;
+    while (!glfwWindowShouldClose(window)) {
+        // Hitung delta time
+        float currentFrame = monotonicTime();
+        deltaTime = currentFrame - lastFrame;
+        lastFrame = currentFrame;
+        
+        // Objek scene yang sudah jadi di-upload sesuai budget frame ini
+        streamScene(uploadBudgetBytes);
+        
+        // Input
+        processInput(window);
+        
+        // Snapshot state sebelum matriks frame ini dihitung
+        if (snapshotRequested != SNAPSHOT_NONE) {
+            SnapshotAction action = snapshotRequested;
+            snapshotRequested = SNAPSHOT_NONE;
+            if (!snapshot.isAttached()) {
+                std::cout << "Snapshot: scene belum lengkap" << std::endl;
+            } else if (action == SNAPSHOT_SAVE) {
+                if (snapshot.save(snapshotPath)) {
+                    std::cout << "Snapshot disimpan: " << snapshotPath << " - " << sceneObjects.size() << " objek, "
+                              << snapshot.lastBytes << " byte (" << snapshot.lastMicros << " us)" << std::endl;
+                }
+            } else {
+                restoreSnapshot();
+            }
+        }
+        
+        // Cahaya baked mengikuti state lampu (toggle L)
+        if (lightOn != bakedStateOn) {
+            bakedStateOn = lightOn;
+            for (auto& obj : *liveObjects) obj.selectBakedState(lightOn ? 1 : 0);
+        }
+        
+        // Setup matrices
+        // Aspect mengikuti ukuran framebuffer sebenarnya (window bisa di-resize)
+        glm::mat4 projection = glm::perspective(glm::radians(fov), 
+            framebufferAspect(window), 0.1f, 100.0f);
+        glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+        
+        // Picking: kursor ditangkap (mode FPS) sehingga ray ditembakkan dari
+        // tengah layar; jika kursor bebas, pakai posisi kursor
+        if (pickRequested && pickScene) {
+            pickRequested = false;
+            int windowWidth, windowHeight;
+            glfwGetWindowSize(window, &windowWidth, &windowHeight);
+            double cursorX = windowWidth / 2.0, cursorY = windowHeight / 2.0;
+            if (glfwGetInputMode(window, GLFW_CURSOR) != GLFW_CURSOR_DISABLED)
+                glfwGetCursorPos(window, &cursorX, &cursorY);
+            Ray ray = screenPointToRay((float)cursorX, (float)cursorY,
+                                       (float)windowWidth, (float)windowHeight, projection, view);
+            PickHit hit;
+            selectedIndex = -1;
+            if (pickScene->raycast(ray, hit)) {
+                std::cout << "Objek dipilih: " << hit.object->name
+                          << " (segitiga " << hit.triangle
+                          << ", jarak " << hit.distance << " m)" << std::endl;
+                if (editor.isAttached()) {
+                    selectedIndex = (int)(hit.object - sceneObjects.data());
+                    selectedColor = hit.object->vertices[hit.triangle * 3].color;
+                }
+            } else {
+                std::cout << "Tidak ada objek di bawah kursor" << std::endl;
+            }
+        }
+        
+        // Edit objek terpilih, lalu kirim semua rentang kotor sekali per frame
+        size_t uploadedBefore = editor.uploadedBytes;
+        bool edited = false;
+        if (editRequested != EDIT_NONE) {
+            EditAction action = editRequested;
+            editRequested = EDIT_NONE;
+            if (selectedIndex >= 0) {
+                applyEdit(action);
+                edited = true;
+            }
+        }
+        editor.flush();
+        if (edited) {
+            std::cout << "  Upload edit: " << editor.uploadedBytes - uploadedBefore << " byte" << std::endl;
+        }
+        if (editor.shadowsChanged) {
+            editor.shadowsChanged = false;
+            shadowMap.invalidate();
+        }
+        
+        // =====================================================================
+        // RENDER SEMUA OBJEK DENGAN TRANSFORMASI
+        // =====================================================================
+        renderFrame(renderPath, projection, view);
+        
         // Swap buffers dan poll events
         glfwSwapBuffers(window);
         glfwPollEvents();
+        
+        if (firstFrame) {
+            firstFrame = false;
+            std::cout << "Frame pertama: " << (monotonicTime() - startupStart) * 1000.0 << " ms sejak start ("
+                      << loader.uploaded << " objek sudah di-upload)" << std::endl;
+        }
     }
     
     // Cleanup
-    floor.cleanup();
-    walls.cleanup();
-    ceiling.cleanup();
-    windowObj.cleanup();
-    door.cleanup();
-    desk.cleanup();
-    chair.cleanup();
-    monitor.cleanup();
-    keyboard.cleanup();
-    cabinet.cleanup();
-    lamp.cleanup();
-    book1.cleanup();
-    book2.cleanup();
+    for (auto& obj : sceneObjects) {
+        obj.cleanup();
+    }
     lightCube.cleanup();
     
-    glDeleteProgram(shaderProgram);
+    shadowMap.cleanup();
+    lightClusters.cleanup();
+    materials.cleanup();
+    gbuffer.cleanup();
+    postGraph.cleanup();
+    dynamicResolution.cleanup();
+    
+    forwardShaders.cleanup();
+    deferredShaders.cleanup();
     glDeleteProgram(lightShader);
+    glDeleteProgram(shadowShader);
+    glDeleteProgram(gbufferShader);
     
     glfwTerminate();
-    return 0;
+    return sceneFailed ? -1 : 0;
 }
 
 // =====================================================================
@@ -1054,6 +9274,12 @@ void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
 }
 
+float framebufferAspect(GLFWwindow* window) {
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    return height > 0 ? (float)width / (float)height : (float)SCR_WIDTH / (float)SCR_HEIGHT;
+}
+
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {
     float xpos = static_cast<float>(xposIn);
     float ypos = static_cast<float>(yposIn);
@@ -1092,11 +9318,17 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
     if (fov > 90.0f) fov = 90.0f;
 }
 
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+        pickRequested = true;
+}
+
 void processInput(GLFWwindow* window) {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
     
     float cameraSpeed = 2.5f * deltaTime;
+    glm::vec3 previousPos = cameraPos;
     
     // WASD movement
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
@@ -1114,12 +9346,18 @@ void processInput(GLFWwindow* window) {
     if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS)
         cameraPos -= cameraSpeed * cameraUp;
     
+    // Kolisi: capsule kamera meluncur di sepanjang dinding dan perabot
+    if (collisionEnabled && collisionWorld)
+        cameraPos = collisionWorld->moveCapsule(previousPos, cameraPos);
+    
     // Preset views
     static bool key1Pressed = false;
     static bool key2Pressed = false;
     static bool key3Pressed = false;
     static bool key4Pressed = false;
     static bool keyLPressed = false;
+    static bool keyCPressed = false;
+    static bool keyFPressed = false;
     
     // View 1: Front view (melihat ke arah meja dan jendela)
     if (glfwGetKey(window, GLFW_KEY_1) == GLFW_PRESS && !key1Pressed) {
@@ -1165,6 +9403,55 @@ void processInput(GLFWwindow* window) {
     }
     if (glfwGetKey(window, GLFW_KEY_L) == GLFW_RELEASE) keyLPressed = false;
     
+    // Toggle kolisi kamera
+    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS && !keyCPressed) {
+        collisionEnabled = !collisionEnabled;
+        std::cout << "Kolisi: " << (collisionEnabled ? "ON" : "OFF") << std::endl;
+        keyCPressed = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_C) == GLFW_RELEASE) keyCPressed = false;
+    
+    // Toggle kabut (berganti varian shader)
+    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS && !keyFPressed) {
+        fogEnabled = !fogEnabled;
+        std::cout << "Kabut: " << (fogEnabled ? "ON" : "OFF") << std::endl;
+        keyFPressed = true;
+    }
+    if (glfwGetKey(window, GLFW_KEY_F) == GLFW_RELEASE) keyFPressed = false;
+    
+    // Edit objek terpilih: satu aksi per tekan tombol
+    struct EditKey { int key; EditAction action; glm::vec3 offset; };
+    static const EditKey editKeys[] = {
+        {GLFW_KEY_UP, EDIT_MOVE, glm::vec3(0.0f, 0.0f, -0.1f)},
+        {GLFW_KEY_DOWN, EDIT_MOVE, glm::vec3(0.0f, 0.0f, 0.1f)},
+        {GLFW_KEY_LEFT, EDIT_MOVE, glm::vec3(-0.1f, 0.0f, 0.0f)},
+        {GLFW_KEY_RIGHT, EDIT_MOVE, glm::vec3(0.1f, 0.0f, 0.0f)},
+        {GLFW_KEY_R, EDIT_ROTATE, glm::vec3(0.0f)},
+        {GLFW_KEY_K, EDIT_RECOLOR, glm::vec3(0.0f)},
+        {GLFW_KEY_M, EDIT_REPLACE, glm::vec3(0.0f)},
+        {GLFW_KEY_N, EDIT_DUPLICATE, glm::vec3(0.0f)},
+        {GLFW_KEY_DELETE, EDIT_DELETE, glm::vec3(0.0f)},
+    };
+    static bool editKeyPressed[sizeof(editKeys) / sizeof(editKeys[0])] = {};
+    for (size_t i = 0; i < sizeof(editKeys) / sizeof(editKeys[0]); i++) {
+        bool down = glfwGetKey(window, editKeys[i].key) == GLFW_PRESS;
+        if (down && !editKeyPressed[i]) {
+            editRequested = editKeys[i].action;
+            editOffset = editKeys[i].offset;
+        }
+        editKeyPressed[i] = down;
+    }
+    
+    // Snapshot state: F5 simpan, F9 pulihkan
+    static bool keyF5Pressed = false;
+    static bool keyF9Pressed = false;
+    bool f5 = glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS;
+    bool f9 = glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS;
+    if (f5 && !keyF5Pressed) snapshotRequested = SNAPSHOT_SAVE;
+    if (f9 && !keyF9Pressed) snapshotRequested = SNAPSHOT_RESTORE;
+    keyF5Pressed = f5;
+    keyF9Pressed = f9;
+    
     // Update camera front
     glm::vec3 front;
     front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
@@ -1173,61 +9460,68 @@ void processInput(GLFWwindow* window) {
     cameraFront = glm::normalize(front);
 }
 
-std::string readShaderFile(const char* filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "ERROR: Cannot open shader file: " << filePath << std::endl;
-        return "";
+// Source shader tanpa salinan: folder override (mmap) lalu data embedded
+std::string_view readShaderFile(const char* filePath) {
+    std::string path(filePath);
+    std::string_view source;
+    if (!shaderOverrideDir.empty()) {
+        std::string relative = path.compare(0, 8, "shaders/") == 0 ? path.substr(8) : path;
+        if (mapShaderFile(shaderOverrideDir + "/" + relative, source)) return source;
+    }
+#ifdef ROOM_EMBEDDED_SHADERS
+    for (const EmbeddedShader& shader : EMBEDDED_SHADERS) {
+        if (shader.path == path) return shader.source;
     }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    std::cerr << "ERROR: Shader not embedded: " << filePath << std::endl;
+#else
+    // Build tanpa langkah embed CMake: map dari working directory
+    if (mapShaderFile(path, source)) return source;
+    std::cerr << "ERROR: Cannot open shader file: " << filePath << std::endl;
+#endif
+    return {};
 }
 
-unsigned int loadShader(const char* vertexPath, const char* fragmentPath) {
-    std::string vertexCode = readShaderFile(vertexPath);
-    std::string fragmentCode = readShaderFile(fragmentPath);
-    
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
-    
-    unsigned int vertex, fragment;
-    int success;
-    char infoLog[512];
-    
-    // Vertex shader
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        std::cerr << "ERROR: Vertex shader compilation failed\n" << infoLog << std::endl;
-    }
-    
-    // Fragment shader
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        std::cerr << "ERROR: Fragment shader compilation failed\n" << infoLog << std::endl;
-    }
-    
-    // Shader program
-    unsigned int program = glCreateProgram();
-    glAttachShader(program, vertex);
-    glAttachShader(program, fragment);
-    glLinkProgram(program);
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(program, 512, NULL, infoLog);
-        std::cerr << "ERROR: Shader program linking failed\n" << infoLog << std::endl;
+// Sisipkan baris #define tepat setelah #version (yang harus tetap baris
+// pertama). Tanpa define, source asli dikembalikan tanpa salinan.
+std::string_view injectDefines(std::string_view code, const std::string& defines, std::string& storage) {
+    if (defines.empty()) return code;
+    size_t version = code.find("#version");
+    size_t lineEnd = version == std::string_view::npos ? std::string_view::npos : code.find('\n', version);
+    if (version == std::string_view::npos) {
+        storage = defines;
+        storage.append(code);
+    } else if (lineEnd == std::string_view::npos) {
+        storage.assign(code);
+        storage += "\n" + defines;
+    } else {
+        storage.assign(code.substr(0, lineEnd + 1));
+        storage += defines;
+        storage.append(code.substr(lineEnd + 1));
     }
-    
-    glDeleteShader(vertex);
-    glDeleteShader(fragment);
-    
+    return storage;
+}
+
+unsigned int loadShader(const char* vertexPath, const char* fragmentPath,
+                        const char* geometryPath, const std::string& defines) {
+    unsigned int program = submitShader(vertexPath, fragmentPath, geometryPath, defines);
+    shaderCompiler().finish(program);
+    return program;
+}
+
+unsigned int submitShader(const char* vertexPath, const char* fragmentPath,
+                          const char* geometryPath, const std::string& defines) {
+    std::string storage[3];
+    ShaderPreprocessor& preprocessor = shaderPreprocessor();
+    std::string_view vertexCode = injectDefines(preprocessor.expand(vertexPath), defines, storage[0]);
+    std::string_view fragmentCode = injectDefines(preprocessor.expand(fragmentPath), defines, storage[1]);
+    std::string_view geometryCode;
+    if (geometryPath) geometryCode = injectDefines(preprocessor.expand(geometryPath), defines, storage[2]);
+    return shaderCompiler().submit(vertexCode, fragmentCode, geometryCode);
+}
+
+unsigned int createProgram(std::string_view vertexCode, std::string_view fragmentCode,
+                           std::string_view geometryCode) {
+    unsigned int program = shaderCompiler().submit(vertexCode, fragmentCode, geometryCode);
+    shaderCompiler().finish(program);
     return program;
 }